@@ -50,6 +50,15 @@ struct ResultOfGetBundleInfos {
     uint8_t resultCode;
     int32_t length;
     BundleInfo *bundleInfo;
+    uint32_t token;
+    uint64_t generation;
+};
+
+struct ResultOfGetBundleInfosDelta {
+    ResultOfGetBundleInfos infos;
+    bool isFullList;
+    int32_t numOfRemovedBundle;
+    char **removedBundleNames;
 };
 
 struct ResultOfGetBundleNameForUid {
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_INFO_CACHE_H
+#define OHOS_BUNDLE_INFO_CACHE_H
+
+#include <string>
+#include <unordered_map>
+
+#include "ability_info.h"
+#include "bundle_info.h"
+#include "mutex_lock.h"
+#include "nocopyable.h"
+
+namespace OHOS {
+// opt-in per-process cache of the infos returned by GetBundleInfo and QueryAbilityInfo, entries of a bundle are
+// dropped when the bms broadcasts its installation or uninstallation through BundleCallback
+class BundleInfoCache {
+public:
+    static BundleInfoCache &GetInstance()
+    {
+        static BundleInfoCache instance;
+        return instance;
+    }
+
+    ~BundleInfoCache();
+    void SetEnabled(bool enabled);
+    bool IsEnabled();
+    // on a miss the current generation is returned, a later Put with an older generation is not cached
+    bool GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo *bundleInfo, uint32_t *generation);
+    bool GetAbilityInfo(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo,
+        uint32_t *generation);
+    // both take ownership of the info, which is freed when it cannot be cached
+    void PutBundleInfo(const char *bundleName, int32_t flags, BundleInfo *bundleInfo, uint32_t generation);
+    void PutAbilityInfo(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo,
+        uint32_t generation);
+    // a nullptr bundle name drops every entry
+    void Invalidate(const char *bundleName);
+
+private:
+    static const int32_t FLAGS_NUM = 2;
+    struct CacheEntry {
+        BundleInfo *bundleInfos[FLAGS_NUM] { nullptr, nullptr };
+        std::unordered_map<std::string, AbilityInfo *> abilityInfos {};
+    };
+
+    BundleInfoCache() = default;
+    CacheEntry *GetOrCreateEntry(const char *bundleName);
+    static void FreeEntry(CacheEntry &entry);
+    void Clear();
+
+    bool enabled_ { false };
+    uint32_t generation_ { 0 };
+    std::unordered_map<std::string, CacheEntry> entries_ {};
+    Mutex mutex_ {};
+
+    DISALLOW_COPY_AND_MOVE(BundleInfoCache);
+};
+} // namespace OHOS
+#endif // OHOS_BUNDLE_INFO_CACHE_H
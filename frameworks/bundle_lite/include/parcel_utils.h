@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_PARCEL_UTILS_H
+#define OHOS_PARCEL_UTILS_H
+
+#include "bundle_info.h"
+
+namespace OHOS {
+// binary encoding of the infos exchanged between bms and its clients, both ends run on the same device so
+// numbers are kept in host byte order; the buffers returned by the marshalling functions are freed by AdapterFree
+struct ParcelUtils {
+    static uint8_t *MarshallingAbilityInfo(const AbilityInfo *abilityInfo, uint32_t *size);
+    static uint8_t *MarshallingBundleInfos(const BundleInfo *bundleInfos, uint32_t numOfBundleInfo, uint32_t *size);
+    // encodes into a caller owned buffer, such as a shared memory region, of GetBundleInfosSize bytes
+    static uint32_t GetBundleInfosSize(const BundleInfo *bundleInfos, uint32_t numOfBundleInfo);
+    static bool MarshallingBundleInfos(const BundleInfo *bundleInfos, uint32_t numOfBundleInfo, uint8_t *buff,
+        uint32_t size);
+    static AbilityInfo *UnmarshallingAbilityInfo(const uint8_t *buff, uint32_t size);
+    static BundleInfo *UnmarshallingBundleInfo(const uint8_t *buff, uint32_t size);
+    static bool UnmarshallingBundleInfos(const uint8_t *buff, uint32_t size, BundleInfo **bundleInfos,
+        uint32_t numOfBundleInfo);
+private:
+    ParcelUtils() = default;
+    ~ParcelUtils() = default;
+}; // ParcelUtils
+} // OHOS
+#endif // OHOS_PARCEL_UTILS_H
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARED_MEMORY_UTILS_H
+#define OHOS_SHARED_MEMORY_UTILS_H
+
+#include "stdint.h"
+
+namespace OHOS {
+// how the parcel of a GetBundleInfos reply follows the result code and the number of infos
+enum ParcelTransport : uint8_t {
+    PARCEL_INLINE = 0,
+    PARCEL_SHARED_MEMORY,
+};
+
+// anonymous shared memory used to hand large parcels to the client by file descriptor instead of ipc copies
+struct SharedMemoryUtils {
+    // creates a region of size bytes and maps it writable at *addr, returns the file descriptor or -1
+    static int32_t CreateRegion(uint32_t size, uint8_t **addr);
+    // drops the writable mapping and, where supported, seals the region so the client sees a fixed size
+    static bool SealRegion(int32_t fd, uint8_t *addr, uint32_t size);
+    static const uint8_t *MapRegion(int32_t fd, uint32_t size);
+    static void UnmapRegion(const uint8_t *addr, uint32_t size);
+private:
+    SharedMemoryUtils() = default;
+    ~SharedMemoryUtils() = default;
+}; // SharedMemoryUtils
+} // OHOS
+#endif // OHOS_SHARED_MEMORY_UTILS_H
@@ -17,6 +17,7 @@
 
 #include "adapter.h"
 #include "bundle_callback_utils.h"
+#include "bundle_info_cache.h"
 #include "bundle_inner_interface.h"
 #include "bundle_manager.h"
 #include "iproxy_client.h"
@@ -93,6 +94,8 @@ static int32_t Callback(uint32_t code, IpcIo* data, IpcIo* reply, MessageOption
         uint8_t resultCode = static_cast<uint8_t>(readCode);
         size_t size = 0;
         char *bundleName = reinterpret_cast<char *>(ReadString(data, &size));
+        // cached infos of the bundle are dropped before any registered callback hears of the change
+        BundleInfoCache::GetInstance().Invalidate(bundleName);
         int32_t ret = InnerCallback(code, resultCode, bundleName);
         return ret;
     }
@@ -201,8 +204,13 @@ int32_t BundleCallback::UnregisterBundleStateCallback()
     bundleStateCallback_ = nullptr;
     innerData_ = nullptr;
     callbackMap_.clear();
+    // the bundle info cache still depends on the change broadcasts
+    if (BundleInfoCache::GetInstance().IsEnabled()) {
+        return ERR_OK;
+    }
     (void) TransmitServiceId(*svcIdentity_, false);
     AdapterFree(svcIdentity_);
+    svcIdentity_ = nullptr;
     return ERR_OK;
 }
 
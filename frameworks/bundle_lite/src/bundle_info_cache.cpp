@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bundle_info_cache.h"
+
+#include "ability_info_utils.h"
+#include "adapter.h"
+#include "bundle_info_utils.h"
+
+namespace OHOS {
+namespace {
+// bounds the memory held by a long running process, bundles beyond it are simply queried every time
+const size_t MAX_CACHED_BUNDLE_NUM = 32;
+}
+
+BundleInfoCache::~BundleInfoCache()
+{
+    Clear();
+}
+
+void BundleInfoCache::SetEnabled(bool enabled)
+{
+    Lock<Mutex> lock(mutex_);
+    enabled_ = enabled;
+    if (!enabled) {
+        Clear();
+    }
+}
+
+bool BundleInfoCache::IsEnabled()
+{
+    Lock<Mutex> lock(mutex_);
+    return enabled_;
+}
+
+bool BundleInfoCache::GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo *bundleInfo,
+    uint32_t *generation)
+{
+    if (bundleName == nullptr || bundleInfo == nullptr || generation == nullptr || flags < 0 || flags >= FLAGS_NUM) {
+        return false;
+    }
+    Lock<Mutex> lock(mutex_);
+    *generation = generation_;
+    auto it = entries_.find(bundleName);
+    if (!enabled_ || it == entries_.end() || it->second.bundleInfos[flags] == nullptr) {
+        return false;
+    }
+    BundleInfoUtils::CopyBundleInfo(flags, bundleInfo, *(it->second.bundleInfos[flags]));
+    return true;
+}
+
+bool BundleInfoCache::GetAbilityInfo(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo,
+    uint32_t *generation)
+{
+    if (bundleName == nullptr || abilityName == nullptr || abilityInfo == nullptr || generation == nullptr) {
+        return false;
+    }
+    Lock<Mutex> lock(mutex_);
+    *generation = generation_;
+    auto it = entries_.find(bundleName);
+    if (!enabled_ || it == entries_.end()) {
+        return false;
+    }
+    auto abilityIt = it->second.abilityInfos.find(abilityName);
+    if (abilityIt == it->second.abilityInfos.end()) {
+        return false;
+    }
+    AbilityInfoUtils::CopyAbilityInfo(abilityInfo, *(abilityIt->second));
+    return true;
+}
+
+void BundleInfoCache::PutBundleInfo(const char *bundleName, int32_t flags, BundleInfo *bundleInfo,
+    uint32_t generation)
+{
+    if (bundleInfo == nullptr) {
+        return;
+    }
+    if (bundleName != nullptr && flags >= 0 && flags < FLAGS_NUM) {
+        Lock<Mutex> lock(mutex_);
+        // an install or uninstall seen since the query started may have made the info stale already
+        CacheEntry *entry = (enabled_ && generation == generation_) ? GetOrCreateEntry(bundleName) : nullptr;
+        if (entry != nullptr && entry->bundleInfos[flags] == nullptr) {
+            entry->bundleInfos[flags] = bundleInfo;
+            return;
+        }
+    }
+    BundleInfoUtils::FreeBundleInfo(bundleInfo);
+}
+
+void BundleInfoCache::PutAbilityInfo(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo,
+    uint32_t generation)
+{
+    if (abilityInfo == nullptr) {
+        return;
+    }
+    if (bundleName != nullptr && abilityName != nullptr) {
+        Lock<Mutex> lock(mutex_);
+        CacheEntry *entry = (enabled_ && generation == generation_) ? GetOrCreateEntry(bundleName) : nullptr;
+        if (entry != nullptr && entry->abilityInfos.find(abilityName) == entry->abilityInfos.end()) {
+            entry->abilityInfos.emplace(abilityName, abilityInfo);
+            return;
+        }
+    }
+    ClearAbilityInfo(abilityInfo);
+    AdapterFree(abilityInfo);
+}
+
+void BundleInfoCache::Invalidate(const char *bundleName)
+{
+    Lock<Mutex> lock(mutex_);
+    generation_++;
+    if (bundleName == nullptr) {
+        Clear();
+        return;
+    }
+    auto it = entries_.find(bundleName);
+    if (it != entries_.end()) {
+        FreeEntry(it->second);
+        entries_.erase(it);
+    }
+}
+
+BundleInfoCache::CacheEntry *BundleInfoCache::GetOrCreateEntry(const char *bundleName)
+{
+    auto it = entries_.find(bundleName);
+    if (it != entries_.end()) {
+        return &(it->second);
+    }
+    if (entries_.size() >= MAX_CACHED_BUNDLE_NUM) {
+        return nullptr;
+    }
+    return &(entries_[bundleName]);
+}
+
+void BundleInfoCache::FreeEntry(CacheEntry &entry)
+{
+    for (int32_t i = 0; i < FLAGS_NUM; i++) {
+        if (entry.bundleInfos[i] != nullptr) {
+            BundleInfoUtils::FreeBundleInfo(entry.bundleInfos[i]);
+            entry.bundleInfos[i] = nullptr;
+        }
+    }
+    for (auto &abilityInfo : entry.abilityInfos) {
+        ClearAbilityInfo(abilityInfo.second);
+        AdapterFree(abilityInfo.second);
+    }
+    entry.abilityInfos.clear();
+}
+
+void BundleInfoCache::Clear()
+{
+    for (auto &entry : entries_) {
+        FreeEntry(entry.second);
+    }
+    entries_.clear();
+}
+} // namespace OHOS
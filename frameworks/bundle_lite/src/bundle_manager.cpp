@@ -14,21 +14,26 @@
  */
 #include "bundle_manager.h"
 
+#include <unistd.h>
+
 #include "ability_info_utils.h"
 #include "adapter.h"
 #include "bundle_callback.h"
 #include "bundle_callback_utils.h"
+#include "bundle_info_cache.h"
 #include "bundle_info_utils.h"
 #include "bundle_inner_interface.h"
 #include "bundle_self_callback.h"
-#include "convert_utils.h"
 #include "iproxy_client.h"
 #include "ipc_skeleton.h"
 #include "bundle_log.h"
 #include "ohos_types.h"
+#include "parcel_utils.h"
 #include "pms_interface.h"
 #include "samgr_lite.h"
 #include "securec.h"
+#include "shared_memory_utils.h"
+#include "utils.h"
 #include "want_utils.h"
 
 extern "C" {
@@ -62,6 +67,14 @@ int32_t UnregisterCallback()
     return OHOS::BundleCallback::GetInstance().UnregisterBundleStateCallback();
 }
 
+static const uint8_t *ReadParcel(IpcIo *reply, uint32_t *size)
+{
+    if (!ReadUint32(reply, size) || *size == 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<const uint8_t *>(ReadBuffer(reply, *size));
+}
+
 static uint8_t DeserializeInnerAbilityInfo(IOwner owner, IpcIo *reply)
 {
     if ((reply == nullptr) || (owner == nullptr)) {
@@ -74,14 +87,14 @@ static uint8_t DeserializeInnerAbilityInfo(IOwner owner, IpcIo *reply)
         info->resultCode = resultCode;
         return resultCode;
     }
-    size_t len = 0;
-    char *jsonStr = reinterpret_cast<char *>(ReadString(reply, &len));
-    if (jsonStr == nullptr) {
+    uint32_t size = 0;
+    const uint8_t *buff = ReadParcel(reply, &size);
+    if (buff == nullptr) {
         info->resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
         HILOG_ERROR(HILOG_MODULE_APP, "AbilityInfo DeserializeAbilityInfo buff is empty!");
         return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
     }
-    info->abilityInfo = OHOS::ConvertUtils::ConvertStringToAbilityInfo(jsonStr, len);
+    info->abilityInfo = OHOS::ParcelUtils::UnmarshallingAbilityInfo(buff, size);
     if (info->abilityInfo == nullptr) {
         info->resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
         return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
@@ -103,17 +116,17 @@ static uint8_t DeserializeInnerBundleInfo(IOwner owner, IpcIo *reply)
         info->resultCode = resultCode;
         return resultCode;
     }
-    size_t len = 0;
-    char *jsonStr = reinterpret_cast<char *>(ReadString(reply, &len));
-    if (jsonStr == nullptr) {
+    uint32_t size = 0;
+    const uint8_t *buff = ReadParcel(reply, &size);
+    if (buff == nullptr) {
         info->resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
         HILOG_ERROR(HILOG_MODULE_APP, "BundleInfo DeserializeBundleInfo buff is empty!");
         return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
     }
-    info->bundleInfo = OHOS::ConvertUtils::ConvertStringToBundleInfo(jsonStr, len);
+    info->bundleInfo = OHOS::ParcelUtils::UnmarshallingBundleInfo(buff, size);
     if (info->bundleInfo == nullptr) {
         info->resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
-        HILOG_ERROR(HILOG_MODULE_APP, "ConvertStringToBundleInfo failed");
+        HILOG_ERROR(HILOG_MODULE_APP, "UnmarshallingBundleInfo failed");
         return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
     }
     info->resultCode = resultCode;
@@ -121,7 +134,34 @@ static uint8_t DeserializeInnerBundleInfo(IOwner owner, IpcIo *reply)
     return resultCode;
 }
 
-static uint8_t DeserializeInnerBundleInfos(IOwner owner, IpcIo *reply)
+// large lists arrive as a shared memory descriptor, the infos are decoded from a read-only mapping of it
+static uint8_t DeserializeSharedBundleInfos(ResultOfGetBundleInfos *info, IpcIo *reply)
+{
+#ifdef __LINUX__
+    uint32_t size = 0;
+    if (!ReadUint32(reply, &size) || info->length <= 0) {
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    int32_t fd = ReadFileDescriptor(reply);
+    if (fd < 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleInfo DeserializeBundleInfos read shared memory descriptor failed");
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    const uint8_t *buff = OHOS::SharedMemoryUtils::MapRegion(fd, size);
+    close(fd);
+    if (buff == nullptr) {
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    bool isUnmarshalled = OHOS::ParcelUtils::UnmarshallingBundleInfos(buff, size, &(info->bundleInfo),
+        static_cast<uint32_t>(info->length));
+    OHOS::SharedMemoryUtils::UnmapRegion(buff, size);
+    return isUnmarshalled ? ERR_OK : ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+#else
+    return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+#endif
+}
+
+static uint8_t DeserializeInnerBundleInfos(IOwner owner, IpcIo *reply, bool hasGeneration)
 {
     HILOG_DEBUG(HILOG_MODULE_APP, "DeserializeInnerBundleInfos start");
     if ((reply == nullptr) || (owner == nullptr)) {
@@ -135,15 +175,31 @@ static uint8_t DeserializeInnerBundleInfos(IOwner owner, IpcIo *reply)
         return resultCode;
     }
 
+    if (hasGeneration) {
+        ReadUint64(reply, &(info->generation));
+    }
     ReadInt32(reply, &(info->length));
-    size_t len = 0;
-    char *jsonStr = reinterpret_cast<char*>(ReadString(reply, &len));
-    if (jsonStr == nullptr) {
+    // no infos follow the generation when nothing has changed or when the list has to be paged
+    if (hasGeneration && info->length <= 0) {
+        info->resultCode = resultCode;
+        return resultCode;
+    }
+    uint8_t transport = OHOS::PARCEL_INLINE;
+    ReadUint8(reply, &transport);
+    if (transport == OHOS::PARCEL_SHARED_MEMORY) {
+        resultCode = DeserializeSharedBundleInfos(info, reply);
+        info->resultCode = resultCode;
+        return resultCode;
+    }
+    uint32_t size = 0;
+    const uint8_t *buff = ReadParcel(reply, &size);
+    if (buff == nullptr || info->length <= 0) {
         info->resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
         HILOG_ERROR(HILOG_MODULE_APP, "BundleInfo DeserializeBundleInfos buff is empty!");
         return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
     }
-    if (!OHOS::ConvertUtils::ConvertStringToBundleInfos(jsonStr, &(info->bundleInfo), info->length, len)) {
+    if (!OHOS::ParcelUtils::UnmarshallingBundleInfos(buff, size, &(info->bundleInfo),
+        static_cast<uint32_t>(info->length))) {
         info->resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
         return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
     }
@@ -153,6 +209,43 @@ static uint8_t DeserializeInnerBundleInfos(IOwner owner, IpcIo *reply)
     return resultCode;
 }
 
+// the names of removed bundles follow the changed infos
+static uint8_t DeserializeBundleInfosDelta(IOwner owner, IpcIo *reply)
+{
+    if ((reply == nullptr) || (owner == nullptr)) {
+        return OHOS_FAILURE;
+    }
+    ResultOfGetBundleInfosDelta *delta = reinterpret_cast<ResultOfGetBundleInfosDelta *>(owner);
+    uint8_t resultCode = DeserializeInnerBundleInfos(&(delta->infos), reply, true);
+    if (resultCode != ERR_OK) {
+        return resultCode;
+    }
+    int32_t numOfRemovedBundle = 0;
+    if (!ReadBool(reply, &(delta->isFullList)) || !ReadInt32(reply, &numOfRemovedBundle) ||
+        numOfRemovedBundle < 0) {
+        delta->infos.resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    if (numOfRemovedBundle == 0) {
+        return ERR_OK;
+    }
+    delta->removedBundleNames = reinterpret_cast<char **>(AdapterMalloc(sizeof(char *) * numOfRemovedBundle));
+    if (delta->removedBundleNames == nullptr) {
+        delta->infos.resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    for (; delta->numOfRemovedBundle < numOfRemovedBundle; ++(delta->numOfRemovedBundle)) {
+        size_t length = 0;
+        char *bundleName = reinterpret_cast<char *>(ReadString(reply, &length));
+        delta->removedBundleNames[delta->numOfRemovedBundle] = OHOS::Utils::Strdup(bundleName);
+        if (delta->removedBundleNames[delta->numOfRemovedBundle] == nullptr) {
+            delta->infos.resultCode = ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+            return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+        }
+    }
+    return ERR_OK;
+}
+
 static uint8_t DeserializeInnerBundleName(IOwner owner, IpcIo *reply)
 {
     if ((reply == nullptr) || (owner == nullptr)) {
@@ -264,7 +357,8 @@ static int Notify(IOwner owner, int code, IpcIo *reply)
     ReadUint8(reply, &resultCode);
     switch (resultCode) {
         case INSTALL:
-        case UNINSTALL: {
+        case UNINSTALL:
+        case INSTALL_BATCH: {
             uint8_t *ret = reinterpret_cast<uint8_t *>(owner);
             ReadUint8(reply, ret);
             HILOG_INFO(HILOG_MODULE_APP, "BundleManager install or uninstall invoke return: %{public}d", *ret);
@@ -279,7 +373,13 @@ static int Notify(IOwner owner, int code, IpcIo *reply)
         case GET_BUNDLE_INFOS:
         case QUERY_KEEPALIVE_BUNDLE_INFOS:
         case GET_BUNDLE_INFOS_BY_METADATA: {
-            return DeserializeInnerBundleInfos(owner, reply);
+            return DeserializeInnerBundleInfos(owner, reply, false);
+        }
+        case GET_BUNDLE_INFOS_IF_MODIFIED: {
+            return DeserializeInnerBundleInfos(owner, reply, true);
+        }
+        case GET_BUNDLE_INFOS_CHANGED_SINCE: {
+            return DeserializeBundleInfosDelta(owner, reply);
         }
         case GET_BUNDLE_INFO_LENGTH: {
             ResultOfGetBundleInfos *resultOfGetBundleInfos = reinterpret_cast<ResultOfGetBundleInfos *>(owner);
@@ -291,6 +391,7 @@ static int Notify(IOwner owner, int code, IpcIo *reply)
                 return errCode;
             }
             ReadInt32(reply, &(resultOfGetBundleInfos->length));
+            ReadUint32(reply, &(resultOfGetBundleInfos->token));
             HILOG_INFO(HILOG_MODULE_APP, "BundleManager bundleInfo len is: %{public}d", resultOfGetBundleInfos->length);
             break;
         }
@@ -399,6 +500,55 @@ bool Install(const char *hapPath, const InstallParam *installParam, InstallerCal
     return result == OHOS_SUCCESS;
 }
 
+bool InstallBatch(const char * const *hapPaths, uint32_t numOfHap, const InstallParam *installParam,
+    InstallerCallback installerCallback)
+{
+    if ((hapPaths == nullptr) || (installerCallback == nullptr) || (installParam == nullptr) || (numOfHap == 0) ||
+        (numOfHap > MAX_BATCH_INSTALL_NUM)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager batch install failed due to nullptr or invalid parameters");
+        return false;
+    }
+    if (CheckSelfPermission(static_cast<const char *>(PERMISSION_INSTALL_BUNDLE)) != GRANTED) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager batch install failed due to permission denied");
+        return false;
+    }
+    auto bmsInnerClient = GetBmsInnerClient();
+    if (bmsInnerClient == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager batch install failed due to nullptr bms client");
+        return false;
+    }
+
+    IpcIo ipcIo;
+    char data[MAX_IO_SIZE];
+    IpcIoInit(&ipcIo, data, MAX_IO_SIZE, OBJECT_NUMBER_IN_INSTALLATION);
+    WriteUint32(&ipcIo, numOfHap);
+    for (uint32_t i = 0; i < numOfHap; i++) {
+        if ((hapPaths[i] == nullptr) || !WriteString(&ipcIo, hapPaths[i])) {
+            HILOG_ERROR(HILOG_MODULE_APP, "BundleManager InstallBatch write hap path failed");
+            return false;
+        }
+    }
+    const SvcIdentity *svc = OHOS::BundleSelfCallback::GetInstance().RegisterBundleSelfCallback(installerCallback);
+    if (svc == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager InstallBatch svc is nullptr");
+        return false;
+    }
+    bool writeRemote = WriteRemoteObject(&ipcIo, svc);
+    if (!writeRemote) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager InstallBatch ipc failed");
+        return false;
+    }
+    WriteInt32(&ipcIo, installParam->installLocation);
+    HILOG_DEBUG(HILOG_MODULE_APP, "BMS client invoke batch install");
+    uint8_t result = 0;
+    int32_t ret = bmsInnerClient->Invoke(bmsInnerClient, INSTALL_BATCH, &ipcIo, &result, Notify);
+    if (ret != OHOS_SUCCESS) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager InstallBatch invoke failed: %{public}d", ret);
+        return false;
+    }
+    return result == OHOS_SUCCESS;
+}
+
 bool Uninstall(const char *bundleName, const InstallParam *installParam, InstallerCallback installerCallback)
 {
     // installParam is nullptr at present.
@@ -447,6 +597,12 @@ uint8_t QueryAbilityInfo(const Want *want, AbilityInfo *abilityInfo)
     if ((want == nullptr) || (abilityInfo == nullptr)) {
         return ERR_APPEXECFWK_OBJECT_NULL;
     }
+    const char *bundleName = (want->element == nullptr) ? nullptr : want->element->bundleName;
+    const char *abilityName = (want->element == nullptr) ? nullptr : want->element->abilityName;
+    uint32_t generation = 0;
+    if (OHOS::BundleInfoCache::GetInstance().GetAbilityInfo(bundleName, abilityName, abilityInfo, &generation)) {
+        return ERR_OK;
+    }
     if (CheckSelfPermission(static_cast<const char *>(PERMISSION_GET_BUNDLE_INFO)) != GRANTED) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleManager query AbilityInfo failed due to permission denied");
         return ERR_APPEXECFWK_PERMISSION_DENIED;
@@ -478,8 +634,8 @@ uint8_t QueryAbilityInfo(const Want *want, AbilityInfo *abilityInfo)
     }
     if (resultOfQueryAbilityInfo.resultCode == ERR_OK) {
         OHOS::AbilityInfoUtils::CopyAbilityInfo(abilityInfo, *(resultOfQueryAbilityInfo.abilityInfo));
-        ClearAbilityInfo(resultOfQueryAbilityInfo.abilityInfo);
-        AdapterFree(resultOfQueryAbilityInfo.abilityInfo);
+        OHOS::BundleInfoCache::GetInstance().PutAbilityInfo(bundleName, abilityName,
+            resultOfQueryAbilityInfo.abilityInfo, generation);
     }
 
     return resultOfQueryAbilityInfo.resultCode;
@@ -493,6 +649,10 @@ uint8_t GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo *bundleI
     if (flags < 0 || flags > 1 || (strlen(bundleName) >= MAX_BUNDLE_NAME)) {
         return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
     }
+    uint32_t generation = 0;
+    if (OHOS::BundleInfoCache::GetInstance().GetBundleInfo(bundleName, flags, bundleInfo, &generation)) {
+        return ERR_OK;
+    }
     if (CheckSelfPermission(static_cast<const char *>(PERMISSION_GET_BUNDLE_INFO)) != GRANTED) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleManager get BundleInfo failed due to permission denied");
         return ERR_APPEXECFWK_PERMISSION_DENIED;
@@ -522,8 +682,8 @@ uint8_t GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo *bundleI
     }
     if (resultOfGetBundleInfo.resultCode == ERR_OK) {
         OHOS::BundleInfoUtils::CopyBundleInfo(flags, bundleInfo, *(resultOfGetBundleInfo.bundleInfo));
-        ClearBundleInfo(resultOfGetBundleInfo.bundleInfo);
-        AdapterFree(resultOfGetBundleInfo.bundleInfo);
+        OHOS::BundleInfoCache::GetInstance().PutBundleInfo(bundleName, flags, resultOfGetBundleInfo.bundleInfo,
+            generation);
     }
     return resultOfGetBundleInfo.resultCode;
 }
@@ -578,14 +738,14 @@ static uint8_t ObtainInnerBundleInfos(const int flags, BundleInfo **bundleInfos,
     return resultOfGetBundleInfos.resultCode;
 }
 
-static uint8_t ObtainBundleInfosOneByOne(BasicInfo basicInfo, int32_t len, uint8_t code, IClientProxy *bmsClient,
-    BundleInfo **bundleInfos)
+static uint8_t ObtainBundleInfosOneByOne(BasicInfo basicInfo, const ResultOfGetBundleInfos &snapshot, uint8_t code,
+    IClientProxy *bmsClient, BundleInfo **bundleInfos)
 {
     if (bmsClient == nullptr || bundleInfos == nullptr) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleManager ObtainBundleInfosOneByOne failed due to nullptr parma");
         return ERR_APPEXECFWK_OBJECT_NULL;
     }
-    for (int32_t i = 0; i < len; ++i) {
+    for (int32_t i = 0; i < snapshot.length; ++i) {
         IpcIo innerIpcIo;
         char data[MAX_IO_SIZE];
         IpcIoInit(&innerIpcIo, data, MAX_IO_SIZE, 0);
@@ -597,6 +757,8 @@ static uint8_t ObtainBundleInfosOneByOne(BasicInfo basicInfo, int32_t len, uint8
             WriteString(&innerIpcIo, basicInfo.metaDataKey);
         }
         WriteInt32(&innerIpcIo, i);
+        // pages are serialized from the snapshot opened by GET_BUNDLE_INFO_LENGTH
+        WriteUint32(&innerIpcIo, snapshot.token);
         ResultOfGetBundleInfo resultOfGetBundleInfo;
         resultOfGetBundleInfo.bundleInfo = nullptr;
         int32_t ret = bmsClient->Invoke(bmsClient, GET_BUNDLE_INFO_BY_INDEX, &innerIpcIo,
@@ -636,6 +798,7 @@ static uint8_t ObtainBundleInfos(BasicInfo basicInfo, BundleInfo **bundleInfos,
     ResultOfGetBundleInfos resultOfGetBundleInfos;
     resultOfGetBundleInfos.length = 0;
     resultOfGetBundleInfos.bundleInfo = nullptr;
+    resultOfGetBundleInfos.token = 0;
     int32_t ret = bmsClient->Invoke(bmsClient, GET_BUNDLE_INFO_LENGTH, ipcIo, &resultOfGetBundleInfos, Notify);
     if (ret != OHOS_SUCCESS) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleManager ObtainBundleInfos invoke failed: %{public}d\n", ret);
@@ -660,7 +823,7 @@ static uint8_t ObtainBundleInfos(BasicInfo basicInfo, BundleInfo **bundleInfos,
         return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
     }
 
-    uint8_t res = ObtainBundleInfosOneByOne(basicInfo, resultOfGetBundleInfos.length, code, bmsClient, bundleInfos);
+    uint8_t res = ObtainBundleInfosOneByOne(basicInfo, resultOfGetBundleInfos, code, bmsClient, bundleInfos);
     if (res != OHOS_SUCCESS) {
         HILOG_WARN(HILOG_MODULE_APP, "BundleManager ObtainBundleInfos invoke failed: %{public}d\n", res);
     }
@@ -898,4 +1061,145 @@ void FreeSystemAvailableCapabilitiesInfo(SystemCapability *sysCap)
     }
     AdapterFree(sysCap);
 }
+
+uint8_t EnableBundleInfoCache(bool enable)
+{
+    if (!enable) {
+        OHOS::BundleInfoCache::GetInstance().SetEnabled(false);
+        return ERR_OK;
+    }
+    if (CheckSelfPermission(static_cast<const char *>(PERMISSION_GET_BUNDLE_INFO)) != GRANTED) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager enable cache failed due to permission denied");
+        return ERR_APPEXECFWK_PERMISSION_DENIED;
+    }
+    // cached infos are only trusted while the install and uninstall broadcasts reach this process
+    if (OHOS::BundleCallback::GetInstance().GenerateLocalServiceId() != ERR_OK) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager enable cache failed due to callback unavailable");
+        return ERR_APPEXECFWK_CALLBACK_GENERATE_LOCAL_SERVICEID_FAILED;
+    }
+    OHOS::BundleInfoCache::GetInstance().SetEnabled(true);
+    return ERR_OK;
+}
+
+uint8_t GetBundleInfosIfModified(const int flags, uint64_t *generation, BundleInfo **bundleInfos, int32_t *len)
+{
+    if ((generation == nullptr) || (bundleInfos == nullptr) || (len == nullptr)) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    if (flags < 0 || flags > 1) {
+        return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
+    }
+    if (CheckSelfPermission(static_cast<const char *>(PERMISSION_GET_BUNDLE_INFO)) != GRANTED) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager get modified BundleInfos failed due to permission denied");
+        return ERR_APPEXECFWK_PERMISSION_DENIED;
+    }
+    auto bmsClient = GetBmsClient();
+    if (bmsClient == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager get modified BundleInfos failed due to nullptr bms client");
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+
+    IpcIo ipcIo;
+    char data[MAX_IO_SIZE];
+    IpcIoInit(&ipcIo, data, MAX_IO_SIZE, 0);
+    WriteInt32(&ipcIo, flags);
+    WriteUint64(&ipcIo, *generation);
+    ResultOfGetBundleInfos resultOfGetBundleInfos;
+    resultOfGetBundleInfos.length = 0;
+    resultOfGetBundleInfos.bundleInfo = nullptr;
+    resultOfGetBundleInfos.generation = *generation;
+    int32_t ret = bmsClient->Invoke(bmsClient, GET_BUNDLE_INFOS_IF_MODIFIED, &ipcIo, &resultOfGetBundleInfos, Notify);
+    if (ret != OHOS_SUCCESS) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager GetBundleInfosIfModified invoke failed: %{public}d", ret);
+        return ERR_APPEXECFWK_INVOKE_ERROR;
+    }
+    if (resultOfGetBundleInfos.resultCode != ERR_OK) {
+        return resultOfGetBundleInfos.resultCode;
+    }
+    *bundleInfos = nullptr;
+    *len = 0;
+    if (resultOfGetBundleInfos.length < 0) {
+        uint8_t errorCode = GetBundleInfos(flags, bundleInfos, len);
+        if (errorCode != ERR_OK) {
+            return errorCode;
+        }
+    } else if (resultOfGetBundleInfos.length > 0) {
+        // the server has applied the flags already, so the decoded infos are handed over without another copy
+        *bundleInfos = resultOfGetBundleInfos.bundleInfo;
+        *len = resultOfGetBundleInfos.length;
+    }
+    *generation = resultOfGetBundleInfos.generation;
+    return ERR_OK;
+}
+
+uint8_t GetBundleInfosChangedSince(const int flags, uint64_t generation, BundleInfosDelta *delta)
+{
+    if (delta == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    if (flags < 0 || flags > 1) {
+        return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
+    }
+    if (CheckSelfPermission(static_cast<const char *>(PERMISSION_GET_BUNDLE_INFO)) != GRANTED) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager get changed BundleInfos failed due to permission denied");
+        return ERR_APPEXECFWK_PERMISSION_DENIED;
+    }
+    auto bmsClient = GetBmsClient();
+    if (bmsClient == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager get changed BundleInfos failed due to nullptr bms client");
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+
+    IpcIo ipcIo;
+    char data[MAX_IO_SIZE];
+    IpcIoInit(&ipcIo, data, MAX_IO_SIZE, 0);
+    WriteInt32(&ipcIo, flags);
+    WriteUint64(&ipcIo, generation);
+    ResultOfGetBundleInfosDelta result = {};
+    result.infos.generation = generation;
+    int32_t ret = bmsClient->Invoke(bmsClient, GET_BUNDLE_INFOS_CHANGED_SINCE, &ipcIo, &result, Notify);
+    BundleInfosDelta changes = {};
+    changes.generation = result.infos.generation;
+    changes.bundleInfos = result.infos.bundleInfo;
+    changes.numOfBundleInfo = (result.infos.length > 0) ? result.infos.length : 0;
+    changes.removedBundleNames = result.removedBundleNames;
+    changes.numOfRemovedBundle = result.numOfRemovedBundle;
+    changes.isFullList = result.isFullList;
+    if (ret != OHOS_SUCCESS) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleManager GetBundleInfosChangedSince invoke failed: %{public}d", ret);
+        FreeBundleInfosDelta(&changes);
+        return ERR_APPEXECFWK_INVOKE_ERROR;
+    }
+    if (result.infos.resultCode != ERR_OK) {
+        FreeBundleInfosDelta(&changes);
+        return result.infos.resultCode;
+    }
+    if (result.infos.length < 0) {
+        // the full list did not fit into the reply, it is paged the same way as GetBundleInfos
+        uint8_t errorCode = GetBundleInfos(flags, &(changes.bundleInfos), &(changes.numOfBundleInfo));
+        if (errorCode != ERR_OK) {
+            FreeBundleInfosDelta(&changes);
+            return errorCode;
+        }
+    }
+    *delta = changes;
+    return ERR_OK;
+}
+
+void FreeBundleInfosDelta(BundleInfosDelta *delta)
+{
+    if (delta == nullptr) {
+        return;
+    }
+    OHOS::BundleInfoUtils::FreeBundleInfos(delta->bundleInfos, delta->numOfBundleInfo);
+    delta->bundleInfos = nullptr;
+    delta->numOfBundleInfo = 0;
+    if (delta->removedBundleNames != nullptr) {
+        for (int32_t i = 0; i < delta->numOfRemovedBundle; ++i) {
+            AdapterFree(delta->removedBundleNames[i]);
+        }
+        AdapterFree(delta->removedBundleNames);
+    }
+    delta->numOfRemovedBundle = 0;
+}
 }
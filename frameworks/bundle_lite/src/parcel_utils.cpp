@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parcel_utils.h"
+
+#include "bundle_info_utils.h"
+#include "bundle_log.h"
+#include "securec.h"
+#include "utils.h"
+
+namespace OHOS {
+namespace {
+// "BMSP", followed by the version and the number of infos in the buffer
+const uint32_t PARCEL_MAGIC = 0x504D5342;
+const uint32_t PARCEL_VERSION = 1;
+// length written in place of a nullptr string
+const uint32_t NULL_STRING_LENGTH = 0xFFFFFFFF;
+
+// the writer runs twice over the infos, first with a nullptr buffer to compute the size and then to fill it,
+// so the infos are encoded with a single allocation; bytes beyond the capacity are counted but never written
+class ParcelWriter {
+public:
+    ParcelWriter(uint8_t *buff, uint32_t capacity) : buff_(buff), capacity_(capacity), offset_(0) {}
+
+    uint32_t GetOffset() const
+    {
+        return offset_;
+    }
+
+    void WriteRaw(const void *data, uint32_t size)
+    {
+        if (buff_ != nullptr && size != 0 && offset_ <= capacity_ && size <= capacity_ - offset_) {
+            (void) memcpy_s(buff_ + offset_, capacity_ - offset_, data, size);
+        }
+        offset_ += size;
+    }
+
+    void WriteUint32(uint32_t value)
+    {
+        WriteRaw(&value, sizeof(value));
+    }
+
+    void WriteInt32(int32_t value)
+    {
+        WriteRaw(&value, sizeof(value));
+    }
+
+    void WriteBool(bool value)
+    {
+        uint8_t byte = value ? 1 : 0;
+        WriteRaw(&byte, sizeof(byte));
+    }
+
+    void WriteString(const char *str)
+    {
+        if (str == nullptr) {
+            WriteUint32(NULL_STRING_LENGTH);
+            return;
+        }
+        uint32_t len = static_cast<uint32_t>(strlen(str));
+        WriteUint32(len);
+        WriteRaw(str, len);
+    }
+
+private:
+    uint8_t *buff_;
+    uint32_t capacity_;
+    uint32_t offset_;
+};
+
+class ParcelReader {
+public:
+    ParcelReader(const uint8_t *buff, uint32_t size) : buff_(buff), size_(size), offset_(0) {}
+
+    bool ReadRaw(void *data, uint32_t size)
+    {
+        if (size > size_ - offset_) {
+            return false;
+        }
+        if (memcpy_s(data, size, buff_ + offset_, size) != EOK) {
+            return false;
+        }
+        offset_ += size;
+        return true;
+    }
+
+    bool ReadUint32(uint32_t &value)
+    {
+        return ReadRaw(&value, sizeof(value));
+    }
+
+    bool ReadInt32(int32_t &value)
+    {
+        return ReadRaw(&value, sizeof(value));
+    }
+
+    bool ReadBool(bool &value)
+    {
+        uint8_t byte = 0;
+        if (!ReadRaw(&byte, sizeof(byte))) {
+            return false;
+        }
+        value = (byte != 0);
+        return true;
+    }
+
+    // the string is copied out of the buffer so that the infos can be freed the same way as the ones from json
+    bool ReadString(char *&str)
+    {
+        uint32_t len = 0;
+        if (!ReadUint32(len)) {
+            return false;
+        }
+        if (len == NULL_STRING_LENGTH) {
+            str = nullptr;
+            return true;
+        }
+        if (len > MAX_STR_SIZE || len > size_ - offset_) {
+            return false;
+        }
+        str = reinterpret_cast<char *>(AdapterMalloc(len + 1));
+        if (str == nullptr) {
+            return false;
+        }
+        if (len != 0 && memcpy_s(str, len, buff_ + offset_, len) != EOK) {
+            AdapterFree(str);
+            return false;
+        }
+        str[len] = '\0';
+        offset_ += len;
+        return true;
+    }
+
+    // every encoded item takes at least one byte, which bounds the counts read from the buffer
+    uint32_t GetRemainingSize() const
+    {
+        return size_ - offset_;
+    }
+
+    bool AtEnd() const
+    {
+        return offset_ == size_;
+    }
+
+private:
+    const uint8_t *buff_;
+    uint32_t size_;
+    uint32_t offset_;
+};
+
+void WriteHeader(ParcelWriter &writer, uint32_t count)
+{
+    writer.WriteUint32(PARCEL_MAGIC);
+    writer.WriteUint32(PARCEL_VERSION);
+    writer.WriteUint32(count);
+}
+
+bool ReadHeader(ParcelReader &reader, uint32_t expectedCount)
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t count = 0;
+    if (!reader.ReadUint32(magic) || !reader.ReadUint32(version) || !reader.ReadUint32(count)) {
+        return false;
+    }
+    if (magic != PARCEL_MAGIC || version != PARCEL_VERSION || count != expectedCount) {
+        HILOG_ERROR(HILOG_MODULE_APP, "parcel header mismatch, version is %{public}u, count is %{public}u",
+            version, count);
+        return false;
+    }
+    return true;
+}
+
+// the fields carried here are the ones the json format has carried
+void WriteAbilityInfo(ParcelWriter &writer, const AbilityInfo &abilityInfo)
+{
+    writer.WriteBool(abilityInfo.isVisible);
+    writer.WriteInt32(static_cast<int32_t>(abilityInfo.abilityType));
+    writer.WriteInt32(static_cast<int32_t>(abilityInfo.launchMode));
+    writer.WriteString(abilityInfo.bundleName);
+    writer.WriteString(abilityInfo.moduleName);
+    writer.WriteString(abilityInfo.name);
+    writer.WriteString(abilityInfo.description);
+    writer.WriteString(abilityInfo.iconPath);
+    writer.WriteString(abilityInfo.label);
+    writer.WriteString(abilityInfo.deviceId);
+}
+
+bool ReadAbilityInfo(ParcelReader &reader, AbilityInfo &abilityInfo)
+{
+    int32_t abilityType = 0;
+    int32_t launchMode = 0;
+    if (!reader.ReadBool(abilityInfo.isVisible) || !reader.ReadInt32(abilityType) ||
+        !reader.ReadInt32(launchMode)) {
+        return false;
+    }
+    abilityInfo.abilityType = AbilityType(abilityType);
+    abilityInfo.launchMode = LaunchMode(launchMode);
+    return reader.ReadString(abilityInfo.bundleName) && reader.ReadString(abilityInfo.moduleName) &&
+        reader.ReadString(abilityInfo.name) && reader.ReadString(abilityInfo.description) &&
+        reader.ReadString(abilityInfo.iconPath) && reader.ReadString(abilityInfo.label) &&
+        reader.ReadString(abilityInfo.deviceId);
+}
+
+void WriteModuleInfo(ParcelWriter &writer, const ModuleInfo &moduleInfo)
+{
+    writer.WriteString(moduleInfo.moduleName);
+    writer.WriteString(moduleInfo.name);
+    writer.WriteString(moduleInfo.description);
+    writer.WriteString(moduleInfo.moduleType);
+    writer.WriteBool(moduleInfo.isDeliveryInstall);
+    uint32_t numOfDeviceType = 0;
+    while (numOfDeviceType < DEVICE_TYPE_SIZE && moduleInfo.deviceType[numOfDeviceType] != nullptr) {
+        numOfDeviceType++;
+    }
+    writer.WriteUint32(numOfDeviceType);
+    for (uint32_t i = 0; i < numOfDeviceType; i++) {
+        writer.WriteString(moduleInfo.deviceType[i]);
+    }
+    uint32_t numOfMetaData = 0;
+    while (numOfMetaData < METADATA_SIZE && moduleInfo.metaData[numOfMetaData] != nullptr) {
+        numOfMetaData++;
+    }
+    writer.WriteUint32(numOfMetaData);
+    for (uint32_t i = 0; i < numOfMetaData; i++) {
+        writer.WriteString(moduleInfo.metaData[i]->name);
+        writer.WriteString(moduleInfo.metaData[i]->value);
+        writer.WriteString(moduleInfo.metaData[i]->extra);
+    }
+}
+
+bool ReadModuleInfo(ParcelReader &reader, ModuleInfo &moduleInfo)
+{
+    if (!reader.ReadString(moduleInfo.moduleName) || !reader.ReadString(moduleInfo.name) ||
+        !reader.ReadString(moduleInfo.description) || !reader.ReadString(moduleInfo.moduleType) ||
+        !reader.ReadBool(moduleInfo.isDeliveryInstall)) {
+        return false;
+    }
+    uint32_t numOfDeviceType = 0;
+    if (!reader.ReadUint32(numOfDeviceType) || numOfDeviceType > DEVICE_TYPE_SIZE) {
+        return false;
+    }
+    for (uint32_t i = 0; i < numOfDeviceType; i++) {
+        if (!reader.ReadString(moduleInfo.deviceType[i]) || moduleInfo.deviceType[i] == nullptr) {
+            return false;
+        }
+    }
+    uint32_t numOfMetaData = 0;
+    if (!reader.ReadUint32(numOfMetaData) || numOfMetaData > METADATA_SIZE) {
+        return false;
+    }
+    for (uint32_t i = 0; i < numOfMetaData; i++) {
+        MetaData *metaData = reinterpret_cast<MetaData *>(AdapterMalloc(sizeof(MetaData)));
+        if (metaData == nullptr) {
+            return false;
+        }
+        if (memset_s(metaData, sizeof(MetaData), 0, sizeof(MetaData)) != EOK) {
+            AdapterFree(metaData);
+            return false;
+        }
+        moduleInfo.metaData[i] = metaData;
+        if (!reader.ReadString(metaData->name) || !reader.ReadString(metaData->value) ||
+            !reader.ReadString(metaData->extra)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WriteBundleInfo(ParcelWriter &writer, const BundleInfo &bundleInfo)
+{
+    writer.WriteBool(bundleInfo.isSystemApp);
+    writer.WriteBool(bundleInfo.isNativeApp);
+    writer.WriteBool(bundleInfo.isKeepAlive);
+    writer.WriteInt32(bundleInfo.versionCode);
+    writer.WriteInt32(bundleInfo.uid);
+    writer.WriteInt32(bundleInfo.gid);
+    writer.WriteInt32(bundleInfo.compatibleApi);
+    writer.WriteInt32(bundleInfo.targetApi);
+    writer.WriteString(bundleInfo.versionName);
+    writer.WriteString(bundleInfo.bundleName);
+    writer.WriteString(bundleInfo.label);
+    writer.WriteString(bundleInfo.bigIconPath);
+    writer.WriteString(bundleInfo.codePath);
+    writer.WriteString(bundleInfo.dataPath);
+    writer.WriteString(bundleInfo.vendor);
+    writer.WriteString(bundleInfo.appId);
+    int32_t numOfModule = (bundleInfo.moduleInfos == nullptr || bundleInfo.numOfModule < 0) ?
+        0 : bundleInfo.numOfModule;
+    writer.WriteInt32(numOfModule);
+    for (int32_t i = 0; i < numOfModule; i++) {
+        WriteModuleInfo(writer, bundleInfo.moduleInfos[i]);
+    }
+    int32_t numOfAbility = (bundleInfo.abilityInfos == nullptr || bundleInfo.numOfAbility < 0) ?
+        0 : bundleInfo.numOfAbility;
+    writer.WriteInt32(numOfAbility);
+    for (int32_t i = 0; i < numOfAbility; i++) {
+        WriteAbilityInfo(writer, bundleInfo.abilityInfos[i]);
+    }
+}
+
+template<typename T>
+T *AllocZeroedArray(uint32_t num)
+{
+    T *array = reinterpret_cast<T *>(AdapterMalloc(sizeof(T) * num));
+    if (array == nullptr) {
+        return nullptr;
+    }
+    if (memset_s(array, sizeof(T) * num, 0, sizeof(T) * num) != EOK) {
+        AdapterFree(array);
+        return nullptr;
+    }
+    return array;
+}
+
+void WriteBundleInfos(ParcelWriter &writer, const BundleInfo *bundleInfos, uint32_t numOfBundleInfo)
+{
+    WriteHeader(writer, numOfBundleInfo);
+    for (uint32_t i = 0; i < numOfBundleInfo; i++) {
+        WriteBundleInfo(writer, bundleInfos[i]);
+    }
+}
+
+bool ReadBundleInfo(ParcelReader &reader, BundleInfo &bundleInfo)
+{
+    if (!reader.ReadBool(bundleInfo.isSystemApp) || !reader.ReadBool(bundleInfo.isNativeApp) ||
+        !reader.ReadBool(bundleInfo.isKeepAlive) || !reader.ReadInt32(bundleInfo.versionCode) ||
+        !reader.ReadInt32(bundleInfo.uid) || !reader.ReadInt32(bundleInfo.gid) ||
+        !reader.ReadInt32(bundleInfo.compatibleApi) || !reader.ReadInt32(bundleInfo.targetApi)) {
+        return false;
+    }
+    if (!reader.ReadString(bundleInfo.versionName) || !reader.ReadString(bundleInfo.bundleName) ||
+        !reader.ReadString(bundleInfo.label) || !reader.ReadString(bundleInfo.bigIconPath) ||
+        !reader.ReadString(bundleInfo.codePath) || !reader.ReadString(bundleInfo.dataPath) ||
+        !reader.ReadString(bundleInfo.vendor) || !reader.ReadString(bundleInfo.appId)) {
+        return false;
+    }
+    // the counts are only set once the arrays exist, so a partly decoded info is cleared correctly
+    int32_t numOfModule = 0;
+    if (!reader.ReadInt32(numOfModule) || numOfModule < 0 ||
+        static_cast<uint32_t>(numOfModule) > reader.GetRemainingSize()) {
+        return false;
+    }
+    if (numOfModule > 0) {
+        bundleInfo.moduleInfos = AllocZeroedArray<ModuleInfo>(numOfModule);
+        if (bundleInfo.moduleInfos == nullptr) {
+            return false;
+        }
+        bundleInfo.numOfModule = numOfModule;
+        for (int32_t i = 0; i < numOfModule; i++) {
+            if (!ReadModuleInfo(reader, bundleInfo.moduleInfos[i])) {
+                return false;
+            }
+        }
+    }
+    int32_t numOfAbility = 0;
+    if (!reader.ReadInt32(numOfAbility) || numOfAbility < 0 ||
+        static_cast<uint32_t>(numOfAbility) > reader.GetRemainingSize()) {
+        return false;
+    }
+    if (numOfAbility > 0) {
+        bundleInfo.abilityInfos = AllocZeroedArray<AbilityInfo>(numOfAbility);
+        if (bundleInfo.abilityInfos == nullptr) {
+            return false;
+        }
+        bundleInfo.numOfAbility = numOfAbility;
+        for (int32_t i = 0; i < numOfAbility; i++) {
+            if (!ReadAbilityInfo(reader, bundleInfo.abilityInfos[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+uint8_t *ParcelUtils::MarshallingAbilityInfo(const AbilityInfo *abilityInfo, uint32_t *size)
+{
+    if (abilityInfo == nullptr || size == nullptr) {
+        return nullptr;
+    }
+    ParcelWriter counter(nullptr, 0);
+    WriteHeader(counter, 1);
+    WriteAbilityInfo(counter, *abilityInfo);
+    uint8_t *buff = reinterpret_cast<uint8_t *>(AdapterMalloc(counter.GetOffset()));
+    if (buff == nullptr) {
+        return nullptr;
+    }
+    ParcelWriter writer(buff, counter.GetOffset());
+    WriteHeader(writer, 1);
+    WriteAbilityInfo(writer, *abilityInfo);
+    *size = writer.GetOffset();
+    return buff;
+}
+
+uint32_t ParcelUtils::GetBundleInfosSize(const BundleInfo *bundleInfos, uint32_t numOfBundleInfo)
+{
+    if (bundleInfos == nullptr || numOfBundleInfo == 0) {
+        return 0;
+    }
+    ParcelWriter counter(nullptr, 0);
+    WriteBundleInfos(counter, bundleInfos, numOfBundleInfo);
+    return counter.GetOffset();
+}
+
+bool ParcelUtils::MarshallingBundleInfos(const BundleInfo *bundleInfos, uint32_t numOfBundleInfo, uint8_t *buff,
+    uint32_t size)
+{
+    if (bundleInfos == nullptr || numOfBundleInfo == 0 || buff == nullptr) {
+        return false;
+    }
+    ParcelWriter writer(buff, size);
+    WriteBundleInfos(writer, bundleInfos, numOfBundleInfo);
+    return writer.GetOffset() == size;
+}
+
+uint8_t *ParcelUtils::MarshallingBundleInfos(const BundleInfo *bundleInfos, uint32_t numOfBundleInfo,
+    uint32_t *size)
+{
+    if (size == nullptr) {
+        return nullptr;
+    }
+    uint32_t parcelSize = GetBundleInfosSize(bundleInfos, numOfBundleInfo);
+    if (parcelSize == 0) {
+        return nullptr;
+    }
+    uint8_t *buff = reinterpret_cast<uint8_t *>(AdapterMalloc(parcelSize));
+    if (buff == nullptr) {
+        return nullptr;
+    }
+    if (!MarshallingBundleInfos(bundleInfos, numOfBundleInfo, buff, parcelSize)) {
+        AdapterFree(buff);
+        return nullptr;
+    }
+    *size = parcelSize;
+    return buff;
+}
+
+AbilityInfo *ParcelUtils::UnmarshallingAbilityInfo(const uint8_t *buff, uint32_t size)
+{
+    if (buff == nullptr) {
+        return nullptr;
+    }
+    ParcelReader reader(buff, size);
+    if (!ReadHeader(reader, 1)) {
+        return nullptr;
+    }
+    AbilityInfo *abilityInfo = AllocZeroedArray<AbilityInfo>(1);
+    if (abilityInfo == nullptr) {
+        return nullptr;
+    }
+    if (!ReadAbilityInfo(reader, *abilityInfo) || !reader.AtEnd()) {
+        ClearAbilityInfo(abilityInfo);
+        AdapterFree(abilityInfo);
+        return nullptr;
+    }
+    return abilityInfo;
+}
+
+BundleInfo *ParcelUtils::UnmarshallingBundleInfo(const uint8_t *buff, uint32_t size)
+{
+    BundleInfo *bundleInfo = nullptr;
+    if (!UnmarshallingBundleInfos(buff, size, &bundleInfo, 1)) {
+        return nullptr;
+    }
+    return bundleInfo;
+}
+
+bool ParcelUtils::UnmarshallingBundleInfos(const uint8_t *buff, uint32_t size, BundleInfo **bundleInfos,
+    uint32_t numOfBundleInfo)
+{
+    if (buff == nullptr || bundleInfos == nullptr || numOfBundleInfo == 0) {
+        return false;
+    }
+    ParcelReader reader(buff, size);
+    if (!ReadHeader(reader, numOfBundleInfo) || numOfBundleInfo > reader.GetRemainingSize()) {
+        return false;
+    }
+    *bundleInfos = AllocZeroedArray<BundleInfo>(numOfBundleInfo);
+    if (*bundleInfos == nullptr) {
+        return false;
+    }
+    for (uint32_t i = 0; i < numOfBundleInfo; i++) {
+        if (!ReadBundleInfo(reader, (*bundleInfos)[i])) {
+            BundleInfoUtils::FreeBundleInfos(*bundleInfos, numOfBundleInfo);
+            *bundleInfos = nullptr;
+            return false;
+        }
+    }
+    if (!reader.AtEnd()) {
+        BundleInfoUtils::FreeBundleInfos(*bundleInfos, numOfBundleInfo);
+        *bundleInfos = nullptr;
+        return false;
+    }
+    return true;
+}
+} // OHOS
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shared_memory_utils.h"
+
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "bundle_log.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace {
+const char SHARED_MEMORY_NAME[] = "bms_parcel";
+const uint8_t MAX_SHM_NAME_LENGTH = 64;
+#ifndef MFD_CLOEXEC
+const uint32_t MFD_CLOEXEC = 0x0001U;
+#endif
+#ifndef MFD_ALLOW_SEALING
+const uint32_t MFD_ALLOW_SEALING = 0x0002U;
+#endif
+
+int32_t CreateAnonymousFile()
+{
+    int32_t fd = -1;
+#ifdef SYS_memfd_create
+    fd = static_cast<int32_t>(syscall(SYS_memfd_create, SHARED_MEMORY_NAME, MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (fd >= 0 || errno != ENOSYS) {
+        return fd;
+    }
+#endif
+    // stand-in for kernels without memfd, the name is unlinked at once so only the descriptor refers to it
+    static std::atomic<uint32_t> sequence(0);
+    char name[MAX_SHM_NAME_LENGTH] = { 0 };
+    if (sprintf_s(name, MAX_SHM_NAME_LENGTH, "/%s_%d_%u", SHARED_MEMORY_NAME, getpid(), sequence++) < 0) {
+        return -1;
+    }
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd >= 0) {
+        shm_unlink(name);
+    }
+    return fd;
+}
+}
+
+int32_t SharedMemoryUtils::CreateRegion(uint32_t size, uint8_t **addr)
+{
+    if (size == 0 || addr == nullptr) {
+        return -1;
+    }
+    int32_t fd = CreateAnonymousFile();
+    if (fd < 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "create shared memory failed: %{public}d", errno);
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "resize shared memory to %{public}u failed: %{public}d", size, errno);
+        close(fd);
+        return -1;
+    }
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        HILOG_ERROR(HILOG_MODULE_APP, "map shared memory failed: %{public}d", errno);
+        close(fd);
+        return -1;
+    }
+    *addr = reinterpret_cast<uint8_t *>(mapped);
+    return fd;
+}
+
+bool SharedMemoryUtils::SealRegion(int32_t fd, uint8_t *addr, uint32_t size)
+{
+    if (fd < 0 || addr == nullptr) {
+        return false;
+    }
+    // the writable mapping has to be gone before F_SEAL_WRITE is accepted
+    munmap(addr, size);
+#if defined(F_ADD_SEALS) && defined(F_SEAL_WRITE)
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0 && errno != EINVAL) {
+        HILOG_WARN(HILOG_MODULE_APP, "seal shared memory failed: %{public}d", errno);
+    }
+#endif
+    return true;
+}
+
+const uint8_t *SharedMemoryUtils::MapRegion(int32_t fd, uint32_t size)
+{
+    if (fd < 0 || size == 0) {
+        return nullptr;
+    }
+    // an unsealed region could have been shrunk, reading past its end would fault
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(size)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "shared memory is smaller than %{public}u", size);
+        return nullptr;
+    }
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        HILOG_ERROR(HILOG_MODULE_APP, "map shared memory read-only failed: %{public}d", errno);
+        return nullptr;
+    }
+    return reinterpret_cast<const uint8_t *>(mapped);
+}
+
+void SharedMemoryUtils::UnmapRegion(const uint8_t *addr, uint32_t size)
+{
+    if (addr != nullptr) {
+        munmap(const_cast<uint8_t *>(addr), size);
+    }
+}
+} // OHOS
@@ -30,6 +30,8 @@ extern "C" {
 const char BMS_SERVICE[] = "bundlems";
 const char BMS_FEATURE[] = "BmsFeature";
 const char BMS_INNER_FEATURE[] = "BmsInnerFeature";
+// haps installed by a single INSTALL_BATCH request at most
+const uint32_t MAX_BATCH_INSTALL_NUM = 16;
 
 enum BmsCmd {
     QUERY_ABILITY_INFO = 0,
@@ -52,6 +54,10 @@ enum BmsCmd {
     SET_SIGN_DEBUG_MODE,
     SET_SIGN_MODE,
 #endif
+    // fixed values, so that a client and a bms built with and without OHOS_DEBUG agree on them
+    GET_BUNDLE_INFOS_IF_MODIFIED = 17,
+    GET_BUNDLE_INFOS_CHANGED_SINCE = 18,
+    INSTALL_BATCH = 19, // bms install several applications at once
     BMS_CMD_END
 };
 
@@ -273,6 +273,106 @@ SystemCapability *GetSystemAvailableCapabilities();
  * @version 4
  */
 void FreeSystemAvailableCapabilitiesInfo(SystemCapability *sysCap);
+
+/**
+ * @brief Enables or disables the per-process cache of {@link BundleInfo} and {@link AbilityInfo}.
+ *
+ * When enabled, repeated {@link GetBundleInfo} and {@link QueryAbilityInfo} calls for the same bundle are served from
+ * local memory until the bundle is installed, updated, or uninstalled again. The caller must have the
+ * ohos.permission.GET_BUNDLE_INFO permission, which is checked when the cache is enabled.
+ *
+ * @param enable Specifies whether to enable the cache. Disabling it frees all cached information.
+ * @return Returns {@link ERR_OK} if this function is successfully called; returns another error code defined in
+ * {@link AppexecfwkErrors} otherwise.
+ *
+ * @since 10
+ * @version 10
+ */
+uint8_t EnableBundleInfoCache(bool enable);
+
+/**
+ * @brief Obtains the {@link BundleInfo} of all bundles in the system if any bundle has changed since the given
+ * generation.
+ *
+ * @param flags Specifies whether each of the obtained {@link BundleInfo} objects can contain {@link AbilityInfo}.
+ * @param generation Indicates the generation returned by the previous call, or <b>0</b> for the first call. It is
+ * updated to the current generation when this function is successfully called.
+ * @param bundleInfos Indicates the double pointer to the obtained {@link BundleInfo} objects. It is set to nullptr,
+ * and <b>len</b> is set to <b>0</b>, if nothing has changed since <b>generation</b>.
+ * @param len Indicates the pointer to the number of {@link BundleInfo} objects obtained.
+ * @return Returns {@link ERR_OK} if this function is successfully called; returns another error code defined in
+ * {@link AppexecfwkErrors} otherwise.
+ *
+ * @since 10
+ * @version 10
+ */
+uint8_t GetBundleInfosIfModified(const int flags, uint64_t *generation, BundleInfo **bundleInfos, int32_t *len);
+
+/**
+ * @brief Defines the bundle changes obtained by {@link GetBundleInfosChangedSince}.
+ */
+typedef struct {
+    /** Generation of the bundle database the changes lead up to */
+    uint64_t generation;
+
+    /** Bundles installed or updated since the given generation, or all bundles if <b>isFullList</b> is set */
+    BundleInfo *bundleInfos;
+
+    /** Number of {@link BundleInfo} objects in <b>bundleInfos</b> */
+    int32_t numOfBundleInfo;
+
+    /** Names of the bundles uninstalled since the given generation */
+    char **removedBundleNames;
+
+    /** Number of names in <b>removedBundleNames</b> */
+    int32_t numOfRemovedBundle;
+
+    /** Whether the given generation is too old to be replayed, in which case <b>bundleInfos</b> holds every bundle */
+    bool isFullList;
+} BundleInfosDelta;
+
+/**
+ * @brief Obtains the bundles installed, updated, or uninstalled since the given generation.
+ *
+ * @param flags Specifies whether each of the obtained {@link BundleInfo} objects can contain {@link AbilityInfo}.
+ * @param generation Indicates the generation of a previous {@link BundleInfosDelta}, or <b>0</b> for the first call.
+ * @param delta Indicates the pointer to the obtained {@link BundleInfosDelta}. It should be released by
+ * {@link FreeBundleInfosDelta} after use.
+ * @return Returns {@link ERR_OK} if this function is successfully called; returns another error code defined in
+ * {@link AppexecfwkErrors} otherwise.
+ *
+ * @since 10
+ * @version 10
+ */
+uint8_t GetBundleInfosChangedSince(const int flags, uint64_t generation, BundleInfosDelta *delta);
+
+/**
+ * @brief Releases the bundle infos and names held by a {@link BundleInfosDelta}.
+ *
+ * @param delta Indicates the pointer to the {@link BundleInfosDelta} to release.
+ *
+ * @since 10
+ * @version 10
+ */
+void FreeBundleInfosDelta(BundleInfosDelta *delta);
+
+/**
+ * @brief Installs or updates several applications at once.
+ *
+ * All the HAPs are verified, parsed, and extracted before any of them is installed, so nothing is installed if one of
+ * them is invalid. The installation records of the batch are stored together, and the result is notified once.
+ *
+ * @param hapPaths Indicates the pointer to the paths of the HAPs to install or update.
+ * @param numOfHap Indicates the number of paths in <b>hapPaths</b>, which cannot exceed 16.
+ * @param installParam Indicates the pointer to the parameters used for the installation or update of every HAP.
+ * @param installerCallback Indicates the callback to be invoked for notifying the result of the whole batch.
+ * @return Returns <b>true</b> if this function is successfully called; returns <b>false</b> otherwise.
+ *
+ * @since 10
+ * @version 10
+ */
+bool InstallBatch(const char * const *hapPaths, uint32_t numOfHap, const InstallParam *installParam,
+    InstallerCallback installerCallback);
 #endif
 /**
  * @brief Get bundle size
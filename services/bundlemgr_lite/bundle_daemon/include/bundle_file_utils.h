@@ -36,6 +36,7 @@ public:
     static bool RenameFile(const char *oldDir, const char *newDir);
     static bool ChownFile(const char *file, int32_t uid, int32_t gid);
     static bool WriteFile(const char *file, const void *buffer, uint32_t size);
+    static bool SyncFileSystem(const char *path);
     static bool IsValidPath(const std::string &rootDir, const std::string &path);
     static std::string GetPathDir(const std::string &path);
 };
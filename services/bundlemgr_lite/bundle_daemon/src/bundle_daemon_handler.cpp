@@ -15,9 +15,14 @@
 
 #include "bundle_daemon_handler.h"
 
+#include <atomic>
 #include <climits>
 #include <cstring>
 #include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 #include "bundle_daemon_log.h"
 #include "bundle_file_utils.h"
@@ -36,6 +41,69 @@ const std::string SYSTEM_HAP_PATH = "/system/internal";
 const std::string THIRD_HAP_PATH = "/system/external";
 const std::string SDCARD = "/sdcard";
 const std::string STORAGE = "/storage";
+#ifndef BUNDLE_DAEMON_EXTRACT_THREADS
+#define BUNDLE_DAEMON_EXTRACT_THREADS 4
+#endif
+constexpr int32_t MAX_EXTRACT_THREADS = BUNDLE_DAEMON_EXTRACT_THREADS;
+// below this many files per thread the extra hap handles cost more than they save
+constexpr size_t MIN_FILES_PER_THREAD = 32;
+
+// entries of one hap shared by the extracting threads, which claim them in zip order
+struct ExtractTask {
+    const char *hapPath;
+    const std::string *codeDir;
+    const std::vector<const std::string *> *files;
+    std::atomic<size_t> nextIndex;
+    std::atomic<size_t> failedIndex;
+    std::atomic<uint64_t> readBytes;
+};
+
+void ExtractFiles(const ExtractorUtil &extractorUtil, ExtractTask &task)
+{
+    size_t count = task.files->size();
+    while (true) {
+        size_t index = task.nextIndex.fetch_add(1);
+        // files before a failed one are still extracted, so the failure reported is always the first in zip order
+        if (index >= count || index > task.failedIndex.load()) {
+            return;
+        }
+        const std::string &fileName = *((*task.files)[index]);
+        if (extractorUtil.ExtractFileToPath(*task.codeDir + fileName, fileName)) {
+            continue;
+        }
+        size_t failedIndex = task.failedIndex.load();
+        while (index < failedIndex && !task.failedIndex.compare_exchange_weak(failedIndex, index)) {
+            // failedIndex now holds the value another thread stored, retry while this one is still lower
+        }
+    }
+}
+
+void *ExtractWorker(void *arg)
+{
+    ExtractTask *task = reinterpret_cast<ExtractTask *>(arg);
+    // every thread reads the hap through its own handle and mapping
+    ExtractorUtil extractorUtil(task->hapPath);
+    // when the hap cannot be opened here the files are left to the other threads, the calling one drains them all
+    if (extractorUtil.Init()) {
+        ExtractFiles(extractorUtil, *task);
+    }
+    task->readBytes += extractorUtil.GetReadBytes();
+    return nullptr;
+}
+
+int32_t GetExtractThreadNum(size_t fileNum)
+{
+    long cpuNum = sysconf(_SC_NPROCESSORS_ONLN);
+    int32_t threadNum = MAX_EXTRACT_THREADS;
+    if (cpuNum > 0 && cpuNum < threadNum) {
+        threadNum = static_cast<int32_t>(cpuNum);
+    }
+    size_t limit = fileNum / MIN_FILES_PER_THREAD;
+    if (limit < static_cast<size_t>(threadNum)) {
+        threadNum = static_cast<int32_t>(limit);
+    }
+    return (threadNum < 1) ? 1 : threadNum;
+}
 }
 
 int32_t BundleDaemonHandler::ExtractHap(const char *hapPath, const char *codePath)
@@ -69,8 +137,10 @@ int32_t BundleDaemonHandler::ExtractHap(const char *hapPath, const char *codePat
         return EC_NODIR;
     }
 
-    // unzip one by one
+    // create every directory first, then extract the files on up to GetExtractThreadNum threads
     const std::vector<std::string> &fileNames = extractorUtil.GetZipFileNames();
+    std::vector<const std::string *> files;
+    files.reserve(fileNames.size());
     for (const auto &fileName : fileNames) {
         if (fileName.find("..") != std::string::npos) {
             PRINTE("BundleDaemonHandler", "zip file is invalid!");
@@ -87,11 +157,46 @@ int32_t BundleDaemonHandler::ExtractHap(const char *hapPath, const char *codePat
                 return EC_NODIR;
             }
         }
-        std::string filePath = codeDir + fileName;
-        if (!extractorUtil.ExtractFileToPath(filePath, fileName)) {
-            PRINTE("BundleDaemonHandler", "ExtractFileToPath fail!");
-            return EC_NODIR;
+        files.emplace_back(&fileName);
+    }
+
+    ExtractTask task;
+    task.hapPath = realHapPath;
+    task.codeDir = &codeDir;
+    task.files = &files;
+    task.nextIndex = 0;
+    task.failedIndex = files.size();
+    task.readBytes = 0;
+    int32_t threadNum = GetExtractThreadNum(files.size());
+    std::vector<pthread_t> threads;
+    threads.reserve(threadNum - 1);
+    for (int32_t i = 1; i < threadNum; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, ExtractWorker, &task) != 0) {
+            PRINTW("BundleDaemonHandler", "create extract thread fail, use %{public}d threads", i);
+            break;
         }
+        threads.emplace_back(thread);
+    }
+    ExtractFiles(extractorUtil, task);
+    for (pthread_t thread : threads) {
+        pthread_join(thread, nullptr);
+    }
+    // every extra thread parses the central directory again, everything else should be read exactly once; the
+    // profile parse and the full pass of the signature check are read by bms and logged there
+    task.readBytes += extractorUtil.GetReadBytes();
+    struct stat hapStat = {};
+    PRINTI("BundleDaemonHandler", "extraction read %{public}llu bytes of a %{public}lld bytes hap on %{public}zu "
+        "threads", static_cast<unsigned long long>(task.readBytes.load()),
+        (stat(realHapPath, &hapStat) == 0) ? static_cast<long long>(hapStat.st_size) : -1LL, threads.size() + 1);
+    if (task.failedIndex.load() < files.size()) {
+        PRINTE("BundleDaemonHandler", "ExtractFileToPath fail!");
+        return EC_NODIR;
+    }
+    // the files are written unsynced, a single flush makes them durable before the code path is renamed
+    if (!BundleFileUtils::SyncFileSystem(codeDir.c_str())) {
+        PRINTE("BundleDaemonHandler", "sync codePath fail!");
+        return EC_NODIR;
     }
     return EC_SUCCESS;
 }
@@ -108,6 +213,12 @@ int32_t BundleDaemonHandler::RenameFile(const char *oldFile, const char *newFile
         PRINTE("BundleDaemonHandler", "file path is invalid");
         return EC_INVALID;
     }
+    // a hap extracted aside is moved into the dir of a bundle that may not have been installed before
+    if (IsValideCodePath(newFile) && !BundleFileUtils::MkRecursiveDir(BundleFileUtils::GetPathDir(newFile).c_str(),
+        true)) {
+        PRINTE("BundleDaemonHandler", "create parent dir fail");
+        return EC_NODIR;
+    }
     if (!BundleFileUtils::RenameFile(realOldPath, newFile)) {
         PRINTE("BundleDaemonHandler", "rename dir fail");
         return EC_NODIR;
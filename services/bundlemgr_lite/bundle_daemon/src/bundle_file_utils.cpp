@@ -173,6 +173,27 @@ bool BundleFileUtils::WriteFile(const char *file, const void *buffer, uint32_t s
     return true;
 }
 
+bool BundleFileUtils::SyncFileSystem(const char *path)
+{
+    if (path == nullptr) {
+        return false;
+    }
+
+    int32_t fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+#ifdef __LINUX__
+    // one flush of the file system holding path, covering every file and directory written there
+    bool result = (syncfs(fd) == 0);
+#else
+    sync();
+    bool result = true;
+#endif
+    close(fd);
+    return result;
+}
+
 bool BundleFileUtils::IsValidPath(const std::string &rootDir, const std::string &path)
 {
     if (rootDir.find(PATH_SEPARATOR) != 0 || rootDir.rfind(PATH_SEPARATOR) != (rootDir.size() - 1) ||
@@ -19,10 +19,12 @@
 #include <sstream>
 #include <string>
 
+#include "extractor_util.h"
+
 namespace OHOS {
 class BundleExtractor {
 public:
-    static uint8_t ExtractHapProfile(const std::string &hapFile, std::ostringstream &profileStream);
+    static uint8_t ExtractHapProfile(ExtractorUtil &extractorUtil, std::ostringstream &profileStream);
 private:
     BundleExtractor() = default;
     ~BundleExtractor() = default;
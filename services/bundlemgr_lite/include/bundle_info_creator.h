@@ -29,7 +29,8 @@ public:
 
     static BundleInfo *CreateBundleInfo(const BundleProfile &bundleProfile, const std::string &installDirPath,
         const std::string &dataDirPath, const BundleRes &bundleRes);
-    static uint8_t SaveBundleInfo(const BundleProfile &bundleProfile, BundleInfo **bundleInfo);
+    static uint8_t SaveBundleInfo(const BundleProfile &bundleProfile, const std::string &installDirPath,
+        const std::string &dataDirPath, BundleInfo **bundleInfo);
 private:
     static bool SetBundleInfo(const BundleProfile &bundleProfile, const std::string &installDirPath,
         const std::string &dataDirPath, BundleInfo *bundleInfo);
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_INFO_CURSOR_H
+#define OHOS_BUNDLE_INFO_CURSOR_H
+
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "bundle_info.h"
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+// snapshots of bundle infos opened by GET_BUNDLE_INFO_LENGTH and paged out by GET_BUNDLE_INFO_BY_INDEX, each one
+// only to the uid that opened it
+class BundleInfoCursor {
+public:
+    static BundleInfoCursor &GetInstance()
+    {
+        static BundleInfoCursor instance;
+        return instance;
+    }
+
+    ~BundleInfoCursor();
+    uint32_t Open(BundleInfo *bundleInfos, int32_t length, pid_t uid);
+    uint8_t Marshalling(uint32_t token, pid_t uid, int32_t index, uint8_t **buff, uint32_t *size);
+    void Close(uint32_t token, pid_t uid);
+
+private:
+    struct Snapshot {
+        uint32_t token;
+        pid_t uid;
+        int32_t length;
+        BundleInfo *bundleInfos;
+        int64_t lastAccessTime;
+    };
+
+    BundleInfoCursor();
+    Snapshot *FindSnapshot(uint32_t token);
+    void FreeSnapshot(Snapshot &snapshot);
+    void FreeExpiredSnapshots(int64_t now);
+    static int64_t GetCurrentTime();
+
+    static const int32_t MAX_SNAPSHOT_NUM = 4;
+    Snapshot snapshots_[MAX_SNAPSHOT_NUM];
+    uint32_t nextToken_;
+    pthread_mutex_t mutex_;
+
+    DISALLOW_COPY_AND_MOVE(BundleInfoCursor);
+};
+} // namespace OHOS
+#endif // OHOS_BUNDLE_INFO_CURSOR_H
@@ -37,6 +37,13 @@ struct SvcIdentityInfo {
     bool keepData;
 };
 
+struct BatchInstallInfo {
+    char **paths;
+    uint32_t pathNum;
+    SvcIdentity *svc;
+    int32_t installLocation;
+};
+
 class BundleInnerFeature : private Feature {
 public:
     static BundleInnerFeature *GetInstance()
@@ -58,6 +65,8 @@ private:
     static uint8_t GetSvcIdentityInfo(
     OHOS::SvcIdentityInfo *info, const SvcIdentity *svc, const char *reqPath, IpcIo *req);
     static uint8_t UninstallInnerBundle(const uint8_t funcId, IpcIo *req, IpcIo *reply);
+    static uint8_t InstallInnerBundleBatch(const uint8_t funcId, IpcIo *req, IpcIo *reply);
+    static uint8_t GetBatchInstallInfo(BatchInstallInfo *info, IpcIo *req);
 #ifdef OHOS_DEBUG
     static uint8_t SetExternalInstallMode(const uint8_t funcId, IpcIo *req, IpcIo *reply);
     static uint8_t SetInnerDebugMode(const uint8_t funcId, IpcIo *req, IpcIo *reply);
@@ -76,5 +85,6 @@ typedef struct {
 } BmsInnerImpl;
 
 IUnknown *GetBmsInnerFeatureApi(Feature *feature);
+void ClearBatchInstallInfo(BatchInstallInfo *info);
 } // namespace OHOS
 #endif // OHOS_BUNDLE_INNER_FEATURE_H
@@ -20,7 +20,9 @@
 #include "bundle_info.h"
 #include "bundle_info_utils.h"
 #include "install_param.h"
+#include "install_session.h"
 #include "hap_sign_verify.h"
+#include "mutex_lock.h"
 #include "stdint.h"
 
 #include <string>
@@ -32,17 +34,66 @@ public:
     BundleInstaller(const std::string &codeDirPath, const std::string &dataDirPath);
     ~BundleInstaller();
 
-    uint8_t Install(const char *path, const InstallParam &installParam);
+    uint8_t Install(const char *path, const InstallParam &installParam, InstallSession *session = nullptr);
+    // all haps are verified, parsed and extracted before any of them is committed, and the batch is committed as a
+    // whole or not at all, installedBundles holds the names of the installed bundles, sessions holds the haps already
+    // opened by the caller, one per path
+    uint8_t InstallBatch(const std::vector<std::string> &paths, const InstallParam &installParam,
+        std::vector<std::string> &installedBundles, const std::vector<InstallSession *> *sessions = nullptr);
     uint8_t Uninstall(const char *bundleName, const InstallParam &installParam);
-    std::string GetCodeDirPath() const;
-    std::string GetDataDirPath() const;
 private:
-    uint8_t ProcessBundleInstall(const std::string &path, const char *randStr, InstallRecord &installRecord,
-        uint8_t hapType);
-    uint8_t HandleFileAndBackUpRecord(const char *codePath, const char *randStr, InstallRecord &record,
-        bool isUpdate, uint8_t hapType);
-    uint8_t UpdateBundleInfo(const char *appId, const BundleRes &bundleRes, BundleInfo *bundleInfo, bool isUpdate,
+    // a bundle that has been verified, parsed and extracted next to its code path, but not committed yet
+    struct PreparedBundle {
+        std::string randStr;
+        std::string bundleName;
+        // the dir of the bundle, the module dir the hap is extracted to and the data dir
+        std::string bundlePath;
+        std::string codePath;
+        std::string dataPath;
+        // the code of the installed version is moved here until the update is committed
+        std::string backupCodePath;
+        // the module dir of the installed version, its permissions are read back from there by a rollback
+        std::string oldProfilePath;
+        BundleInfo *bundleInfo = nullptr;
+        // a copy of the installed version, put back into the bundle map by a rollback
+        BundleInfo *oldBundleInfo = nullptr;
+        Permissions permissions = { .permNum = 0, .permissionTrans = nullptr };
+        BundleRes bundleRes = {
+            .bundleName = nullptr, .moduleDescriptionId = 0, .abilityRes = nullptr, .totalNumOfAbilityRes = 0
+        };
+        InstallRecord installRecord = {
+            .bundleName = nullptr, .codePath = nullptr, .appId = nullptr, .versionCode = -1, .uid = INVALID_UID,
+            .gid = INVALID_GID
+        };
+        // the steps of the commit the bundle has gone through, a rollback undoes them in reverse order
+        bool isStaged = false;
+        bool isUpdate = false;
+        bool hasBackUpCode = false;
+        bool isCodeMoved = false;
+        bool isUidGenerated = false;
+        bool isDataDirCreated = false;
+        bool isPermissionStored = false;
+        bool hasBackUpRecord = false;
+        bool isRecordRenamed = false;
+        bool isPublished = false;
+    };
+
+    uint8_t ProcessBundleInstall(const std::string &path, InstallSession &session, const char *randStr,
         uint8_t hapType);
+    uint8_t PrepareBundleInstall(const std::string &path, InstallSession &session, PreparedBundle &bundle);
+    uint8_t MoveExtractedHap(const std::string &path, const std::string &extractPath,
+        const std::string &tmpCodePath);
+    void AbortBundleInstall(PreparedBundle &bundle);
+    uint8_t CommitBundles(std::vector<PreparedBundle> &bundles, const char *randStr, uint8_t hapType);
+    uint8_t StageBundle(PreparedBundle &bundle, uint8_t hapType);
+    uint8_t BackUpInstalledVersion(PreparedBundle &bundle);
+    uint8_t CommitInstallRecord(PreparedBundle &bundle);
+    uint8_t PublishBundle(PreparedBundle &bundle);
+    uint8_t CommitUidAndGidInfo(const std::vector<PreparedBundle> &bundles, const char *randStr);
+    void FinishBundle(PreparedBundle &bundle, uint8_t hapType);
+    void RollbackBundle(PreparedBundle &bundle);
+    void RestorePermissions(const PreparedBundle &bundle);
+    void ReleaseBundle(PreparedBundle &bundle);
     uint8_t ReshapeAppId(const char *bundleName, std::string &appId);
     uint8_t CheckProvisionInfoIsValid(const SignatureInfo &signatureInfo, const Permissions &permissions,
         const char *bundleName);
@@ -54,18 +105,23 @@ private:
     uint8_t StorePermissions(const char *bundleName, PermissionTrans *permissions, int32_t permNum, bool isUpdate);
     uint8_t CheckVersionAndSignature(const char *bundleName, BundleInfo *bundleInfo);
     bool RenameJsonFile(const char *fileName, const char *randStr);
+    bool BackUpJsonFile(const char *fileName, const char *randStr);
+    bool RestoreJsonFile(const char *fileName, const char *randStr);
+    void RemoveBackUpJsonFile(const char *fileName, const char *randStr);
     bool CheckIsThirdSystemBundle(const char *bundleName);
     bool BackUpInstallRecord(const InstallRecord &record, const char *jsonPath);
     void InitThirdSystemBundleRecord(const char *bundleName, const char *path);
-    bool BackUpUidAndGidInfo(const InstallRecord &record, const char *jsonPath);
-    void ModifyInstallDirByHapType(const InstallParam &installParam, uint8_t hapType);
+    bool BackUpUidAndGidInfo(const std::vector<InstallRecord> &records, const char *jsonPath);
+    void ModifyInstallDirByHapType(const InstallParam &installParam, uint8_t hapType, InstallSession &session);
     uint8_t GetHapType(const char *path);
-    void RestoreInstallEnv(const InstallParam &installParam);
     uint8_t CheckDeviceCapIsValid(BundleInfo *bundleInfo);
     bool CheckAbilityCapIsValid(AbilityInfo *abilityInfo, char sysCaps[][MAX_SYSCAP_NAME_LEN], int32_t sysNum);
 
     std::string codeDirPath_;
     std::string dataDirPath_;
+    // haps are prepared by several installs at a time, the uid map and the records they share are committed by
+    // one install at a time
+    Mutex commitMutex_;
 };
 
 #define CHECK_PRO_RESULT(errcode, bundleInfo, permissions, abilityRes)       \
@@ -78,15 +134,6 @@ private:
         }                                                                    \
     } while (0)
 
-#define CLEAR_INSTALL_ENV(bundleInfo)                                        \
-    do {                                                                     \
-        if ((bundleInfo) != nullptr) {                                         \
-            BundleDaemonClient::GetInstance().RemoveInstallDirectory(        \
-                (bundleInfo)->codePath, (bundleInfo)->dataPath, false);          \
-            BundleInfoUtils::FreeBundleInfo(bundleInfo);                     \
-        }                                                                    \
-    } while (0)
-
 #define CHECK_PRO_PART_ROLLBACK(errcode, path, permissions, bundleInfo, abilityRes)      \
     do {                                                                                 \
         if ((errcode) != ERR_OK && (bundleInfo) != nullptr) {                                \
@@ -97,17 +144,5 @@ private:
             return errcode;                                                              \
         }                                                                                \
     } while (0)
-
-#define CHECK_PRO_ROLLBACK(errcode, permissions, bundleInfo, abilityRes, randStr)        \
-    do {                                                                                 \
-        if ((errcode) != ERR_OK && (bundleInfo) != nullptr) {                                \
-            AdapterFree((permissions).permissionTrans);                                    \
-            AdapterFree(abilityRes);                                                     \
-            ManagerService::GetInstance().RemoveBundleInfo((bundleInfo)->bundleName);      \
-            BundleUtil::DeleteJsonFile((bundleInfo)->bundleName, randStr);                 \
-            CLEAR_INSTALL_ENV(bundleInfo);                                               \
-            return errcode;                                                              \
-        }                                                                                \
-    } while (0)
 } // namespace OHOS
 #endif // OHOS_BUNDLE_INSTALLER_H
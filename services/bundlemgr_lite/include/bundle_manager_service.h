@@ -16,6 +16,7 @@
 #ifndef OHOS_BUNDLE_MANAGER_SERVICE_H
 #define OHOS_BUNDLE_MANAGER_SERVICE_H
 
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -26,10 +27,14 @@
 #include "bundle_map.h"
 #include "cJSON.h"
 #include "message.h"
+#include "mutex_lock.h"
 #include "nocopyable.h"
 #include "stdint.h"
 
 namespace OHOS {
+struct SvcIdentityInfo;
+struct BatchInstallInfo;
+
 class ManagerService {
 public:
     static ManagerService &GetInstance()
@@ -38,19 +43,26 @@ public:
         return instance;
     }
     void ServiceMsgProcess(Request *request);
-    BundleInfo *QueryBundleInfo(const char *bundleName);
+    BundleInfoRef QueryBundleInfo(const char *bundleName);
     void RemoveBundleInfo(const char *bundleName);
     void AddBundleInfo(BundleInfo *info);
     bool UpdateBundleInfo(BundleInfo *info);
+    uint64_t GetGeneration() const;
+    bool GetBundleInfosChangedSince(uint64_t generation, int32_t flags, BundleInfo **bundleInfos, int32_t *len,
+        std::vector<std::string> &removedBundleNames, uint64_t *currentGeneration);
     uint8_t GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo& bundleInfo);
+    uint8_t GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo, BundleInfoRef &pin);
     uint8_t GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32_t *len);
+    uint8_t QueryAbilityInfo(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo);
+    uint8_t QueryKeepAliveBundleInfos(BundleInfo **bundleInfos, int32_t *len);
+    uint8_t GetBundleInfosByMetaData(const char *metaDataKey, BundleInfo **bundleInfos, int32_t *len);
+    uint8_t GetBundleNameForUid(int32_t uid, char **bundleName);
     uint32_t GetBundleSize(const char *bundleName);
     std::vector<SvcIdentity> GetServiceId() const;
+    void RemoveCallbackServiceId(const SvcIdentity &svc);
     int32_t GenerateUid(const char *bundleName, int8_t bundleStyle);
     void RecycleUid(const char *bundleName);
     static bool GetAmsInterface(AmsInnerInterface **amsInterface);
-    std::string GetCodeDirPath() const;
-    std::string GetDataDirPath() const;
     uint8_t SetExternalInstallMode(bool enable);
     bool IsExternalInstallMode() const;
     uint8_t SetDebugMode(bool enable);
@@ -62,27 +74,63 @@ public:
     bool IsSignMode() const;
 #endif
 private:
+    // an app dir entry of the boot scan, parsed on a scan thread and then published on the service task
+    struct ScanEntry {
+        std::string appPath;
+        std::string bundleName;
+        uint8_t scanFlag = 0;
+        bool isValid = false;
+        bool hasRecord = false;
+        bool needInstall = false;
+        // open only for a system hap that has to be installed or updated
+        InstallSession *session = nullptr;
+        std::vector<BundleInfo *> bundleInfos;
+        std::vector<std::string> invalidProfileDirs;
+    };
+
+    struct ScanTask {
+        ManagerService *service;
+        std::vector<ScanEntry> *entries;
+        const cJSON *uninstallRecord;
+        std::atomic<size_t> nextIndex;
+    };
+
     ManagerService();
     ~ManagerService();
 
     void ScanPackages();
     void ScanSharedLibPath();
-    void ScanAppDir(const char *appDir, const cJSON *uninstallRecord, uint8_t scanFlag);
+    void CollectScanEntries(const char *appDir, uint8_t scanFlag, std::vector<ScanEntry> &entries);
+    uint32_t ParseScanEntries(std::vector<ScanEntry> &entries, const cJSON *uninstallRecord);
+    static void *ParseScanWorker(void *arg);
+    void ParseScanEntry(ScanEntry &entry, const cJSON *uninstallRecord);
+    void LoadBundleInfos(const char *codePath, const char *appId, ScanEntry &entry);
+    void PublishScanEntry(ScanEntry &entry);
     void InstallAllSystemBundle(int32_t scanFlag);
     void InstallSystemBundle(const char *fileDir, const char *fileName);
-    void ReloadBundleInfo(const char *codePath, const char *appId, const char *bundleName, bool isSystemApp);
-    void ReloadEntireBundleInfo(const char *appPath, const char *bundleName, int32_t versionCode, uint8_t scanFlag);
-    bool CheckSystemBundleIsValid(const char *appPath, char **bundleName, int32_t &versionCode);
+    bool CheckSystemBundleIsValid(InstallSession &session, char **bundleName, int32_t &versionCode);
     bool CheckThirdSystemBundleHasUninstalled(const char *bundleName, const cJSON *object);
-    void InstallThirdBundle(const char *path, const SvcIdentity &svc, int32_t installLocation);
+    void SubmitInstall(SvcIdentityInfo &info);
+    void SubmitInstallBatch(BatchInstallInfo &info);
+    void SubmitUninstall(SvcIdentityInfo &info);
+    static void InstallTask(void *arg);
+    static void InstallBatchTask(void *arg);
+    static void UninstallTask(void *arg);
+    void InstallThirdBundle(InstallSession &session, const char *bundleName, const SvcIdentity &svc,
+        int32_t installLocation);
+    void InstallThirdBundleBatch(char **paths, uint32_t pathNum, const std::vector<InstallSession *> &sessions,
+        const SvcIdentity &svc, int32_t installLocation);
+    void UninstallThirdBundle(const char *bundleName, const SvcIdentity &svc, bool keepData);
     void AddCallbackServiceId(const SvcIdentity &svc);
-    void RemoveCallbackServiceId(const SvcIdentity &svc);
     void RestoreUidAndGidMap();
     bool RecycleInnerUid(const std::string &bundleName, std::map<int, std::string> &innerMap);
 
     std::map<int, std::string> sysUidMap_;
     std::map<int, std::string> sysVendorUidMap_;
     std::map<int, std::string> appUidMap_;
+    // installs run on the workers of the install scheduler, while callbacks are registered on the service task
+    Mutex uidMutex_;
+    mutable Mutex svcIdentityMutex_;
     BundleInstaller *installer_;
     BundleMap *bundleMap_;
     std::vector<SvcIdentity> svcIdentity_;
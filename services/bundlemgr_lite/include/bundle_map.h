@@ -16,12 +16,61 @@
 #ifndef OHOS_BUNDLE_MAP_H
 #define OHOS_BUNDLE_MAP_H
 
+#include <cstddef>
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+#include <map>
+#include <string>
+#include <vector>
+#endif
+
 #include "bundle_info.h"
 #include "nocopyable.h"
 #include "stdint.h"
 #include "utils_list.h"
 
 namespace OHOS {
+struct BundleEntry;
+
+// pins a bundle info of BundleMap, the info stays valid until the handle is released even if it is updated or erased
+class BundleInfoRef {
+public:
+    BundleInfoRef() = default;
+    ~BundleInfoRef();
+    BundleInfoRef(BundleInfoRef &&other) noexcept;
+    BundleInfoRef &operator=(BundleInfoRef &&other) noexcept;
+
+    void Release();
+
+    BundleInfo *Get() const
+    {
+        return info_;
+    }
+
+    BundleInfo *operator->() const
+    {
+        return info_;
+    }
+
+    bool operator==(std::nullptr_t) const
+    {
+        return info_ == nullptr;
+    }
+
+    bool operator!=(std::nullptr_t) const
+    {
+        return info_ != nullptr;
+    }
+
+private:
+    friend class BundleMap;
+    explicit BundleInfoRef(BundleEntry *entry);
+
+    BundleEntry *entry_ { nullptr };
+    BundleInfo *info_ { nullptr };
+
+    DISALLOW_COPY(BundleInfoRef);
+};
+
 class BundleMap {
 public:
     static BundleMap *GetInstance()
@@ -33,18 +82,112 @@ public:
 
     void Add(BundleInfo *bundleInfo);
     bool Update(BundleInfo *bundleInfo);
-    BundleInfo *Get(const char *bundleName) const;
+    BundleInfoRef Get(const char *bundleName) const;
     uint8_t GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32_t *len) const;
     uint8_t GetBundleInfosInner(List<BundleInfo *> &bundleInfos) const;
     uint8_t GetBundleInfosNoReplication(int32_t flags, BundleInfo **bundleInfos, int32_t *len) const;
     uint8_t GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo) const;
+    uint8_t GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo, BundleInfoRef &pin) const;
     void Erase(const char *bundleName);
     void EraseAll();
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    uint64_t GetGeneration() const;
+    // copies the bundles added or updated after the generation and names the erased ones, returns false when the
+    // change journal no longer reaches back to it and the caller has to fall back to the full list
+    bool GetBundleInfosChangedSince(uint64_t generation, int32_t flags, BundleInfo **bundleInfos, int32_t *len,
+        std::vector<std::string> &removedBundleNames, uint64_t *currentGeneration) const;
+    uint8_t GetBundleNameForUid(int32_t uid, char **bundleName) const;
+    uint8_t GetBundleInfosByMetaData(const char *metaDataKey, BundleInfo **bundleInfos, int32_t *len) const;
+    uint8_t GetKeepAliveBundleInfos(BundleInfo **bundleInfos, int32_t *len) const;
+    uint8_t QueryAbilityInfo(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo) const;
+#else
+    // copies the ability of every bundle that lists the action, or the entity, in one of its skills, each bundle
+    // once and in the order of the bundle list
+    uint8_t GetAbilityInfosBySkill(const char *action, const char *entity, AbilityInfo **abilityInfos,
+        int32_t *len) const;
+#endif
 
 private:
+    // slot of an open-addressing index, the hash is kept to avoid comparing keys on mismatched probes and
+    // the ordinal tells apart the slots of one node, such as the abilities of a bundle
+    struct IndexSlot {
+        uint32_t hash;
+        int32_t ordinal;
+        Node<BundleEntry *> *node;
+    };
+
+    struct NodeIndex {
+        IndexSlot *slots;
+        uint32_t capacity;
+        uint32_t size;
+    };
+
     BundleMap();
     void GetCopyBundleInfo(uint32_t flags, const BundleInfo *bundleInfo, BundleInfo &newBundleInfo) const;
-    List<BundleInfo *> *bundleInfos_;
+    static uint32_t HashString(const char *str, uint32_t hash);
+    static uint32_t HashBundleName(const char *bundleName);
+    Node<BundleEntry *> *FindNode(const char *bundleName, uint32_t hash) const;
+    static bool InsertIndex(NodeIndex &index, Node<BundleEntry *> *node, uint32_t hash, int32_t ordinal = 0);
+    static void EraseIndex(NodeIndex &index, const Node<BundleEntry *> *node, uint32_t hash, int32_t ordinal = 0);
+    static bool ReserveIndex(NodeIndex &index, uint32_t size);
+    static bool GrowIndex(NodeIndex &index);
+    static void ClearIndex(NodeIndex &index);
+    static void FreeIndex(NodeIndex &index);
+    List<BundleEntry *> *bundleInfos_;
+    NodeIndex nameIndex_;
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    // ring of the latest changes, each one names the bundle changed by the mutation that produced its generation
+    struct ChangeRecord {
+        uint64_t generation;
+        char *bundleName;
+    };
+    static const uint32_t MAX_CHANGE_RECORD_NUM = 32;
+
+    void RecordChange(const char *bundleName);
+    void ClearChangeRecords();
+    bool IsCoveredByJournal(uint64_t generation) const;
+    static uint32_t HashUid(int32_t uid);
+    Node<BundleEntry *> *FindNodeByUid(int32_t uid, uint32_t hash) const;
+    bool InsertUidIndex(Node<BundleEntry *> *node);
+    void EraseUidIndex(const Node<BundleEntry *> *node, int32_t uid);
+    void InsertMetaDataIndex(Node<BundleEntry *> *node);
+    void EraseMetaDataIndex(const Node<BundleEntry *> *node, const BundleInfo *bundleInfo);
+    void InsertKeepAliveIndex(Node<BundleEntry *> *node);
+    void EraseKeepAliveIndex(const Node<BundleEntry *> *node);
+    static uint32_t HashAbility(const char *bundleName, const char *abilityName);
+    bool ReserveAbilityIndex(const BundleInfo *bundleInfo);
+    void InsertAbilityIndex(Node<BundleEntry *> *node);
+    void EraseAbilityIndex(const Node<BundleEntry *> *node, const BundleInfo *bundleInfo);
+    static uint8_t CopyBundleInfos(const std::vector<Node<BundleEntry *> *> &nodes, BundleInfo **bundleInfos,
+        int32_t *len);
+
+    uint64_t generation_;
+    ChangeRecord changeRecords_[MAX_CHANGE_RECORD_NUM];
+    uint32_t nextChangeRecord_;
+    uint32_t numOfChangeRecord_;
+    // serves GetBundleNameForUid without walking or copying the bundle list
+    NodeIndex uidIndex_;
+    // bundles declaring each module metadata name, serves GetBundleInfosByMetaData without a full copy
+    std::map<std::string, std::vector<Node<BundleEntry *> *>> metaDataIndex_;
+    // keep-alive system bundles, started by ams while the system boots
+    std::vector<Node<BundleEntry *> *> keepAliveNodes_;
+    // every ability keyed by its bundle and ability name, resolves the ability of each start request in one probe
+    NodeIndex abilityIndex_;
+#else
+    enum SkillItemType : int32_t {
+        SKILL_ACTION = 0,
+        SKILL_ENTITY,
+    };
+
+    static uint32_t HashSkillItem(const char *item, int32_t type);
+    static const char *GetSkillItem(const AbilityInfo *abilityInfo, int32_t ordinal);
+    bool ReserveSkillIndex(const BundleInfo *bundleInfo);
+    void InsertSkillIndex(Node<BundleEntry *> *node);
+    void EraseSkillIndex(const Node<BundleEntry *> *node, const BundleInfo *bundleInfo);
+    void CollectSkillMatches(const char *item, int32_t type, List<BundleInfo *> &bundleInfos) const;
+    // posting lists from each skill action and entity to the bundles listing it, resolve implicit wants by lookup
+    NodeIndex skillIndex_;
+#endif
 
     DISALLOW_COPY_AND_MOVE(BundleMap);
 };
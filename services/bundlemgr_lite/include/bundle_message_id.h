@@ -32,6 +32,7 @@ enum BmsMsgType {
     // The above value is also for watch gt, don't change the order
 
     BUNDLE_CHANGE_CALLBACK,
+    BUNDLE_BATCH_INSTALLED,
 };
 
 #ifdef __cplusplus
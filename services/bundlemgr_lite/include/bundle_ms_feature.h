@@ -64,7 +64,12 @@ private:
     static uint8_t GetInnerBundleSize(const uint8_t funcId, IpcIo *req, IpcIo *reply);
     static uint8_t HandleGetBundleInfosByIndex(const uint8_t funcId, IpcIo *req, IpcIo *reply);
     static uint8_t HandleGetBundleInfosLength(const uint8_t funcId, IpcIo *req, IpcIo *reply);
+    static uint8_t HandleGetBundleInfosIfModified(const uint8_t funcId, IpcIo *req, IpcIo *reply);
+    static uint8_t HandleGetBundleInfosChangedSince(const uint8_t funcId, IpcIo *req, IpcIo *reply);
     static BundleInfo *GetInnerBundleInfos(IpcIo *req, IpcIo *reply, int32_t *length);
+    static bool ReadInnerBundleInfosParam(IpcIo *req, int32_t *codeFlag, int32_t *flag, char **metaDataKey);
+    static BundleInfo *QueryInnerBundleInfos(int32_t codeFlag, int32_t flag, const char *metaDataKey,
+        int32_t *length);
 
     Identity identity_;
     static BundleInvokeType BundleMsInvokeFuc[BMS_INNER_BEGIN];
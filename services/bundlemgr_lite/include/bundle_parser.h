@@ -19,6 +19,7 @@
 #include "adapter.h"
 #include "bundle_common.h"
 #include "bundle_info.h"
+#include "install_session.h"
 #include "stdint.h"
 
 #include <string>
@@ -32,9 +33,12 @@ public:
     ~BundleParser() = default;
 
     BundleInfo *ParseHapProfile(const char *path);
-    uint8_t ParseHapProfile(const std::string &path, Permissions &permissions, BundleRes &bundleRes,
+    uint8_t ParseHapProfile(InstallSession &session, Permissions &permissions, BundleRes &bundleRes,
         BundleInfo **bundleInfo);
     static int8_t ParseBundleParam(const char *path, char **bundleName, int32_t &versionCode);
+    static int8_t ParseBundleParam(InstallSession &session, char **bundleName, int32_t &versionCode);
+    // the permissions requested by the config.json of an extracted hap
+    static uint8_t ParseHapPermissions(const char *path, Permissions &permissions);
 private:
     static uint8_t ParseJsonInfo(const cJSON *appObject, const cJSON *configObject, const cJSON *moduleObject,
         BundleProfile &bundleProfile, BundleRes &bundleRes);
@@ -54,7 +54,8 @@ public:
     static char *Strscat(char *str[], uint32_t len);
     static void CreateRandStr(char *str, uint32_t len);
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    static cJSON *ConvertUidAndGidToJson(const InstallRecord &installRecord);
+    // adds all the records to the uid and gid map at once, so that a batch is stored with a single write
+    static cJSON *ConvertUidAndGidToJson(const std::vector<InstallRecord> &installRecords);
     static bool DeleteUidInfoFromJson(const char *bundleName);
 #else
     static bool MkDirs(const char *dir);
@@ -71,6 +72,7 @@ private:
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
     static cJSON *ObtainUidAndGidJson(bool flag);
     static bool AddUidAndGidInfo(const InstallRecord &installRecord, cJSON *size, cJSON *uids);
+    static bool HasUidAndGidInfo(const char *bundleName, cJSON *uids);
     static bool DeleteInnerUidInfoFromUidArray(const char *bundleName, cJSON *size, cJSON *uids);
 #else
     static char *GetRootDir(const char *dir, int32_t index);
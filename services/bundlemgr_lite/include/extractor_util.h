@@ -20,6 +20,7 @@
 #include "zip_file.h"
 
 #include <string>
+#include <sys/types.h>
 #include <vector>
 
 namespace OHOS {
@@ -30,9 +31,22 @@ public:
     bool Init();
     bool ExtractFileByName(const std::string &fileName, std::ostream &dest) const;
     const std::vector<std::string> &GetZipFileNames() const;
+    // the file is not synced, the caller flushes all the extracted files at once
     bool ExtractFileToPath(const std::string &filePath, const std::string &fileName) const;
+    uint64_t GetReadBytes() const;
+    // descriptor of the opened hap, -1 before Init() succeeded
+    int32_t GetFileDescriptor() const;
+    // appends length bytes at offset of srcFd to dstFd inside the kernel as far as the syscalls go, returns how many
+    static size_t CopyFileDataInKernel(int32_t srcFd, off_t offset, int32_t dstFd, size_t length);
+    // appends the rest of the range after its first copied bytes, from mappedData when the range is mapped
+    static bool CopyFileDataByRead(int32_t srcFd, off_t offset, int32_t dstFd, size_t length, size_t copied,
+        const Byte *mappedData);
 private:
+    bool CopyStoredFileToPath(const std::string &filePath, ZipPos offset, size_t length) const;
+
     ZipFile zipFile_;
+    // stored entries copied outside of zipFile_
+    mutable uint64_t copiedBytes_ { 0 };
     bool initial_ { false };
 };
 } // namespace OHOS
@@ -59,7 +59,7 @@ public:
     uint8_t GetBundleInfos(const int flags, BundleInfo **bundleInfos, int32_t *len);
     uint8_t GetBundleInfosNoReplication(const int flags, BundleInfo **bundleInfos, int32_t *len);
     void ScanPackages();
-    BundleInfo *QueryBundleInfo(const char *bundleName);
+    BundleInfoRef QueryBundleInfo(const char *bundleName);
     void RemoveBundleInfo(const char *bundleName);
     void AddBundleInfo(BundleInfo *info);
     bool UpdateBundleInfo(BundleInfo *info);
@@ -106,10 +106,6 @@ private:
     void FreePreAppInfo(const PreAppList *list);
     int32_t ReportHceInstallCallback(uint8_t errCode, uint8_t installState, uint8_t process);
     int32_t ReportHceUninstallCallback(uint8_t errCode, uint8_t installState, char *bundleName, uint8_t process);
-    static bool MatchSkills(const Want *want, Skill *const skills[]);
-    static bool isMatchActions(const char *actions, char *const skillActions[]);
-    static bool isMatchEntities(const char *entities, char *const skillEntities[]);
-    static bool isMatch(const char *dst, const char *src);
 
     GtBundleInstaller *installer_;
     BundleMap *bundleMap_;
@@ -25,8 +25,11 @@ extern "C" {
 }
 #endif
 
+#include "mutex_lock.h"
+#include "nocopyable.h"
 #include "stdint.h"
 
+#include <pthread.h>
 #include <string>
 #include <vector>
 
@@ -40,10 +43,35 @@ struct SignatureInfo {
 class HapSignVerify {
 public:
     static uint8_t VerifySignature(const std::string &hapFilepath, SignatureInfo &signatureInfo);
+    static int32_t SetDebugMode(bool enable);
 private:
     HapSignVerify() = default;
     ~HapSignVerify() = default;
     static uint8_t SwitchErrorCode(int32_t errorCode);
+
+    // the verify library keeps its mode and certificate state in globals and is not reentrant, haps verified on
+    // different threads are verified one after another, and the debug mode is not switched under a running verify
+    static Mutex verifyMutex_;
+};
+
+// runs VerifySignature on a thread of its own, so that the install can go on with the hap while it is hashed
+class HapSignVerifyTask {
+public:
+    explicit HapSignVerifyTask(const std::string &hapFilepath);
+    ~HapSignVerifyTask();
+
+    void Start();
+    uint8_t GetResult(SignatureInfo &signatureInfo);
+private:
+    static void *Run(void *arg);
+
+    std::string hapFilepath_;
+    SignatureInfo signatureInfo_;
+    uint8_t errorCode_;
+    pthread_t thread_;
+    bool isRunning_ { false };
+
+    DISALLOW_COPY_AND_MOVE(HapSignVerifyTask);
 };
 } // namespace OHOS
 #endif // OHOS_HAP_VERIFY_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_INSTALL_SCHEDULER_H
+#define OHOS_INSTALL_SCHEDULER_H
+
+#include <list>
+#include <pthread.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+typedef void (*InstallTaskHandler)(void *arg);
+
+// runs installs and uninstalls on a few worker threads instead of the bms service task, a task only waits for the
+// tasks submitted before it that install or uninstall one of its bundles
+class InstallScheduler {
+public:
+    static InstallScheduler &GetInstance()
+    {
+        // never destroyed, the detached workers may still wait on it or finish a task while the process exits
+        static InstallScheduler *instance = new InstallScheduler();
+        return *instance;
+    }
+
+    // the handler runs in place when the task can not be queued or no worker can be started
+    void Submit(const std::vector<std::string> &bundleNames, InstallTaskHandler handler, void *arg);
+
+private:
+    struct Task {
+        std::vector<std::string> bundleNames;
+        InstallTaskHandler handler;
+        void *arg;
+    };
+
+    InstallScheduler();
+    // the workers wait for tasks as long as the process runs
+    ~InstallScheduler() = default;
+    Task *TakeRunnableTask();
+    void FinishTask(Task *task);
+    static void *Run(void *arg);
+
+    std::list<Task *> tasks_;
+    std::set<std::string> busyBundleNames_;
+    uint32_t workerNum_;
+    uint32_t idleWorkerNum_;
+    pthread_mutex_t mutex_;
+    pthread_cond_t cond_;
+
+    DISALLOW_COPY_AND_MOVE(InstallScheduler);
+};
+} // namespace OHOS
+#endif // OHOS_INSTALL_SCHEDULER_H
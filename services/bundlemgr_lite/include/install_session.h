@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_INSTALL_SESSION_H
+#define OHOS_INSTALL_SESSION_H
+
+#include <string>
+#include <sys/stat.h>
+
+#include "extractor_util.h"
+#include "nocopyable.h"
+#include "stdint.h"
+
+namespace OHOS {
+// one hap opened for a whole install: its central directory is parsed and its config.json inflated once, then
+// shared by the param check, the profile parse and the installer instead of reopening the file at every step
+class InstallSession {
+public:
+    explicit InstallSession(const std::string &hapPath);
+    ~InstallSession() = default;
+
+    uint8_t Open();
+    const std::string &GetHapPath() const;
+    const std::string &GetProfile() const;
+    // the verifier and bundle_daemon open the hap again by its path, this tells whether the path still leads to the
+    // very file the session opened and whether that file is still the same, so that what they read is what was parsed
+    bool IsHapUnchanged() const;
+    // bytes of the hap read so far through the session, and the size of the hap it opened
+    uint64_t GetReadBytes() const;
+    int64_t GetHapSize() const;
+    // the dirs a new bundle is installed to, they depend on the hap and the install param of each install
+    void SetInstallDirPath(const std::string &codeDirPath, const std::string &dataDirPath);
+    const std::string &GetCodeDirPath() const;
+    const std::string &GetDataDirPath() const;
+
+private:
+    std::string hapPath_;
+    std::string codeDirPath_;
+    std::string dataDirPath_;
+    ExtractorUtil extractorUtil_;
+    std::string profile_;
+    // identity of the opened hap, taken from its descriptor
+    struct stat hapStat_ {};
+    uint8_t openResult_;
+    bool isOpened_ { false };
+
+    DISALLOW_COPY_AND_MOVE(InstallSession);
+};
+} // namespace OHOS
+#endif // OHOS_INSTALL_SESSION_H
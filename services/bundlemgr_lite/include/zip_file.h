@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 
+#include "nocopyable.h"
 #include "stdint.h"
 #include "unzip.h"
 
@@ -151,7 +152,16 @@ public:
     const ZipEntryMap &GetAllEntries() const;
     bool GetEntry(const std::string &entryName, ZipEntry &resultEntry) const;
     bool ExtractFile(const std::string &file, std::ostream &dest) const;
+    // zero-copy view of a stored entry inside the mapped zip, false when the entry is compressed or not mapped.
+    bool GetStoredEntryData(const std::string &file, const Byte *&data, size_t &length) const;
+    // data offset of a stored entry in the zip file, to copy it from GetFileDescriptor() without unzipping.
+    bool GetStoredEntryLocation(const std::string &file, ZipPos &offset, size_t &length) const;
+    int32_t GetFileDescriptor() const;
+    // length bytes at pos of the mapped zip, nullptr when the range is outside it or the zip is not mapped.
+    const Byte *GetMappedData(ZipPos pos, size_t length) const;
     const std::vector<std::string> &GetFileNames() const;
+    // bytes of the zip read so far, headers and entry data alike, whether through file_ or the mapping.
+    uint64_t GetReadBytes() const;
 
 private:
     bool CheckEndDir(const EndDir &endDir) const;
@@ -162,8 +172,10 @@ private:
     bool CheckCoherencyLocalHeader(const ZipEntry &zipEntry, uint16_t &extraSize) const;
     bool UnzipWithStore(const ZipEntry &zipEntry, const uint16_t extraSize, std::ostream &dest) const;
     bool UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSize, std::ostream &dest) const;
-    bool SeekToEntryStart(const ZipEntry &zipEntry, const uint16_t extraSize) const;
-    bool InitZStream(z_stream &zstream) const;
+    bool GetEntryStart(const ZipEntry &zipEntry, const uint16_t extraSize, ZipPos &startOffset) const;
+    bool ReadAt(ZipPos pos, void *buf, size_t length) const;
+    bool InitZStream() const;
+    void ReleaseZStream() const;
     bool ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &remainCompressedSize) const;
 
 private:
@@ -177,7 +189,18 @@ private:
     ZipPos fileLength_ = 0;
     // entryName vector
     std::vector<std::string> fileNames_;
+    // read only mapping of the whole zip, nullptr when the file is not mapped and reads go through file_.
+    Byte *mapAddr_ = nullptr;
+    size_t mapLength_ = 0;
+    // inflate state and buffers kept across entries, each extraction only resets them.
+    mutable z_stream zstream_ = {};
+    mutable BytePtr bufIn_ = nullptr;
+    mutable BytePtr bufOut_ = nullptr;
+    mutable bool zstreamReady_ = false;
+    mutable uint64_t readBytes_ = 0;
     bool isOpen_ = false;
+
+    DISALLOW_COPY_AND_MOVE(ZipFile);
 };
 } // namespace OHOS
 #endif // OHOS_BUNDLE_ZIP_FILE_H
\ No newline at end of file
@@ -20,13 +20,11 @@
 #include "appexecfwk_errors.h"
 #include "bundle_common.h"
 #include "bundle_util.h"
-#include "extractor_util.h"
 #include "bundle_log.h"
 
 namespace OHOS {
-uint8_t BundleExtractor::ExtractHapProfile(const std::string &hapFile, std::ostringstream &profileStream)
+uint8_t BundleExtractor::ExtractHapProfile(ExtractorUtil &extractorUtil, std::ostringstream &profileStream)
 {
-    ExtractorUtil extractorUtil(hapFile);
     if (!extractorUtil.Init()) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleExtractor ExtractHapProfile init fail");
         return ERR_APPEXECFWK_INSTALL_FAILED_EXTRACTOR_NOT_INIT;
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bundle_info_cursor.h"
+
+#include <ctime>
+
+#include "appexecfwk_errors.h"
+#include "bundle_info_utils.h"
+#include "bundle_log.h"
+#include "parcel_utils.h"
+
+namespace OHOS {
+namespace {
+// a snapshot not paged for this long is dropped, the client then falls back to a full query per index
+constexpr int64_t SNAPSHOT_TIMEOUT_MS = 10000;
+constexpr int64_t MS_PER_SECOND = 1000;
+constexpr int64_t NS_PER_MS = 1000000;
+}
+
+BundleInfoCursor::BundleInfoCursor() : nextToken_(0)
+{
+    for (int32_t i = 0; i < MAX_SNAPSHOT_NUM; i++) {
+        snapshots_[i] = { 0, 0, 0, nullptr, 0 };
+    }
+    pthread_mutex_init(&mutex_, nullptr);
+}
+
+BundleInfoCursor::~BundleInfoCursor()
+{
+    for (int32_t i = 0; i < MAX_SNAPSHOT_NUM; i++) {
+        FreeSnapshot(snapshots_[i]);
+    }
+    pthread_mutex_destroy(&mutex_);
+}
+
+int64_t BundleInfoCursor::GetCurrentTime()
+{
+    struct timespec ts = { 0, 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * MS_PER_SECOND + ts.tv_nsec / NS_PER_MS;
+}
+
+uint32_t BundleInfoCursor::Open(BundleInfo *bundleInfos, int32_t length, pid_t uid)
+{
+    if (bundleInfos == nullptr || length <= 0) {
+        return 0;
+    }
+    int64_t now = GetCurrentTime();
+    pthread_mutex_lock(&mutex_);
+    FreeExpiredSnapshots(now);
+    // reuse a free slot, or evict the least recently paged snapshot when all of them are in use
+    Snapshot *target = &snapshots_[0];
+    for (int32_t i = 0; i < MAX_SNAPSHOT_NUM; i++) {
+        if (snapshots_[i].bundleInfos == nullptr) {
+            target = &snapshots_[i];
+            break;
+        }
+        if (snapshots_[i].lastAccessTime < target->lastAccessTime) {
+            target = &snapshots_[i];
+        }
+    }
+    FreeSnapshot(*target);
+    if (++nextToken_ == 0) {
+        ++nextToken_;
+    }
+    *target = { nextToken_, uid, length, bundleInfos, now };
+    uint32_t token = nextToken_;
+    pthread_mutex_unlock(&mutex_);
+    return token;
+}
+
+uint8_t BundleInfoCursor::Marshalling(uint32_t token, pid_t uid, int32_t index, uint8_t **buff, uint32_t *size)
+{
+    if (buff == nullptr || size == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    int64_t now = GetCurrentTime();
+    pthread_mutex_lock(&mutex_);
+    FreeExpiredSnapshots(now);
+    Snapshot *snapshot = FindSnapshot(token);
+    if (snapshot == nullptr) {
+        pthread_mutex_unlock(&mutex_);
+        return ERR_APPEXECFWK_QUERY_NO_INFOS;
+    }
+    // tokens are easy to guess, another caller must neither read the snapshot nor end it with the last page
+    if (snapshot->uid != uid) {
+        pthread_mutex_unlock(&mutex_);
+        HILOG_WARN(HILOG_MODULE_APP, "BundleInfoCursor snapshot %{public}u paged by uid %{public}d", token, uid);
+        return ERR_APPEXECFWK_PERMISSION_DENIED;
+    }
+    if (index < 0 || index >= snapshot->length) {
+        pthread_mutex_unlock(&mutex_);
+        return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
+    }
+    snapshot->lastAccessTime = now;
+    *buff = ParcelUtils::MarshallingBundleInfos(snapshot->bundleInfos + index, 1, size);
+    // the last page ends the enumeration
+    if (index == snapshot->length - 1) {
+        FreeSnapshot(*snapshot);
+    }
+    pthread_mutex_unlock(&mutex_);
+    return (*buff == nullptr) ? ERR_APPEXECFWK_SERIALIZATION_FAILED : ERR_OK;
+}
+
+void BundleInfoCursor::Close(uint32_t token, pid_t uid)
+{
+    pthread_mutex_lock(&mutex_);
+    Snapshot *snapshot = FindSnapshot(token);
+    if (snapshot != nullptr && snapshot->uid == uid) {
+        FreeSnapshot(*snapshot);
+    }
+    pthread_mutex_unlock(&mutex_);
+}
+
+BundleInfoCursor::Snapshot *BundleInfoCursor::FindSnapshot(uint32_t token)
+{
+    if (token == 0) {
+        return nullptr;
+    }
+    for (int32_t i = 0; i < MAX_SNAPSHOT_NUM; i++) {
+        if (snapshots_[i].bundleInfos != nullptr && snapshots_[i].token == token) {
+            return &snapshots_[i];
+        }
+    }
+    return nullptr;
+}
+
+void BundleInfoCursor::FreeSnapshot(Snapshot &snapshot)
+{
+    if (snapshot.bundleInfos != nullptr) {
+        BundleInfoUtils::FreeBundleInfos(snapshot.bundleInfos, snapshot.length);
+    }
+    snapshot = { 0, 0, 0, nullptr, 0 };
+}
+
+void BundleInfoCursor::FreeExpiredSnapshots(int64_t now)
+{
+    for (int32_t i = 0; i < MAX_SNAPSHOT_NUM; i++) {
+        if (snapshots_[i].bundleInfos != nullptr && now - snapshots_[i].lastAccessTime > SNAPSHOT_TIMEOUT_MS) {
+            HILOG_WARN(HILOG_MODULE_APP, "BundleInfoCursor snapshot %{public}u expired", snapshots_[i].token);
+            FreeSnapshot(snapshots_[i]);
+        }
+    }
+}
+} // namespace OHOS
@@ -227,6 +227,99 @@ uint8_t BundleInnerFeature::UninstallInnerBundle(const uint8_t funcId, IpcIo *re
     return ERR_OK;
 }
 
+void ClearBatchInstallInfo(BatchInstallInfo *info)
+{
+    if (info == nullptr) {
+        return;
+    }
+    for (uint32_t i = 0; (info->paths != nullptr) && (i < info->pathNum); i++) {
+        AdapterFree(info->paths[i]);
+    }
+    AdapterFree(info->paths);
+    AdapterFree(info->svc);
+    info->pathNum = 0;
+}
+
+uint8_t BundleInnerFeature::GetBatchInstallInfo(BatchInstallInfo *info, IpcIo *req)
+{
+    uint32_t pathNum = 0;
+    if (!ReadUint32(req, &pathNum) || (pathNum == 0) || (pathNum > MAX_BATCH_INSTALL_NUM)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature batch install hap num is invalid");
+        return ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR;
+    }
+    info->paths = reinterpret_cast<char **>(AdapterMalloc(sizeof(char *) * pathNum));
+    if (info->paths == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature malloc paths failed");
+        return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+    }
+    info->pathNum = pathNum;
+    for (uint32_t i = 0; i < pathNum; i++) {
+        info->paths[i] = nullptr;
+    }
+    for (uint32_t i = 0; i < pathNum; i++) {
+        size_t length = 0;
+        char *reqPath = reinterpret_cast<char *>(ReadString(req, &length));
+        if (reqPath == nullptr) {
+            HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature deserialize path failed");
+            return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+        }
+        info->paths[i] = Utils::Strdup(reqPath);
+        if (info->paths[i] == nullptr) {
+            HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature malloc path failed");
+            return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+        }
+    }
+    SvcIdentity svc;
+    if (!(ReadRemoteObject(req, &svc))) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature deserialize serviceId failed");
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    info->svc = reinterpret_cast<SvcIdentity *>(AdapterMalloc(sizeof(SvcIdentity)));
+    if (info->svc == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature malloc serviceId failed");
+        return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+    }
+    *(info->svc) = svc;
+    ReadInt32(req, &(info->installLocation));
+    return ERR_OK;
+}
+
+uint8_t BundleInnerFeature::InstallInnerBundleBatch(const uint8_t funcId, IpcIo *req, IpcIo *reply)
+{
+    if ((req == nullptr) || (reply == nullptr)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS InstallInnerBundleBatch, request or reply is null");
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    BatchInstallInfo *info = reinterpret_cast<BatchInstallInfo *>(AdapterMalloc(sizeof(BatchInstallInfo)));
+    if (info == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS inner feature malloc batch install info failed");
+        return ERR_APPEXECFWK_SYSTEM_INTERNAL_ERROR;
+    }
+    info->paths = nullptr;
+    info->pathNum = 0;
+    info->svc = nullptr;
+    info->installLocation = 0;
+    uint8_t errorCode = GetBatchInstallInfo(info, req);
+    if (errorCode != ERR_OK) {
+        ClearBatchInstallInfo(info);
+        AdapterFree(info);
+        return errorCode;
+    }
+    Request request = {
+        .msgId = BUNDLE_BATCH_INSTALLED,
+        .len = static_cast<int16>(sizeof(BatchInstallInfo)),
+        .data = reinterpret_cast<void *>(info),
+        .msgValue = 0
+    };
+    int32 propRet = SAMGR_SendRequest(&(GetInstance()->identity_), &request, nullptr);
+    if (propRet != OHOS_SUCCESS) {
+        ClearBatchInstallInfo(info);
+        AdapterFree(info);
+        return ERR_APPEXECFWK_INSTALL_FAILED_SEND_REQUEST_ERROR;
+    }
+    return ERR_OK;
+}
+
 #ifdef OHOS_DEBUG
 uint8_t BundleInnerFeature::SetExternalInstallMode(const uint8_t funcId, IpcIo *req, IpcIo *reply)
 {
@@ -279,11 +372,13 @@ int32 BundleInnerFeature::Invoke(IServerProxy *iProxy, int funcId, void *origin,
     WriteUint8(reply, static_cast<uint8_t>(funcId));
     uint8_t ret = OHOS_SUCCESS;
 #ifdef OHOS_DEBUG
-    if ((funcId >= BMS_INNER_BEGIN) && (funcId < BMS_CMD_END)) {
+    if ((funcId >= BMS_INNER_BEGIN) && (funcId <= SET_SIGN_MODE)) {
 #else
     if ((funcId >= BMS_INNER_BEGIN) && (funcId <= UNINSTALL)) {
 #endif
         ret = BundleMsInvokeFuc[funcId - BMS_INNER_BEGIN](funcId, req, reply);
+    } else if (funcId == INSTALL_BATCH) {
+        ret = InstallInnerBundleBatch(funcId, req, reply);
     } else {
         ret = ERR_APPEXECFWK_COMMAND_ERROR;
     }
@@ -15,6 +15,7 @@
 
 #include "bundle_installer.h"
 
+#include <algorithm>
 #include <climits>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -38,6 +39,14 @@ const char DELIMITER[] = "_";
 const char APPID[] = "appId";
 #endif
 const uint8_t RAND_NUM = 16;
+const int32_t GET_BUNDLE_WITH_ABILITIES = 1;
+// a hap is extracted under this prefix in the code dir until its signature and version have been checked, bundle
+// names do not start with a dot, so the dir can not be taken for a bundle
+const char EXTRACT_DIR_PREFIX[] = ".extract_";
+// for the same reason the code of an installed version is kept aside under this prefix until its update is committed
+const char BACKUP_DIR_PREFIX[] = ".backup_";
+// the records an install replaces are kept under this suffix until it is committed
+const char BACKUP_SUFFIX[] = "_backup";
 
 BundleInstaller::BundleInstaller(const std::string &codeDirPath, const std::string &dataDirPath)
 {
@@ -53,40 +62,14 @@ BundleInstaller::~BundleInstaller()
     dataDirPath_.clear();
 }
 
-std::string BundleInstaller::GetCodeDirPath() const
+void BundleInstaller::ModifyInstallDirByHapType(const InstallParam &installParam, uint8_t hapType,
+    InstallSession &session)
 {
-    return codeDirPath_;
-}
-
-std::string BundleInstaller::GetDataDirPath() const
-{
-    return dataDirPath_;
-}
-
-void BundleInstaller::ModifyInstallDirByHapType(const InstallParam &installParam, uint8_t hapType)
-{
-    if (hapType != THIRD_APP_FLAG) {
-        dataDirPath_ = DATA_PATH;
-        codeDirPath_ = INSTALL_PATH;
-    } else if (ManagerService::GetInstance().IsExternalInstallMode() ||
-        installParam.installLocation == INSTALL_LOCATION_PREFER_EXTERNAL) {
-        dataDirPath_ = EXTEANAL_DATA_PATH;
-        codeDirPath_ = EXTEANAL_INSTALL_PATH;
+    if (hapType == THIRD_APP_FLAG && (ManagerService::GetInstance().IsExternalInstallMode() ||
+        installParam.installLocation == INSTALL_LOCATION_PREFER_EXTERNAL)) {
+        session.SetInstallDirPath(EXTEANAL_INSTALL_PATH, EXTEANAL_DATA_PATH);
     } else {
-        dataDirPath_ = DATA_PATH;
-        codeDirPath_ = INSTALL_PATH;
-    }
-}
-
-void BundleInstaller::RestoreInstallEnv(const InstallParam &installParam)
-{
-    if (ManagerService::GetInstance().IsExternalInstallMode()) {
-        return;
-    }
-
-    if (installParam.installLocation == INSTALL_LOCATION_PREFER_EXTERNAL) {
-        dataDirPath_ = DATA_PATH;
-        codeDirPath_ = INSTALL_PATH;
+        session.SetInstallDirPath(codeDirPath_, dataDirPath_);
     }
 }
 
@@ -103,7 +86,7 @@ uint8_t BundleInstaller::GetHapType(const char *path)
     return hapType;
 }
 
-uint8_t BundleInstaller::Install(const char *path, const InstallParam &installParam)
+uint8_t BundleInstaller::Install(const char *path, const InstallParam &installParam, InstallSession *session)
 {
     if (path == nullptr || installParam.installLocation < INSTALL_LOCATION_INTERNAL_ONLY ||
         installParam.installLocation > INSTALL_LOCATION_PREFER_EXTERNAL) {
@@ -126,124 +109,498 @@ uint8_t BundleInstaller::Install(const char *path, const InstallParam &installPa
         return ERR_APPEXECFWK_INSTALL_FAILED_FILE_PATH_INVALID;
     }
 
-    // set codeDirPath_ and dataDirPath_ according to hap path
+    // reuse the hap the caller has already opened to read the bundle name, otherwise open it here
+    InstallSession localSession(realPath);
+    InstallSession &installSession = (session != nullptr) ? *session : localSession;
+    // set the code and data dirs of this install according to hap path
     uint8_t hapType = GetHapType(realPath);
-    ModifyInstallDirByHapType(installParam, hapType);
-
-    InstallRecord installRecord = {
-        .bundleName = nullptr, .codePath = nullptr, .appId = nullptr, .versionCode = -1, .uid = INVALID_UID,
-        .gid = INVALID_GID
-    };
+    ModifyInstallDirByHapType(installParam, hapType, installSession);
+    return ProcessBundleInstall(realPath, installSession, randStr, hapType);
+}
 
-    uint8_t errorCode = ProcessBundleInstall(realPath, randStr, installRecord, hapType);
-    if (errorCode != ERR_OK) {
-        ManagerService::GetInstance().RecycleUid(installRecord.bundleName);
-        return errorCode;
+uint8_t BundleInstaller::InstallBatch(const std::vector<std::string> &paths, const InstallParam &installParam,
+    std::vector<std::string> &installedBundles, const std::vector<InstallSession *> *sessions)
+{
+    installedBundles.clear();
+    if (paths.empty() || (sessions != nullptr && sessions->size() != paths.size()) ||
+        installParam.installLocation < INSTALL_LOCATION_INTERNAL_ONLY ||
+        installParam.installLocation > INSTALL_LOCATION_PREFER_EXTERNAL) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR;
     }
 
-    std::string uidTmpJsonPath = std::string(JSON_PATH) + UID_GID_MAP + randStr + JSON_SUFFIX;
-    if (!BackUpUidAndGidInfo(installRecord, uidTmpJsonPath.c_str())) {
-        HILOG_ERROR(HILOG_MODULE_APP, "backup uid and gid info fail!");
-        BundleInfo *bundleInfo = ManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName);
-        CLEAR_INSTALL_ENV(bundleInfo);
-        return ERR_APPEXECFWK_INSTALL_FAILED_UID_AND_GID_BACKUP_ERROR;
+    std::vector<std::string> realPaths;
+    uint8_t hapType = 0;
+    for (const auto &path : paths) {
+        char realPath[PATH_MAX + 1] = { 0 };
+        if (path.size() > PATH_MAX || realpath(path.c_str(), realPath) == nullptr) {
+            return ERR_APPEXECFWK_INSTALL_FAILED_FILE_PATH_INVALID;
+        }
+        // code and data dirs are set once for the whole batch
+        uint8_t type = GetHapType(realPath);
+        if (!realPaths.empty() && type != hapType) {
+            HILOG_ERROR(HILOG_MODULE_APP, "haps of a batch are not installed to the same location!");
+            return ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR;
+        }
+        hapType = type;
+        realPaths.emplace_back(realPath);
     }
 
-    if (!RenameJsonFile(UID_GID_MAP, randStr) || !RenameJsonFile(installRecord.bundleName, randStr)) {
-        HILOG_ERROR(HILOG_MODULE_APP, "rename uid_gid_map json or record json fail!");
-        BundleInfo *bundleInfo = ManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName);
-        CLEAR_INSTALL_ENV(bundleInfo);
-        return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_FILE_ERROR;
+    char randStr[RAND_NUM] = { 0 };
+    BundleUtil::CreateRandStr(randStr, RAND_NUM);
+    if (strlen(randStr) == 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "create random str fail!");
+        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
     }
-
-    // if third system bundle, it need to record bundleName in THIRD_SYSTEM_BUNDLE_JSON
-    if (hapType == THIRD_SYSTEM_APP_FLAG && !CheckIsThirdSystemBundle(installRecord.bundleName)) {
-        RecordThirdSystemBundle(installRecord.bundleName, THIRD_SYSTEM_BUNDLE_JSON);
+    // two haps of a batch may carry the same bundle until both are parsed, so the temporary files of each hap take
+    // its index on top of the suffix of the batch
+    std::vector<PreparedBundle> bundles(realPaths.size());
+    for (size_t i = 0; i < bundles.size(); i++) {
+        bundles[i].randStr = randStr + std::to_string(i);
+    }
+
+    // the haps are prepared one after another, extraction goes through the one connection to bundle_daemon and
+    // verification takes the verifier lock anyway, what overlaps is the verification of a hap with its own parsing
+    // and extraction; nothing is committed unless every hap of the batch is valid
+    uint8_t errorCode = ERR_OK;
+    for (size_t i = 0; i < bundles.size() && errorCode == ERR_OK; i++) {
+        // reuse the hap the caller has already opened to read the bundle name, otherwise open it here
+        InstallSession localSession(realPaths[i]);
+        InstallSession &session = (sessions != nullptr && (*sessions)[i] != nullptr) ? *(*sessions)[i] : localSession;
+        ModifyInstallDirByHapType(installParam, hapType, session);
+        errorCode = PrepareBundleInstall(realPaths[i], session, bundles[i]);
+        if (errorCode != ERR_OK) {
+            // the failed step has freed the bundle info
+            bundles[i].bundleInfo = nullptr;
+            break;
+        }
+        for (size_t j = 0; j < i && errorCode == ERR_OK; j++) {
+            if (strcmp(bundles[i].installRecord.bundleName, bundles[j].installRecord.bundleName) == 0) {
+                HILOG_ERROR(HILOG_MODULE_APP, "%{public}s is installed twice in a batch!",
+                    bundles[i].installRecord.bundleName);
+                errorCode = ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR;
+            }
+        }
     }
 
-    RestoreInstallEnv(installParam);
+    if (errorCode != ERR_OK) {
+        for (auto &bundle : bundles) {
+            AbortBundleInstall(bundle);
+        }
+        return errorCode;
+    }
+    errorCode = CommitBundles(bundles, randStr, hapType);
+    if (errorCode != ERR_OK) {
+        return errorCode;
+    }
+    for (const auto &bundle : bundles) {
+        installedBundles.emplace_back(bundle.bundleName);
+    }
     return ERR_OK;
 }
 
-uint8_t BundleInstaller::ProcessBundleInstall(const std::string &path, const char *randStr,
-    InstallRecord &installRecord, uint8_t hapType)
+uint8_t BundleInstaller::ProcessBundleInstall(const std::string &path, InstallSession &session, const char *randStr,
+    uint8_t hapType)
+{
+    std::vector<PreparedBundle> bundles(1);
+    bundles[0].randStr = randStr;
+    uint8_t errorCode = PrepareBundleInstall(path, session, bundles[0]);
+    if (errorCode != ERR_OK) {
+        return errorCode;
+    }
+    return CommitBundles(bundles, randStr, hapType);
+}
+
+uint8_t BundleInstaller::PrepareBundleInstall(const std::string &path, InstallSession &session, PreparedBundle &bundle)
 {
-    BundleInfo *bundleInfo = nullptr;
-    Permissions permissions = {.permNum = 0, .permissionTrans = nullptr};
-    BundleRes bundleRes = {
-        .bundleName = nullptr, .moduleDescriptionId = 0, .abilityRes = nullptr, .totalNumOfAbilityRes = 0
-    };
+    BundleInfo *&bundleInfo = bundle.bundleInfo;
+    Permissions &permissions = bundle.permissions;
+    BundleRes &bundleRes = bundle.bundleRes;
+    InstallRecord &installRecord = bundle.installRecord;
     // check path
     uint8_t errorCode = CheckInstallFileIsValid(const_cast<char *>(path.c_str()));
     CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
-    // verify signature
-    SignatureInfo signatureInfo;
+    // verify signature on its own thread while config.json is parsed and the hap is extracted
+    bool isSignMode = true;
 #ifdef OHOS_DEBUG
-    if (ManagerService::GetInstance().IsSignMode()) {
-        errorCode = HapSignVerify::VerifySignature(path, signatureInfo);
-        CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
-    }
-#else
-    errorCode = HapSignVerify::VerifySignature(path, signatureInfo);
-    CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+    isSignMode = ManagerService::GetInstance().IsSignMode();
 #endif
+    HapSignVerifyTask verifyTask(path);
+    if (isSignMode) {
+        verifyTask.Start();
+    }
+    SignatureInfo signatureInfo;
     // parse config.json
     BundleParser bundleParser;
-    errorCode = bundleParser.ParseHapProfile(path, permissions, bundleRes, &bundleInfo);
+    errorCode = bundleParser.ParseHapProfile(session, permissions, bundleRes, &bundleInfo);
+    // the code path is only known once the signature is, so the hap is extracted to a dir of its own meanwhile
+    std::string extractPath;
+    if (errorCode == ERR_OK) {
+        extractPath = session.GetCodeDirPath() + PATH_SEPARATOR + EXTRACT_DIR_PREFIX + bundleInfo->bundleName +
+            bundle.randStr;
+        errorCode = (BundleDaemonClient::GetInstance().ExtractHap(path.c_str(), extractPath.c_str()) ==
+            EC_SUCCESS) ? ERR_OK : ERR_APPEXECFWK_INSTALL_FAILED_EXTRACT_HAP_ERROR;
+    }
+    // a signature error is still reported first, as when the hap was verified before anything else
+    if (isSignMode) {
+        uint8_t verifyCode = verifyTask.GetResult(signatureInfo);
+        errorCode = (verifyCode != ERR_OK) ? verifyCode : errorCode;
+    }
+    // the verifier digests the whole hap, bundle_daemon logs what the extraction read on its side
+    unsigned long long profileBytes = static_cast<unsigned long long>(session.GetReadBytes());
+    unsigned long long verifyBytes = isSignMode ? static_cast<unsigned long long>(session.GetHapSize()) : 0;
+    HILOG_INFO(HILOG_MODULE_APP, "read %{public}llu bytes of a %{public}lld bytes hap in bms, %{public}llu for the "
+        "profile and %{public}llu for the signature", profileBytes + verifyBytes,
+        static_cast<long long>(session.GetHapSize()), profileBytes, verifyBytes);
+    CHECK_PRO_PART_ROLLBACK(errorCode, extractPath, permissions, bundleInfo, bundleRes.abilityRes);
     CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
-#ifdef OHOS_DEBUG
-    // check signatureInfo
-    if (ManagerService::GetInstance().IsSignMode()) {
+    if (isSignMode) {
+        // check signatureInfo
         errorCode = CheckProvisionInfoIsValid(signatureInfo, permissions, bundleInfo->bundleName);
-        CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+        CHECK_PRO_PART_ROLLBACK(errorCode, extractPath, permissions, bundleInfo, bundleRes.abilityRes);
         // check version and signature when in update status
         errorCode = ReshapeAppId(bundleInfo->bundleName, signatureInfo.appId);
-        CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+        CHECK_PRO_PART_ROLLBACK(errorCode, extractPath, permissions, bundleInfo, bundleRes.abilityRes);
         bundleInfo->appId = Utils::Strdup(signatureInfo.appId.c_str());
-    } else {
+    }
+#ifdef OHOS_DEBUG
+    if (!isSignMode) {
         bundleInfo->appId = Utils::Strdup(APPID);
     }
-#else
-    errorCode = CheckProvisionInfoIsValid(signatureInfo, permissions, bundleInfo->bundleName);
-    CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
-    // check version and signature when in update status
-    errorCode = ReshapeAppId(bundleInfo->bundleName, signatureInfo.appId);
-        CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
-    bundleInfo->appId = Utils::Strdup(signatureInfo.appId.c_str());
 #endif
     errorCode = (bundleInfo->appId == nullptr) ? ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR : ERR_OK;
-    CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
+    CHECK_PRO_PART_ROLLBACK(errorCode, extractPath, permissions, bundleInfo, bundleRes.abilityRes);
+    // an update takes over the installed code path, so the paths below are only taken after this check
+    errorCode = CheckVersionAndSignature(bundleInfo->bundleName, bundleInfo);
+    CHECK_PRO_PART_ROLLBACK(errorCode, extractPath, permissions, bundleInfo, bundleRes.abilityRes);
     installRecord.bundleName = bundleInfo->bundleName;
     installRecord.appId = bundleInfo->appId;
     installRecord.versionCode = bundleInfo->versionCode;
-    errorCode = CheckVersionAndSignature(installRecord.bundleName, bundleInfo);
-    CHECK_PRO_RESULT(errorCode, bundleInfo, permissions, bundleRes.abilityRes);
-    std::string codePath = std::string(bundleInfo->codePath) + PATH_SEPARATOR + bundleInfo->moduleInfos[0].moduleName;
     installRecord.codePath = bundleInfo->codePath;
-    // unzip bundle
-    std::string tmpCodePath = codePath + randStr;
-    errorCode = (BundleDaemonClient::GetInstance().ExtractHap(path.c_str(), tmpCodePath.c_str()) == EC_SUCCESS) ?
+    bundle.bundleName = bundleInfo->bundleName;
+    bundle.bundlePath = bundleInfo->codePath;
+    bundle.dataPath = bundleInfo->dataPath;
+    bundle.codePath = bundle.bundlePath + PATH_SEPARATOR + bundleInfo->moduleInfos[0].moduleName;
+    bundle.backupCodePath = bundle.bundlePath.substr(0, bundle.bundlePath.find_last_of(PATH_SEPARATOR)) +
+        PATH_SEPARATOR + BACKUP_DIR_PREFIX + bundle.bundleName + bundle.randStr;
+    // move the extracted hap next to the code path
+    std::string tmpCodePath = bundle.codePath + bundle.randStr;
+    errorCode = MoveExtractedHap(path, extractPath, tmpCodePath);
+    // the signature and the extracted files only belong to the parsed profile if the hap was not swapped meanwhile
+    if (errorCode == ERR_OK && !session.IsHapUnchanged()) {
+        HILOG_ERROR(HILOG_MODULE_APP, "hap changed during install!");
+        errorCode = ERR_APPEXECFWK_INSTALL_FAILED_BAD_FILE;
+    }
+    if (errorCode != ERR_OK) {
+        AbortBundleInstall(bundle);
+    }
+    return errorCode;
+}
+
+uint8_t BundleInstaller::MoveExtractedHap(const std::string &path, const std::string &extractPath,
+    const std::string &tmpCodePath)
+{
+    if (BundleDaemonClient::GetInstance().RenameFile(extractPath.c_str(), tmpCodePath.c_str()) == EC_SUCCESS) {
+        return ERR_OK;
+    }
+    // an update installed on the other storage can not be renamed to, it is extracted there again
+    HILOG_WARN(HILOG_MODULE_APP, "rename extracted hap fail, extract it to the code path");
+    BundleDaemonClient::GetInstance().RemoveFile(extractPath.c_str());
+    return (BundleDaemonClient::GetInstance().ExtractHap(path.c_str(), tmpCodePath.c_str()) == EC_SUCCESS) ?
         ERR_OK : ERR_APPEXECFWK_INSTALL_FAILED_EXTRACT_HAP_ERROR;
-    CHECK_PRO_PART_ROLLBACK(errorCode, tmpCodePath, permissions, bundleInfo, bundleRes.abilityRes);
-    // rename install path and record install infomation
-    bool isUpdate = ManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName) != nullptr;
-    errorCode = HandleFileAndBackUpRecord(codePath.c_str(), randStr, installRecord, isUpdate, hapType);
-    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes, randStr);
+}
+
+void BundleInstaller::AbortBundleInstall(PreparedBundle &bundle)
+{
+    if (bundle.bundleInfo == nullptr) {
+        return;
+    }
+    // the dir of a bundle that is not installed yet was only created to hold the extracted hap
+    std::string tmpCodePath = bundle.codePath + bundle.randStr;
+    bool isInstalled = ManagerService::GetInstance().QueryBundleInfo(bundle.bundleName.c_str()) != nullptr;
+    BundleDaemonClient::GetInstance().RemoveFile(isInstalled ? tmpCodePath.c_str() : bundle.bundlePath.c_str());
+    ReleaseBundle(bundle);
+}
+
+uint8_t BundleInstaller::CommitBundles(std::vector<PreparedBundle> &bundles, const char *randStr, uint8_t hapType)
+{
+    Lock<Mutex> lock(commitMutex_);
+    // every bundle is moved in place with its installed version kept aside, then the records are renamed and the
+    // bundle infos published, the uid map is written last; a failed step puts every bundle of the batch back
+    uint8_t errorCode = ERR_OK;
+    for (size_t i = 0; i < bundles.size() && errorCode == ERR_OK; i++) {
+        errorCode = StageBundle(bundles[i], hapType);
+    }
+    for (size_t i = 0; i < bundles.size() && errorCode == ERR_OK; i++) {
+        errorCode = CommitInstallRecord(bundles[i]);
+    }
+    for (size_t i = 0; i < bundles.size() && errorCode == ERR_OK; i++) {
+        errorCode = PublishBundle(bundles[i]);
+    }
+    if (errorCode == ERR_OK) {
+        errorCode = CommitUidAndGidInfo(bundles, randStr);
+    }
+    if (errorCode != ERR_OK) {
+        for (auto it = bundles.rbegin(); it != bundles.rend(); ++it) {
+            RollbackBundle(*it);
+        }
+        return errorCode;
+    }
+    for (auto &bundle : bundles) {
+        FinishBundle(bundle, hapType);
+    }
+    return ERR_OK;
+}
+
+uint8_t BundleInstaller::StageBundle(PreparedBundle &bundle, uint8_t hapType)
+{
+    BundleInfo *bundleInfo = bundle.bundleInfo;
+    InstallRecord &installRecord = bundle.installRecord;
+    // get ams interface
+    AmsInnerInterface *amsInterface = nullptr;
+    if (!ManagerService::GetAmsInterface(&amsInterface) || amsInterface == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "get ams interface fail when install!");
+        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
+    }
+    // kill app process
+    amsInterface->TerminateApp(installRecord.bundleName);
+    // from here on a rollback tells an update from a new install, which it has to remove entirely
+    bundle.isStaged = true;
+    uint8_t errorCode = BackUpInstalledVersion(bundle);
+    if (errorCode != ERR_OK) {
+        return errorCode;
+    }
+    std::string tmpCodePath = bundle.codePath + bundle.randStr;
+    if (BundleDaemonClient::GetInstance().RenameFile(tmpCodePath.c_str(), bundle.codePath.c_str()) != EC_SUCCESS) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_DIR_ERROR;
+    }
+    bundle.isCodeMoved = true;
+
+    if (!bundle.isUpdate) {
+        // distribute uid for installing application
+        installRecord.uid = ManagerService::GetInstance().GenerateUid(installRecord.bundleName, hapType);
+        installRecord.gid = installRecord.uid;
+        bundle.isUidGenerated = (installRecord.uid != INVALID_UID);
+        bool isChown = ((installRecord.uid != INVALID_UID) && (installRecord.gid != INVALID_GID));
+        // the data a former uninstall has kept is kept by a rollback as well
+        bool hasDataDir = BundleUtil::IsDir(bundle.dataPath.c_str());
+        if (BundleDaemonClient::GetInstance().CreateDataDirectory(bundle.dataPath.c_str(), installRecord.uid,
+            installRecord.gid, isChown) != EC_SUCCESS) {
+            HILOG_ERROR(HILOG_MODULE_APP, "Create data directory fail");
+            return ERR_APPEXECFWK_INSTALL_FAILED_CREATE_DATA_DIR_ERROR;
+        }
+        bundle.isDataDirCreated = !hasDataDir;
+        bundleInfo->isSystemApp = (hapType == SYSTEM_APP_FLAG);
+    } else {
+        bundleInfo->isSystemApp = bundle.oldBundleInfo->isSystemApp;
+    }
     bundleInfo->uid = installRecord.uid;
     bundleInfo->gid = installRecord.uid;
-    // store permissions
-    errorCode = StorePermissions(installRecord.bundleName, permissions.permissionTrans, permissions.permNum,
-        isUpdate);
-    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes, randStr);
-    // update bundle Info
-    errorCode = UpdateBundleInfo(installRecord.appId, bundleRes, bundleInfo, isUpdate, hapType);
-    CHECK_PRO_ROLLBACK(errorCode, permissions, bundleInfo, bundleRes.abilityRes, randStr);
-    // free permissions
-    AdapterFree(permissions.permissionTrans);
-    AdapterFree(bundleRes.abilityRes);
+    std::string bundleTmpJsonPath = std::string(JSON_PATH) + bundle.bundleName + bundle.randStr + JSON_SUFFIX;
+    if (!BackUpInstallRecord(installRecord, bundleTmpJsonPath.c_str())) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_RECORD_INFO_ERROR;
+    }
+    // store permissions, a failed store may have changed them already
+    bundle.isPermissionStored = true;
+    errorCode = StorePermissions(installRecord.bundleName, bundle.permissions.permissionTrans,
+        bundle.permissions.permNum, bundle.isUpdate);
+    if (errorCode != ERR_OK) {
+        return errorCode;
+    }
+    return BundleResTransform::ConvertResInfoToBundleInfo(bundleInfo->codePath, bundle.bundleRes, bundleInfo);
+}
+
+uint8_t BundleInstaller::BackUpInstalledVersion(PreparedBundle &bundle)
+{
+    BundleInfoRef oldBundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundle.bundleName.c_str());
+    bundle.isUpdate = (oldBundleInfo != nullptr);
+    if (!bundle.isUpdate) {
+        return ERR_OK;
+    }
+    bundle.installRecord.uid = oldBundleInfo->uid;
+    bundle.installRecord.gid = oldBundleInfo->gid;
+    bundle.oldBundleInfo = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo)));
+    if (bundle.oldBundleInfo == nullptr ||
+        memset_s(bundle.oldBundleInfo, sizeof(BundleInfo), 0, sizeof(BundleInfo)) != EOK) {
+        HILOG_ERROR(HILOG_MODULE_APP, "malloc bundleInfo fail when back up the installed version!");
+        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
+    }
+    BundleInfoUtils::CopyBundleInfo(GET_BUNDLE_WITH_ABILITIES, bundle.oldBundleInfo, *(oldBundleInfo.Get()));
+    if (bundle.oldBundleInfo->bundleName == nullptr || bundle.oldBundleInfo->numOfModule == 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "copy bundleInfo fail when back up the installed version!");
+        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
+    }
+    bundle.oldProfilePath = bundle.bundlePath + PATH_SEPARATOR + bundle.oldBundleInfo->moduleInfos[0].moduleName;
+    if (!BundleUtil::IsDir(bundle.codePath.c_str())) {
+        return ERR_OK;
+    }
+    if (BundleDaemonClient::GetInstance().RenameFile(bundle.codePath.c_str(), bundle.backupCodePath.c_str()) !=
+        EC_SUCCESS) {
+        HILOG_ERROR(HILOG_MODULE_APP, "back up the code of %{public}s fail!", bundle.bundleName.c_str());
+        return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_DIR_ERROR;
+    }
+    bundle.hasBackUpCode = true;
+    if (bundle.oldProfilePath == bundle.codePath) {
+        bundle.oldProfilePath = bundle.backupCodePath;
+    }
+    return ERR_OK;
+}
+
+uint8_t BundleInstaller::CommitInstallRecord(PreparedBundle &bundle)
+{
+    const char *bundleName = bundle.bundleName.c_str();
+    const char *randStr = bundle.randStr.c_str();
+    std::string jsonPath = std::string(JSON_PATH) + bundleName + JSON_SUFFIX;
+    if (bundle.isUpdate && BundleUtil::IsFile(jsonPath.c_str())) {
+        if (!BackUpJsonFile(bundleName, randStr)) {
+            HILOG_ERROR(HILOG_MODULE_APP, "back up record json of %{public}s fail!", bundleName);
+            return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_FILE_ERROR;
+        }
+        bundle.hasBackUpRecord = true;
+    }
+    if (!RenameJsonFile(bundleName, randStr)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "rename record json of %{public}s fail!", bundleName);
+        return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_FILE_ERROR;
+    }
+    bundle.isRecordRenamed = true;
+    return ERR_OK;
+}
+
+uint8_t BundleInstaller::PublishBundle(PreparedBundle &bundle)
+{
+    if (!ManagerService::GetInstance().UpdateBundleInfo(bundle.bundleInfo)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "publish bundleInfo of %{public}s fail!", bundle.bundleName.c_str());
+        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
+    }
+    // the bundle info is owned by the bundle map now
+    bundle.bundleInfo = nullptr;
+    bundle.isPublished = true;
+    return ERR_OK;
+}
+
+uint8_t BundleInstaller::CommitUidAndGidInfo(const std::vector<PreparedBundle> &bundles, const char *randStr)
+{
+    std::vector<InstallRecord> records;
+    for (const auto &bundle : bundles) {
+        InstallRecord record = bundle.installRecord;
+        record.bundleName = const_cast<char *>(bundle.bundleName.c_str());
+        record.codePath = nullptr;
+        record.appId = nullptr;
+        records.emplace_back(record);
+    }
+    // the uid and gid map is stored and renamed once for the whole batch
+    std::string uidTmpJsonPath = std::string(JSON_PATH) + UID_GID_MAP + randStr + JSON_SUFFIX;
+    if (!BackUpUidAndGidInfo(records, uidTmpJsonPath.c_str())) {
+        HILOG_ERROR(HILOG_MODULE_APP, "backup uid and gid info fail!");
+        BundleUtil::DeleteJsonFile(UID_GID_MAP, randStr);
+        return ERR_APPEXECFWK_INSTALL_FAILED_UID_AND_GID_BACKUP_ERROR;
+    }
+    std::string uidJsonPath = std::string(JSON_PATH) + UID_GID_MAP + JSON_SUFFIX;
+    bool hasBackUp = BundleUtil::IsFile(uidJsonPath.c_str());
+    if ((hasBackUp && !BackUpJsonFile(UID_GID_MAP, randStr)) || !RenameJsonFile(UID_GID_MAP, randStr)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "rename uid_gid_map json fail!");
+        BundleUtil::DeleteJsonFile(UID_GID_MAP, randStr);
+        if (hasBackUp && !RestoreJsonFile(UID_GID_MAP, randStr)) {
+            HILOG_ERROR(HILOG_MODULE_APP, "restore uid_gid_map json fail!");
+        }
+        return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_FILE_ERROR;
+    }
+    if (hasBackUp) {
+        RemoveBackUpJsonFile(UID_GID_MAP, randStr);
+    }
     return ERR_OK;
 }
 
+void BundleInstaller::FinishBundle(PreparedBundle &bundle, uint8_t hapType)
+{
+    if (bundle.hasBackUpCode) {
+        BundleDaemonClient::GetInstance().RemoveFile(bundle.backupCodePath.c_str());
+    }
+    if (bundle.hasBackUpRecord) {
+        RemoveBackUpJsonFile(bundle.bundleName.c_str(), bundle.randStr.c_str());
+    }
+    // if third system bundle, it need to record bundleName in THIRD_SYSTEM_BUNDLE_JSON
+    if (hapType == THIRD_SYSTEM_APP_FLAG && !CheckIsThirdSystemBundle(bundle.bundleName.c_str())) {
+        RecordThirdSystemBundle(bundle.bundleName.c_str(), THIRD_SYSTEM_BUNDLE_JSON);
+    }
+    ReleaseBundle(bundle);
+}
+
+void BundleInstaller::RollbackBundle(PreparedBundle &bundle)
+{
+    if (!bundle.isStaged) {
+        AbortBundleInstall(bundle);
+        return;
+    }
+    const char *bundleName = bundle.bundleName.c_str();
+    const char *randStr = bundle.randStr.c_str();
+    if (bundle.isPublished) {
+        if (bundle.oldBundleInfo != nullptr && ManagerService::GetInstance().UpdateBundleInfo(bundle.oldBundleInfo)) {
+            // the installed version is owned by the bundle map again
+            bundle.oldBundleInfo = nullptr;
+        } else {
+            if (bundle.oldBundleInfo != nullptr) {
+                HILOG_ERROR(HILOG_MODULE_APP, "put back bundleInfo of %{public}s fail!", bundleName);
+            }
+            ManagerService::GetInstance().RemoveBundleInfo(bundleName);
+        }
+    }
+    BundleUtil::DeleteJsonFile(bundleName, randStr);
+    if (bundle.hasBackUpRecord) {
+        if (!RestoreJsonFile(bundleName, randStr)) {
+            HILOG_ERROR(HILOG_MODULE_APP, "restore record json of %{public}s fail!", bundleName);
+        }
+    } else if (bundle.isRecordRenamed) {
+        std::string jsonPath = std::string(JSON_PATH) + bundleName + JSON_SUFFIX;
+        BundleDaemonClient::GetInstance().RemoveFile(jsonPath.c_str());
+    }
+    if (bundle.isPermissionStored) {
+        if (bundle.isUpdate) {
+            RestorePermissions(bundle);
+        } else {
+            DeletePermissions(bundleName);
+        }
+    }
+    if (bundle.isUidGenerated) {
+        ManagerService::GetInstance().RecycleUid(bundleName);
+    }
+    if (!bundle.isUpdate) {
+        // the bundle dir holds nothing but what this install has put there
+        BundleDaemonClient::GetInstance().RemoveInstallDirectory(bundle.bundlePath.c_str(), bundle.dataPath.c_str(),
+            !bundle.isDataDirCreated);
+    } else {
+        std::string tmpCodePath = bundle.codePath + randStr;
+        BundleDaemonClient::GetInstance().RemoveFile(bundle.isCodeMoved ? bundle.codePath.c_str() :
+            tmpCodePath.c_str());
+        if (bundle.hasBackUpCode && BundleDaemonClient::GetInstance().RenameFile(bundle.backupCodePath.c_str(),
+            bundle.codePath.c_str()) != EC_SUCCESS) {
+            HILOG_ERROR(HILOG_MODULE_APP, "restore the code of %{public}s fail!", bundleName);
+        }
+    }
+    ReleaseBundle(bundle);
+}
+
+void BundleInstaller::RestorePermissions(const PreparedBundle &bundle)
+{
+    // a permission the update has dropped comes back as requested, its grant is not kept
+    Permissions permissions = { .permNum = 0, .permissionTrans = nullptr };
+    if (BundleParser::ParseHapPermissions(bundle.oldProfilePath.c_str(), permissions) != ERR_OK ||
+        StorePermissions(bundle.bundleName.c_str(), permissions.permissionTrans, permissions.permNum, true) !=
+        ERR_OK) {
+        HILOG_ERROR(HILOG_MODULE_APP, "restore permissions of %{public}s fail!", bundle.bundleName.c_str());
+    }
+    AdapterFree(permissions.permissionTrans);
+}
+
+void BundleInstaller::ReleaseBundle(PreparedBundle &bundle)
+{
+    BundleInfoUtils::FreeBundleInfo(bundle.bundleInfo);
+    bundle.bundleInfo = nullptr;
+    BundleInfoUtils::FreeBundleInfo(bundle.oldBundleInfo);
+    bundle.oldBundleInfo = nullptr;
+    AdapterFree(bundle.permissions.permissionTrans);
+    AdapterFree(bundle.bundleRes.abilityRes);
+}
+
 uint8_t BundleInstaller::ReshapeAppId(const char *bundleName, std::string &appId)
 {
     if (bundleName == nullptr) {
@@ -342,93 +699,13 @@ bool BundleInstaller::MatchPermissions(const std::vector<std::string> & restrict
     return true;
 }
 
-uint8_t BundleInstaller::HandleFileAndBackUpRecord(const char *codePath, const char *randStr, InstallRecord &record,
-    bool isUpdate, uint8_t hapType)
-{
-    if (codePath == nullptr || randStr == nullptr) {
-        HILOG_ERROR(HILOG_MODULE_APP, "param is nullptr!");
-        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
-    }
-    // get ams interface
-    AmsInnerInterface *amsInterface = nullptr;
-    if (!ManagerService::GetAmsInterface(&amsInterface) || amsInterface == nullptr) {
-        HILOG_ERROR(HILOG_MODULE_APP, "get ams interface fail when install!");
-        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
-    }
-    // kill app process
-    amsInterface->TerminateApp(record.bundleName);
-    std::string tmpPath = std::string(codePath) + randStr;
-    if (BundleDaemonClient::GetInstance().RenameFile(tmpPath.c_str(), codePath) != EC_SUCCESS) {
-        BundleDaemonClient::GetInstance().RemoveFile(tmpPath.c_str());
-        return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_DIR_ERROR;
-    }
-
-    if (!isUpdate) {
-        // distribute uid for installing application
-        record.uid = ManagerService::GetInstance().GenerateUid(record.bundleName, hapType);
-        record.gid = record.uid;
-        bool isChown = ((record.uid != INVALID_UID) && (record.gid != INVALID_GID));
-        std::string dataPath = dataDirPath_ + PATH_SEPARATOR + record.bundleName;
-        if (BundleDaemonClient::GetInstance().CreateDataDirectory(
-            dataPath.c_str(), record.uid, record.gid, isChown) != EC_SUCCESS) {
-            HILOG_ERROR(HILOG_MODULE_APP, "Create data directory fail");
-            return ERR_APPEXECFWK_INSTALL_FAILED_CREATE_DATA_DIR_ERROR;
-        }
-    } else {
-        BundleInfo *bundleInfo = ManagerService::GetInstance().QueryBundleInfo(record.bundleName);
-        if (bundleInfo == nullptr) {
-            HILOG_ERROR(HILOG_MODULE_APP, "bundleInfo is nullptr when query bundleInfo!");
-            return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
-        }
-        record.uid = bundleInfo->uid;
-        record.gid = bundleInfo->gid;
-    }
-    std::string bundleTmpJsonPath = std::string(JSON_PATH) + record.bundleName + randStr + JSON_SUFFIX;
-    if (!BackUpInstallRecord(record, bundleTmpJsonPath.c_str())) {
-        return ERR_APPEXECFWK_INSTALL_FAILED_RECORD_INFO_ERROR;
-    }
-    return ERR_OK;
-}
-
-uint8_t BundleInstaller::UpdateBundleInfo(const char *appId, const BundleRes &bundleRes, BundleInfo *bundleInfo,
-    bool isUpdate, uint8_t hapType)
-{
-    if ((appId == nullptr) || (bundleInfo == nullptr)) {
-        return ERR_APPEXECFWK_OBJECT_NULL;
-    }
-    uint8_t errorCode = BundleResTransform::ConvertResInfoToBundleInfo(bundleInfo->codePath, bundleRes, bundleInfo);
-    if (errorCode != ERR_OK) {
-        return errorCode;
-    }
-    if (!isUpdate) {
-        bundleInfo->isSystemApp = (hapType == SYSTEM_APP_FLAG);
-    } else {
-        BundleInfo *oldBundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundleInfo->bundleName);
-        if (oldBundleInfo == nullptr) {
-            HILOG_ERROR(HILOG_MODULE_APP, "query bundleInfo which is exists fail!");
-            return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
-        }
-        bundleInfo->isSystemApp = oldBundleInfo->isSystemApp;
-    }
-    bundleInfo->appId = Utils::Strdup(appId);
-    if (bundleInfo->appId == nullptr) {
-        HILOG_ERROR(HILOG_MODULE_APP, "add appId to bundleInfo fail!");
-        ManagerService::GetInstance().RemoveBundleInfo(bundleInfo->bundleName);
-        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
-    }
-    if (!ManagerService::GetInstance().UpdateBundleInfo(bundleInfo)) {
-        return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
-    }
-    return ERR_OK;
-}
-
 uint8_t BundleInstaller::Uninstall(const char *bundleName, const InstallParam &installParam)
 {
     if (bundleName == nullptr) {
         return ERR_APPEXECFWK_UNINSTALL_FAILED_PARAM_ERROR;
     }
 
-    BundleInfo *bundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundleName);
+    BundleInfoRef bundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundleName);
     if (bundleInfo == nullptr) {
         return ERR_APPEXECFWK_UNINSTALL_FAILED_BUNDLE_NOT_EXISTS;
     }
@@ -454,6 +731,7 @@ uint8_t BundleInstaller::Uninstall(const char *bundleName, const InstallParam &i
 
     ManagerService::GetInstance().RemoveBundleInfo(bundleName);
 
+    Lock<Mutex> lock(commitMutex_);
     if (DeletePermissions(const_cast<char *>(bundleName)) < 0) {
         return ERR_APPEXECFWK_UNINSTALL_FAILED_DELETE_PERMISSIONS_ERROR;
     }
@@ -474,12 +752,12 @@ uint8_t BundleInstaller::Uninstall(const char *bundleName, const InstallParam &i
     return ERR_OK;
 }
 
-bool BundleInstaller::BackUpUidAndGidInfo(const InstallRecord &record, const char *jsonPath)
+bool BundleInstaller::BackUpUidAndGidInfo(const std::vector<InstallRecord> &records, const char *jsonPath)
 {
     if (jsonPath == nullptr) {
         return false;
     }
-    cJSON *object = BundleUtil::ConvertUidAndGidToJson(record);
+    cJSON *object = BundleUtil::ConvertUidAndGidToJson(records);
     if (object == nullptr) {
         HILOG_ERROR(HILOG_MODULE_APP, "BackUpUidAndGidInfo fail, object is null!");
         return false;
@@ -704,7 +982,7 @@ uint8_t BundleInstaller::CheckVersionAndSignature(const char *bundleName, Bundle
         HILOG_ERROR(HILOG_MODULE_APP, "CheckVersionAndSignature fail beacuse param is nullptr!");
         return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
     }
-    BundleInfo *oldBundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundleName);
+    BundleInfoRef oldBundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundleName);
     if (oldBundleInfo != nullptr) {
         if (oldBundleInfo->versionCode > bundleInfo->versionCode) {
             return ERR_APPEXECFWK_INSTALL_FAILED_VERSION_DOWNGRADE;
@@ -739,4 +1017,36 @@ bool BundleInstaller::RenameJsonFile(const char *fileName, const char *randStr)
     }
     return true;
 }
+
+bool BundleInstaller::BackUpJsonFile(const char *fileName, const char *randStr)
+{
+    if (fileName == nullptr || randStr == nullptr) {
+        return false;
+    }
+
+    std::string jsonPath = std::string(JSON_PATH) + fileName + JSON_SUFFIX;
+    std::string backUpJsonPath = std::string(JSON_PATH) + fileName + randStr + BACKUP_SUFFIX + JSON_SUFFIX;
+    return BundleDaemonClient::GetInstance().RenameFile(jsonPath.c_str(), backUpJsonPath.c_str()) == EC_SUCCESS;
+}
+
+bool BundleInstaller::RestoreJsonFile(const char *fileName, const char *randStr)
+{
+    if (fileName == nullptr || randStr == nullptr) {
+        return false;
+    }
+
+    std::string backUpJsonPath = std::string(JSON_PATH) + fileName + randStr + BACKUP_SUFFIX + JSON_SUFFIX;
+    std::string jsonPath = std::string(JSON_PATH) + fileName + JSON_SUFFIX;
+    return BundleDaemonClient::GetInstance().RenameFile(backUpJsonPath.c_str(), jsonPath.c_str()) == EC_SUCCESS;
+}
+
+void BundleInstaller::RemoveBackUpJsonFile(const char *fileName, const char *randStr)
+{
+    if (fileName == nullptr || randStr == nullptr) {
+        return;
+    }
+
+    std::string backUpJsonPath = std::string(JSON_PATH) + fileName + randStr + BACKUP_SUFFIX + JSON_SUFFIX;
+    BundleDaemonClient::GetInstance().RemoveFile(backUpJsonPath.c_str());
+}
 } // namespace OHOS
@@ -25,7 +25,9 @@ extern "C" {
 #endif
 
 #include <algorithm>
+#include <ctime>
 #include <dirent.h>
+#include <new>
 #include <pthread.h>
 #include <unistd.h>
 
@@ -39,6 +41,8 @@ extern "C" {
 #include "bundle_message_id.h"
 #include "bundle_parser.h"
 #include "bundle_util.h"
+#include "hap_sign_verify.h"
+#include "install_scheduler.h"
 #include "ipc_skeleton.h"
 #include "rpc_errno.h"
 #include "bundle_log.h"
@@ -47,6 +51,51 @@ extern "C" {
 #include "want.h"
 
 namespace OHOS {
+namespace {
+// system haps and installed profiles parsed at the same time during the boot scan
+const size_t SCAN_THREAD_NUM = 4;
+constexpr int64_t MS_PER_SECOND = 1000;
+constexpr int64_t NS_PER_MS = 1000000;
+
+// an install handed over to the install scheduler, the hap stays open from reading its bundle name to the install
+struct InstallTaskInfo {
+    SvcIdentityInfo info;
+    InstallSession *session;
+    char *bundleName;
+};
+
+void FreeInstallTaskInfo(InstallTaskInfo *taskInfo)
+{
+    AdapterFree(taskInfo->info.path);
+    AdapterFree(taskInfo->info.svc);
+    AdapterFree(taskInfo->bundleName);
+    delete taskInfo->session;
+    delete taskInfo;
+}
+
+// a batch handed over to the install scheduler, one session per path of the batch
+struct BatchInstallTaskInfo {
+    BatchInstallInfo info;
+    std::vector<InstallSession *> sessions;
+};
+
+void FreeBatchInstallTaskInfo(BatchInstallTaskInfo *taskInfo)
+{
+    ClearBatchInstallInfo(&(taskInfo->info));
+    for (InstallSession *session : taskInfo->sessions) {
+        delete session;
+    }
+    delete taskInfo;
+}
+
+int64_t GetCurrentTimeMs()
+{
+    struct timespec ts = { 0, 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * MS_PER_SECOND + ts.tv_nsec / NS_PER_MS;
+}
+}
+
 ManagerService::ManagerService()
 {
     installer_ = new (std::nothrow) BundleInstaller(INSTALL_PATH, DATA_PATH);
@@ -89,8 +138,11 @@ static void InnerTransact(uint32_t code, uint8_t resultCode, const char *bundleN
     for (const auto& svc : svcIdentity) {
         int32_t ret = SendRequest(svc, code, &io, &reply, option, &ptr);
         if (ret != ERR_NONE) {
+            // the other callbacks still get the result, their processes may cache infos of the bundle; one that can
+            // not be reached belongs to a process that is gone and is not tried again
             HILOG_ERROR(HILOG_MODULE_APP, "BundleMS InnerTransact failed %{public}d\n", ret);
-            return;
+            ManagerService::GetInstance().RemoveCallbackServiceId(svc);
+            continue;
         }
     }
 }
@@ -115,6 +167,7 @@ static void InnerSelfTransact(uint32_t code, uint8_t resultCode, const SvcIdenti
 
 std::vector<SvcIdentity> ManagerService::GetServiceId() const
 {
+    Lock<Mutex> lock(svcIdentityMutex_);
     return svcIdentity_;
 }
 
@@ -149,7 +202,7 @@ bool ManagerService::IsExternalInstallMode() const
 
 uint8_t ManagerService::SetDebugMode(bool enable)
 {
-    int32_t ret = APPVERI_SetDebugMode(enable);
+    int32_t ret = HapSignVerify::SetDebugMode(enable);
     if (ret < 0) {
         HILOG_ERROR(HILOG_MODULE_APP, "set signature debug mode failed");
         return ERR_APPEXECFWK_SET_DEBUG_MODE_ERROR;
@@ -221,10 +274,19 @@ void ManagerService::ServiceMsgProcess(Request* request)
                 AdapterFree(info->svc);
                 return;
             }
-
-            InstallThirdBundle(info->path, *(info->svc), info->installLocation);
-            AdapterFree(info->path);
-            AdapterFree(info->svc);
+            SubmitInstall(*info);
+            break;
+        }
+        case BUNDLE_BATCH_INSTALLED: {
+            auto info = reinterpret_cast<BatchInstallInfo *>(request->data);
+            if (info == nullptr) {
+                return;
+            }
+            if (info->svc == nullptr || info->paths == nullptr) {
+                ClearBatchInstallInfo(info);
+                return;
+            }
+            SubmitInstallBatch(*info);
             break;
         }
         case BUNDLE_UNINSTALLED: {
@@ -237,16 +299,7 @@ void ManagerService::ServiceMsgProcess(Request* request)
                 AdapterFree(info->svc);
                 return;
             }
-
-            InstallParam installParam = {.installLocation = 1, .keepData = info->keepData};
-            uint8_t bResult = installer_->Uninstall(info->bundleName, installParam);
-            InnerSelfTransact(UNINSTALL_CALLBACK, bResult, *(info->svc));
-            InnerTransact(UNINSTALL_CALLBACK, bResult, info->bundleName);
-            if (bResult == ERR_OK) {
-                RecycleUid(info->bundleName);
-            }
-            AdapterFree(info->bundleName);
-            AdapterFree(info->svc);
+            SubmitUninstall(*info);
             break;
         }
         case BUNDLE_CHANGE_CALLBACK: {
@@ -274,6 +327,7 @@ static bool CompareServiceId(const SvcIdentity &svc1, const SvcIdentity &svc2)
 
 void ManagerService::AddCallbackServiceId(const SvcIdentity &svc)
 {
+    Lock<Mutex> lock(svcIdentityMutex_);
     for (auto it = svcIdentity_.begin(); it != svcIdentity_.end(); ++it) {
         if (CompareServiceId(*it, svc)) {
             return;
@@ -285,6 +339,7 @@ void ManagerService::AddCallbackServiceId(const SvcIdentity &svc)
 void ManagerService::RemoveCallbackServiceId(const SvcIdentity &svc)
 {
     ReleaseSvc(svc);
+    Lock<Mutex> lock(svcIdentityMutex_);
     for (auto it = svcIdentity_.begin(); it != svcIdentity_.end(); ++it) {
         if (CompareServiceId(*it, svc)) {
             svcIdentity_.erase(it);
@@ -293,26 +348,150 @@ void ManagerService::RemoveCallbackServiceId(const SvcIdentity &svc)
     }
 }
 
-void ManagerService::InstallThirdBundle(const char *path, const SvcIdentity &svc, int32_t installLocation)
+void ManagerService::SubmitInstall(SvcIdentityInfo &info)
 {
-    if (path == nullptr || installer_ == nullptr) {
+    InstallTaskInfo *taskInfo = new (std::nothrow) InstallTaskInfo { info, nullptr, nullptr };
+    if (taskInfo == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS create install task fail");
+        InnerSelfTransact(INSTALL_CALLBACK, ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR, *(info.svc));
+        AdapterFree(info.path);
+        AdapterFree(info.svc);
+        return;
+    }
+    // the hap is opened once here and its profile shared by the installer, the bundle name is read on the service
+    // task so that installs and uninstalls of one bundle still run in the order they are requested
+    taskInfo->session = new (std::nothrow) InstallSession(info.path);
+    if (taskInfo->session == nullptr) {
+        InnerSelfTransact(INSTALL_CALLBACK, ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR, *(info.svc));
+        FreeInstallTaskInfo(taskInfo);
         return;
     }
-    char *bundleName = nullptr;
     int32_t versionCode = -1;
-    int8_t ret = BundleParser::ParseBundleParam(path, &bundleName, versionCode);
+    int8_t ret = BundleParser::ParseBundleParam(*(taskInfo->session), &(taskInfo->bundleName), versionCode);
     if (ret != ERR_OK) {
-        InnerSelfTransact(INSTALL_CALLBACK, ret, svc);
+        InnerSelfTransact(INSTALL_CALLBACK, ret, *(info.svc));
+        FreeInstallTaskInfo(taskInfo);
+        return;
+    }
+    InstallScheduler::GetInstance().Submit({ taskInfo->bundleName }, InstallTask, taskInfo);
+}
+
+void ManagerService::SubmitInstallBatch(BatchInstallInfo &info)
+{
+    BatchInstallTaskInfo *taskInfo = new (std::nothrow) BatchInstallTaskInfo { info, {} };
+    if (taskInfo == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS create batch install task fail");
+        InnerSelfTransact(INSTALL_CALLBACK, ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR, *(info.svc));
+        ClearBatchInstallInfo(&info);
+        return;
+    }
+    // as for a single install, each hap is opened once here and handed over to the installer with its profile, a
+    // hap whose bundle name can not be read fails the batch before anything of it is committed
+    std::vector<std::string> bundleNames;
+    for (uint32_t i = 0; i < info.pathNum; i++) {
+        InstallSession *session = (info.paths[i] != nullptr) ? new (std::nothrow) InstallSession(info.paths[i]) :
+            nullptr;
+        taskInfo->sessions.emplace_back(session);
+        if (session == nullptr) {
+            continue;
+        }
+        char *bundleName = nullptr;
+        int32_t versionCode = -1;
+        if (BundleParser::ParseBundleParam(*session, &bundleName, versionCode) == ERR_OK) {
+            bundleNames.emplace_back(bundleName);
+        }
         AdapterFree(bundleName);
+    }
+    InstallScheduler::GetInstance().Submit(bundleNames, InstallBatchTask, taskInfo);
+}
+
+void ManagerService::SubmitUninstall(SvcIdentityInfo &info)
+{
+    SvcIdentityInfo *taskInfo = new (std::nothrow) SvcIdentityInfo(info);
+    if (taskInfo == nullptr) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS create uninstall task fail");
+        InnerSelfTransact(UNINSTALL_CALLBACK, ERR_APPEXECFWK_UNINSTALL_FAILED_INTERNAL_ERROR, *(info.svc));
+        AdapterFree(info.bundleName);
+        AdapterFree(info.svc);
+        return;
+    }
+    InstallScheduler::GetInstance().Submit({ taskInfo->bundleName }, UninstallTask, taskInfo);
+}
+
+void ManagerService::InstallTask(void *arg)
+{
+    InstallTaskInfo *taskInfo = reinterpret_cast<InstallTaskInfo *>(arg);
+    GetInstance().InstallThirdBundle(*(taskInfo->session), taskInfo->bundleName, *(taskInfo->info.svc),
+        taskInfo->info.installLocation);
+    FreeInstallTaskInfo(taskInfo);
+}
+
+void ManagerService::InstallBatchTask(void *arg)
+{
+    BatchInstallTaskInfo *taskInfo = reinterpret_cast<BatchInstallTaskInfo *>(arg);
+    GetInstance().InstallThirdBundleBatch(taskInfo->info.paths, taskInfo->info.pathNum, taskInfo->sessions,
+        *(taskInfo->info.svc), taskInfo->info.installLocation);
+    FreeBatchInstallTaskInfo(taskInfo);
+}
+
+void ManagerService::UninstallTask(void *arg)
+{
+    SvcIdentityInfo *taskInfo = reinterpret_cast<SvcIdentityInfo *>(arg);
+    GetInstance().UninstallThirdBundle(taskInfo->bundleName, *(taskInfo->svc), taskInfo->keepData);
+    AdapterFree(taskInfo->bundleName);
+    AdapterFree(taskInfo->svc);
+    delete taskInfo;
+}
+
+void ManagerService::InstallThirdBundle(InstallSession &session, const char *bundleName, const SvcIdentity &svc,
+    int32_t installLocation)
+{
+    if (installer_ == nullptr) {
         return;
     }
     InstallParam installParam = {.installLocation = installLocation, .keepData = false};
-    uint8_t bResult = installer_->Install(path, installParam);
+    uint8_t bResult = installer_->Install(session.GetHapPath().c_str(), installParam, &session);
     HILOG_DEBUG(HILOG_MODULE_APP, "BundleMS InstallThirdBundle Install : %{public}d\n", bResult);
     InnerSelfTransact(INSTALL_CALLBACK, bResult, svc);
     InnerTransact(INSTALL_CALLBACK, bResult, bundleName);
 }
 
+void ManagerService::InstallThirdBundleBatch(char **paths, uint32_t pathNum,
+    const std::vector<InstallSession *> &sessions, const SvcIdentity &svc, int32_t installLocation)
+{
+    if (paths == nullptr || installer_ == nullptr) {
+        return;
+    }
+    std::vector<std::string> hapPaths;
+    for (uint32_t i = 0; i < pathNum; i++) {
+        hapPaths.emplace_back((paths[i] != nullptr) ? paths[i] : "");
+    }
+    InstallParam installParam = {.installLocation = installLocation, .keepData = false};
+    std::vector<std::string> installedBundles;
+    uint8_t bResult = installer_->InstallBatch(hapPaths, installParam, installedBundles, &sessions);
+    HILOG_INFO(HILOG_MODULE_APP, "BundleMS InstallThirdBundleBatch result %{public}d, %{public}zu of %{public}u",
+        bResult, installedBundles.size(), pathNum);
+    // the listeners are told about the whole batch once everything has been recorded
+    InnerSelfTransact(INSTALL_CALLBACK, bResult, svc);
+    for (const auto &bundleName : installedBundles) {
+        InnerTransact(INSTALL_CALLBACK, ERR_OK, bundleName.c_str());
+    }
+}
+
+void ManagerService::UninstallThirdBundle(const char *bundleName, const SvcIdentity &svc, bool keepData)
+{
+    if (installer_ == nullptr) {
+        return;
+    }
+    InstallParam installParam = {.installLocation = 1, .keepData = keepData};
+    uint8_t bResult = installer_->Uninstall(bundleName, installParam);
+    InnerSelfTransact(UNINSTALL_CALLBACK, bResult, svc);
+    InnerTransact(UNINSTALL_CALLBACK, bResult, bundleName);
+    if (bResult == ERR_OK) {
+        RecycleUid(bundleName);
+    }
+}
+
 void ManagerService::InstallAllSystemBundle(int32_t scanFlag)
 {
     DIR *dir = nullptr;
@@ -353,12 +532,15 @@ void ManagerService::InstallSystemBundle(const char *fileDir, const char *fileNa
 
 void ManagerService::ScanPackages()
 {
+    int64_t beginTime = GetCurrentTimeMs();
     // restore uid and gid map
     RestoreUidAndGidMap();
 
     if (!BundleUtil::IsDir(JSON_PATH)) {
         InstallAllSystemBundle(SYSTEM_APP_FLAG);
         InstallAllSystemBundle(THIRD_SYSTEM_APP_FLAG);
+        HILOG_INFO(HILOG_MODULE_APP, "BundleMS first boot, install system apps cost %{public}lld ms",
+            static_cast<long long>(GetCurrentTimeMs() - beginTime));
         return;
     }
 
@@ -368,28 +550,35 @@ void ManagerService::ScanPackages()
         BundleDaemonClient::GetInstance().RemoveFile(UNINSTALL_THIRD_SYSTEM_BUNDLE_JSON);
     }
 
-    // scan system apps
-    ScanAppDir(SYSTEM_BUNDLE_PATH, nullptr, SYSTEM_APP_FLAG);
-    // scan third system apps
-    ScanAppDir(THIRD_SYSTEM_BUNDLE_PATH, uninstallRecord, THIRD_SYSTEM_APP_FLAG);
+    // system apps, third system apps, third apps and third apps in sdcard if exists, in this order
+    std::vector<ScanEntry> entries;
+    CollectScanEntries(SYSTEM_BUNDLE_PATH, SYSTEM_APP_FLAG, entries);
+    CollectScanEntries(THIRD_SYSTEM_BUNDLE_PATH, THIRD_SYSTEM_APP_FLAG, entries);
+    CollectScanEntries(INSTALL_PATH, THIRD_APP_FLAG, entries);
+    if (BundleUtil::IsDir(EXTEANAL_INSTALL_PATH)) {
+        CollectScanEntries(EXTEANAL_INSTALL_PATH, THIRD_APP_FLAG, entries);
+    }
+    int64_t collectTime = GetCurrentTimeMs();
+
+    uint32_t threadNum = ParseScanEntries(entries, uninstallRecord);
     if (uninstallRecord != nullptr) {
         cJSON_Delete(uninstallRecord);
         uninstallRecord = nullptr;
     }
-    // scan third apps
-    ScanAppDir(INSTALL_PATH, nullptr, THIRD_APP_FLAG);
-    // scan third apps in sdcard if exists
-    if (BundleUtil::IsDir(EXTEANAL_INSTALL_PATH)) {
-        ScanAppDir(EXTEANAL_INSTALL_PATH, nullptr, THIRD_APP_FLAG);
+    int64_t parseTime = GetCurrentTimeMs();
+
+    for (auto &entry : entries) {
+        PublishScanEntry(entry);
     }
+    int64_t publishTime = GetCurrentTimeMs();
+    HILOG_INFO(HILOG_MODULE_APP, "BundleMS scan %{public}zu entries cost %{public}lld ms, collect %{public}lld ms, "
+        "parse %{public}lld ms on %{public}u threads, publish %{public}lld ms", entries.size(),
+        static_cast<long long>(publishTime - beginTime), static_cast<long long>(collectTime - beginTime),
+        static_cast<long long>(parseTime - collectTime), threadNum, static_cast<long long>(publishTime - parseTime));
 }
 
-void ManagerService::ScanAppDir(const char *appDir, const cJSON *uninstallRecord, uint8_t scanFlag)
+void ManagerService::CollectScanEntries(const char *appDir, uint8_t scanFlag, std::vector<ScanEntry> &entries)
 {
-    dirent *ent = nullptr;
-    char *bundleName = nullptr;
-    int32_t versionCode = -1;
-
     if (appDir == nullptr) {
         return;
     }
@@ -398,109 +587,111 @@ void ManagerService::ScanAppDir(const char *appDir, const cJSON *uninstallRecord
     if (dir == nullptr) {
         return;
     }
+    dirent *ent = nullptr;
     while ((ent = readdir(dir)) != nullptr) {
         if ((strcmp(ent->d_name, ".") == 0) || (strcmp(ent->d_name, "..")) == 0) {
             continue;
         }
-        std::string appPath = std::string(appDir) + PATH_SEPARATOR + ent->d_name;
+        ScanEntry entry;
+        entry.appPath = std::string(appDir) + PATH_SEPARATOR + ent->d_name;
+        // the code dir of a third app is named after its bundle
         if (scanFlag == THIRD_APP_FLAG) {
-            if (!BundleUtil::IsDir(appPath.c_str())) {
-                continue;
-            }
-            ReloadEntireBundleInfo(appPath.c_str(), ent->d_name, versionCode, scanFlag);
-            continue;
-        }
-
-        // scan system app
-        bool res = CheckSystemBundleIsValid(appPath.c_str(), &bundleName, versionCode);
-        if (!res) {
-            AdapterFree(bundleName);
-            continue;
-        }
-
-        if (scanFlag == THIRD_SYSTEM_APP_FLAG &&
-            CheckThirdSystemBundleHasUninstalled(bundleName, uninstallRecord)) {
-            AdapterFree(bundleName);
-            continue;
+            entry.bundleName = ent->d_name;
         }
-        ReloadEntireBundleInfo(appPath.c_str(), bundleName, versionCode, scanFlag);
-        AdapterFree(bundleName);
+        entry.scanFlag = scanFlag;
+        entries.emplace_back(entry);
     }
     closedir(dir);
 }
 
-bool ManagerService::CheckSystemBundleIsValid(const char *appPath, char **bundleName, int32_t &versionCode)
+uint32_t ManagerService::ParseScanEntries(std::vector<ScanEntry> &entries, const cJSON *uninstallRecord)
 {
-    if (appPath == nullptr || bundleName == nullptr) {
-        return false;
-    }
-
-    if (!BundleUtil::EndWith(appPath, INSTALL_FILE_SUFFIX)) {
-        return false;
+    ScanTask task;
+    task.service = this;
+    task.entries = &entries;
+    task.uninstallRecord = uninstallRecord;
+    task.nextIndex = 0;
+    // the calling thread parses entries as well
+    uint32_t threadNum = static_cast<uint32_t>(std::min(entries.size(), SCAN_THREAD_NUM));
+    std::vector<pthread_t> threads;
+    for (uint32_t i = 1; i < threadNum; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, ParseScanWorker, &task) != 0) {
+            HILOG_WARN(HILOG_MODULE_APP, "create scan thread fail, parse on %{public}zu threads", threads.size() + 1);
+            break;
+        }
+        threads.emplace_back(thread);
     }
-
-    if (BundleParser::ParseBundleParam(appPath, bundleName, versionCode) != 0) {
-        return false;
+    ParseScanWorker(&task);
+    for (pthread_t thread : threads) {
+        pthread_join(thread, nullptr);
     }
-
-    if (*bundleName != nullptr && strlen(*bundleName) > MAX_BUNDLE_NAME_LEN) {
-        return false;
-    }
-    return true;
+    return static_cast<uint32_t>(threads.size() + 1);
 }
 
-void ManagerService::ReloadEntireBundleInfo(const char *appPath, const char *bundleName, int32_t versionCode,
-    uint8_t scanFlag)
+void *ManagerService::ParseScanWorker(void *arg)
 {
-    char *codePath = nullptr;
-    char *appId = nullptr;
-    int32_t oldVersionCode = -1;
-    InstallParam installParam = {.installLocation = 1, .keepData = false};
-
-    if (appPath == nullptr || bundleName == nullptr || installer_ == nullptr) {
-        return;
-    }
-
-    if (QueryBundleInfo(bundleName) != nullptr) {
-        return;
+    ScanTask *task = reinterpret_cast<ScanTask *>(arg);
+    for (size_t index = task->nextIndex++; index < task->entries->size(); index = task->nextIndex++) {
+        task->service->ParseScanEntry((*task->entries)[index], task->uninstallRecord);
     }
+    return nullptr;
+}
 
-    bool res = BundleUtil::CheckBundleJsonIsValid(bundleName, &codePath, &appId, oldVersionCode);
-    bool isSystemApp = (scanFlag == SYSTEM_APP_FLAG);
-    if (scanFlag != THIRD_APP_FLAG) {
-        if (!res) {
-            uint8_t ret = installer_->Install(appPath, installParam);
-            HILOG_INFO(HILOG_MODULE_APP, "install new system app, result is %d", ret);
-            AdapterFree(codePath);
-            AdapterFree(appId);
+void ManagerService::ParseScanEntry(ScanEntry &entry, const cJSON *uninstallRecord)
+{
+    int32_t versionCode = -1;
+    if (entry.scanFlag == THIRD_APP_FLAG) {
+        if (!BundleUtil::IsDir(entry.appPath.c_str())) {
             return;
         }
-        if (versionCode > oldVersionCode) {
-            ReloadBundleInfo(codePath, appId, bundleName, isSystemApp);
-            uint8_t ret = installer_->Install(appPath, installParam);
-            HILOG_INFO(HILOG_MODULE_APP, "update system app, result is %d", ret);
-            AdapterFree(codePath);
-            AdapterFree(appId);
+    } else {
+        // scan system app, the hap stays open in case it has to be installed or updated
+        entry.session = new (std::nothrow) InstallSession(entry.appPath);
+        if (entry.session == nullptr) {
             return;
         }
-    } else {
-        if (!res) {
-            HILOG_ERROR(HILOG_MODULE_APP, "codePath or appid in third app json file is invalid!");
-            AdapterFree(codePath);
-            AdapterFree(appId);
+        char *bundleName = nullptr;
+        bool res = CheckSystemBundleIsValid(*entry.session, &bundleName, versionCode);
+        if (!res || (entry.scanFlag == THIRD_SYSTEM_APP_FLAG &&
+            CheckThirdSystemBundleHasUninstalled(bundleName, uninstallRecord))) {
+            AdapterFree(bundleName);
+            delete entry.session;
+            entry.session = nullptr;
             return;
         }
+        entry.bundleName = bundleName;
+        AdapterFree(bundleName);
+    }
+    entry.isValid = true;
+
+    char *codePath = nullptr;
+    char *appId = nullptr;
+    int32_t oldVersionCode = -1;
+    entry.hasRecord = BundleUtil::CheckBundleJsonIsValid(entry.bundleName.c_str(), &codePath, &appId,
+        oldVersionCode);
+    if (entry.scanFlag != THIRD_APP_FLAG) {
+        entry.needInstall = !entry.hasRecord || (versionCode > oldVersionCode);
+    } else if (!entry.hasRecord) {
+        HILOG_ERROR(HILOG_MODULE_APP, "codePath or appid in third app json file is invalid!");
+        entry.isValid = false;
+    }
+    if (entry.hasRecord) {
+        LoadBundleInfos(codePath, appId, entry);
     }
-    ReloadBundleInfo(codePath, appId, bundleName, isSystemApp);
-    AdapterFree(appId);
     AdapterFree(codePath);
+    AdapterFree(appId);
+    if (!entry.needInstall) {
+        delete entry.session;
+        entry.session = nullptr;
+    }
 }
 
-void ManagerService::ReloadBundleInfo(const char *codePath, const char *appId, const char *bundleName,
-    bool isSystemApp)
+void ManagerService::LoadBundleInfos(const char *codePath, const char *appId, ScanEntry &entry)
 {
     BundleParser bundleParser;
     dirent *ent = nullptr;
+    const char *bundleName = entry.bundleName.c_str();
 
     int32_t uid = BundleUtil::GetValueFromBundleJson(bundleName, JSON_SUB_KEY_UID, INVALID_UID);
     int32_t gid = uid;
@@ -521,7 +712,7 @@ void ManagerService::ReloadBundleInfo(const char *codePath, const char *appId, c
         std::string profileDir = codePath + std::string(PATH_SEPARATOR) + ent->d_name;
         BundleInfo *bundleInfo = bundleParser.ParseHapProfile(profileDir.c_str());
         if (bundleInfo != nullptr) {
-            bundleInfo->isSystemApp = isSystemApp;
+            bundleInfo->isSystemApp = (entry.scanFlag == SYSTEM_APP_FLAG);
             bundleInfo->appId = Utils::Strdup(appId);
             if (bundleInfo->appId == nullptr) {
                 HILOG_ERROR(HILOG_MODULE_APP, "bundleInfo->appId is nullptr when restore bundleInfo!");
@@ -530,15 +721,65 @@ void ManagerService::ReloadBundleInfo(const char *codePath, const char *appId, c
             }
             bundleInfo->uid = static_cast<int32_t>(uid);
             bundleInfo->gid = static_cast<int32_t>(gid);
+            entry.bundleInfos.emplace_back(bundleInfo);
+        } else {
+            entry.invalidProfileDirs.emplace_back(profileDir);
+        }
+    }
+    closedir(dir);
+}
+
+void ManagerService::PublishScanEntry(ScanEntry &entry)
+{
+    // a bundle found in an earlier dir is kept, as when the dirs were scanned one after another
+    bool isPublished = entry.isValid && (QueryBundleInfo(entry.bundleName.c_str()) == nullptr);
+    for (BundleInfo *bundleInfo : entry.bundleInfos) {
+        if (isPublished) {
             // need to update bundleInfo when support many haps install
-            bundleMap_->Add(bundleInfo);
+            AddBundleInfo(bundleInfo);
         } else {
+            BundleInfoUtils::FreeBundleInfo(bundleInfo);
+        }
+    }
+    entry.bundleInfos.clear();
+    if (isPublished) {
+        for (const auto &profileDir : entry.invalidProfileDirs) {
             BundleDaemonClient::GetInstance().RemoveFile(profileDir.c_str());
             // delete uid and gid info
-            BundleUtil::DeleteUidInfoFromJson(bundleName);
+            BundleUtil::DeleteUidInfoFromJson(entry.bundleName.c_str());
         }
     }
-    closedir(dir);
+    if (isPublished && entry.needInstall && installer_ != nullptr) {
+        InstallParam installParam = {.installLocation = 1, .keepData = false};
+        uint8_t ret = installer_->Install(entry.appPath.c_str(), installParam, entry.session);
+        if (entry.hasRecord) {
+            HILOG_INFO(HILOG_MODULE_APP, "update system app, result is %d", ret);
+        } else {
+            HILOG_INFO(HILOG_MODULE_APP, "install new system app, result is %d", ret);
+        }
+    }
+    delete entry.session;
+    entry.session = nullptr;
+}
+
+bool ManagerService::CheckSystemBundleIsValid(InstallSession &session, char **bundleName, int32_t &versionCode)
+{
+    if (bundleName == nullptr) {
+        return false;
+    }
+
+    if (!BundleUtil::EndWith(session.GetHapPath().c_str(), INSTALL_FILE_SUFFIX)) {
+        return false;
+    }
+
+    if (BundleParser::ParseBundleParam(session, bundleName, versionCode) != 0) {
+        return false;
+    }
+
+    if (*bundleName != nullptr && strlen(*bundleName) > MAX_BUNDLE_NAME_LEN) {
+        return false;
+    }
+    return true;
 }
 
 bool ManagerService::CheckThirdSystemBundleHasUninstalled(const char *bundleName, const cJSON *object)
@@ -564,10 +805,10 @@ bool ManagerService::CheckThirdSystemBundleHasUninstalled(const char *bundleName
     return false;
 }
 
-BundleInfo *ManagerService::QueryBundleInfo(const char *bundleName)
+BundleInfoRef ManagerService::QueryBundleInfo(const char *bundleName)
 {
     if (bundleMap_ == nullptr || bundleName == nullptr) {
-        return nullptr;
+        return BundleInfoRef();
     }
     return bundleMap_->Get(bundleName);
 }
@@ -596,6 +837,24 @@ bool ManagerService::UpdateBundleInfo(BundleInfo *info)
     return bundleMap_->Update(info);
 }
 
+uint64_t ManagerService::GetGeneration() const
+{
+    if (bundleMap_ == nullptr) {
+        return 0;
+    }
+    return bundleMap_->GetGeneration();
+}
+
+bool ManagerService::GetBundleInfosChangedSince(uint64_t generation, int32_t flags, BundleInfo **bundleInfos,
+    int32_t *len, std::vector<std::string> &removedBundleNames, uint64_t *currentGeneration)
+{
+    if (bundleMap_ == nullptr) {
+        return false;
+    }
+    return bundleMap_->GetBundleInfosChangedSince(generation, flags, bundleInfos, len, removedBundleNames,
+        currentGeneration);
+}
+
 uint8_t ManagerService::GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo)
 {
     if (bundleName == nullptr || bundleMap_ == nullptr) {
@@ -604,6 +863,15 @@ uint8_t ManagerService::GetBundleInfo(const char *bundleName, int32_t flags, Bun
     return bundleMap_->GetBundleInfo(bundleName, flags, bundleInfo);
 }
 
+uint8_t ManagerService::GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo,
+    BundleInfoRef &pin)
+{
+    if (bundleName == nullptr || bundleMap_ == nullptr) {
+        return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
+    }
+    return bundleMap_->GetBundleInfo(bundleName, flags, bundleInfo, pin);
+}
+
 bool ManagerService::HasSystemCapability(const char *sysCapName)
 {
     if (sysCapName == nullptr) {
@@ -632,12 +900,44 @@ uint8_t ManagerService::GetBundleInfos(int32_t flags, BundleInfo **bundleInfos,
     return bundleMap_->GetBundleInfos(flags, bundleInfos, len);
 }
 
+uint8_t ManagerService::QueryAbilityInfo(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo)
+{
+    if (bundleMap_ == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    return bundleMap_->QueryAbilityInfo(bundleName, abilityName, abilityInfo);
+}
+
+uint8_t ManagerService::QueryKeepAliveBundleInfos(BundleInfo **bundleInfos, int32_t *len)
+{
+    if (bundleMap_ == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    return bundleMap_->GetKeepAliveBundleInfos(bundleInfos, len);
+}
+
+uint8_t ManagerService::GetBundleInfosByMetaData(const char *metaDataKey, BundleInfo **bundleInfos, int32_t *len)
+{
+    if (bundleMap_ == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    return bundleMap_->GetBundleInfosByMetaData(metaDataKey, bundleInfos, len);
+}
+
+uint8_t ManagerService::GetBundleNameForUid(int32_t uid, char **bundleName)
+{
+    if (bundleMap_ == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    return bundleMap_->GetBundleNameForUid(uid, bundleName);
+}
+
 uint32_t ManagerService::GetBundleSize(const char *bundleName)
 {
     if (bundleName == nullptr) {
         return 0;
     }
-    BundleInfo *installedInfo = bundleMap_->Get(bundleName);
+    BundleInfoRef installedInfo = bundleMap_->Get(bundleName);
     if (installedInfo == nullptr) {
         return 0;
     }
@@ -652,22 +952,6 @@ uint32_t ManagerService::GetBundleSize(const char *bundleName)
     return codeBundleSize + dataBundleSize;
 }
 
-std::string ManagerService::GetCodeDirPath() const
-{
-    if (installer_ == nullptr) {
-        return "";
-    }
-    return installer_->GetCodeDirPath();
-}
-
-std::string ManagerService::GetDataDirPath() const
-{
-    if (installer_ == nullptr) {
-        return "";
-    }
-    return installer_->GetDataDirPath();
-}
-
 static int32_t GenerateInnerUid(std::map<int, std::string> &innerMap, const std::string &bundleName,
     int8_t bundleStyle, int32_t baseUid)
 {
@@ -701,6 +985,7 @@ int32_t ManagerService::GenerateUid(const char *bundleName, int8_t bundleStyle)
         return INVALID_UID;
     }
 
+    Lock<Mutex> lock(uidMutex_);
     if (bundleStyle == THIRD_SYSTEM_APP_FLAG) {
         return GenerateInnerUid(sysVendorUidMap_, bundleName, THIRD_SYSTEM_APP_FLAG, BASE_SYS_VEN_UID);
     } else if (bundleStyle == THIRD_APP_FLAG) {
@@ -731,6 +1016,7 @@ void ManagerService::RecycleUid(const char *bundleName)
         return;
     }
 
+    Lock<Mutex> lock(uidMutex_);
     if (RecycleInnerUid(bundleName, appUidMap_) || RecycleInnerUid(bundleName, sysVendorUidMap_) ||
         RecycleInnerUid(bundleName, sysUidMap_)) {
         return;
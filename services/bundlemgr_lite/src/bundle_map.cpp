@@ -16,10 +16,16 @@
 #include "bundle_map.h"
 
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <fcntl.h>
 #include <pthread.h>
+#include <unistd.h>
 #else
 #include "cmsis_os2.h"
 #endif
+#include "ability_info_utils.h"
 #include "adapter.h"
 #include "appexecfwk_errors.h"
 #include "bundle_info_utils.h"
@@ -27,28 +33,322 @@
 
 namespace OHOS {
 const int32_t GET_BUNDLE_WITH_ABILITIES = 1;
+const uint32_t INITIAL_INDEX_CAPACITY = 16;
+const uint32_t FNV_OFFSET_BASIS = 2166136261U;
+const uint32_t FNV_PRIME = 16777619U;
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-static pthread_mutex_t g_bundleListMutex = PTHREAD_MUTEX_INITIALIZER;
+const uint32_t GOLDEN_RATIO_32 = 2654435769U;
+#endif
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+const uint32_t GENERATION_EPOCH_SHIFT = 32;
+static pthread_rwlock_t g_bundleListLock = PTHREAD_RWLOCK_INITIALIZER;
 #else
 const int32_t BUNDLELIST_MUTEX_TIMEOUT = 2000;
 static osMutexId_t g_bundleListMutex;
 #endif
 
-BundleMap::BundleMap()
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+// a random epoch per start of bms in the high half of the generation, so that a restarted bms does not repeat a
+// generation a client has already seen, also when the wall clock is set back or not set at all
+static uint64_t CreateGenerationEpoch()
+{
+    uint32_t epoch = 0;
+    int32_t fd = open("/dev/urandom", O_RDONLY);
+    bool isRead = (fd >= 0) && (read(fd, &epoch, sizeof(epoch)) == static_cast<ssize_t>(sizeof(epoch)));
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (!isRead) {
+        // without a random source the clocks still tell most starts apart
+        struct timespec realTime = { 0, 0 };
+        struct timespec monotonicTime = { 0, 0 };
+        clock_gettime(CLOCK_REALTIME, &realTime);
+        clock_gettime(CLOCK_MONOTONIC, &monotonicTime);
+        epoch = static_cast<uint32_t>(realTime.tv_sec) ^ static_cast<uint32_t>(monotonicTime.tv_nsec) ^
+            static_cast<uint32_t>(getpid());
+    }
+    // generation 0 is what a client sends before its first query
+    if (epoch == 0) {
+        epoch = 1;
+    }
+    return static_cast<uint64_t>(epoch) << GENERATION_EPOCH_SHIFT;
+}
+#endif
+
+// queries share the lock on the full bms so that they do not serialize behind each other,
+// the mini bms has no rwlock primitive and keeps using the exclusive mutex for both sides
+static void AcquireReadLock()
+{
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_rwlock_rdlock(&g_bundleListLock);
+#else
+    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
+#endif
+}
+
+static void AcquireWriteLock()
+{
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_rwlock_wrlock(&g_bundleListLock);
+#else
+    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
+#endif
+}
+
+static void ReleaseLock()
+{
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_rwlock_unlock(&g_bundleListLock);
+#else
+    MutexRelease(&g_bundleListMutex);
+#endif
+}
+
+// the map holds one reference of every entry it contains and each BundleInfoRef holds another one
+struct BundleEntry {
+    BundleInfo *info;
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    std::atomic<int32_t> refCount;
+#else
+    int32_t refCount;
+#endif
+};
+
+static BundleEntry *CreateEntry(BundleInfo *bundleInfo)
+{
+    BundleEntry *entry = new (std::nothrow) BundleEntry();
+    if (entry == nullptr) {
+        return nullptr;
+    }
+    entry->info = bundleInfo;
+    entry->refCount = 1;
+    return entry;
+}
+
+static void FreeEntry(BundleEntry *entry)
+{
+    BundleInfoUtils::FreeBundleInfo(entry->info);
+    delete entry;
+}
+
+// on the mini bms the reference count is guarded by g_bundleListMutex, which the caller has to hold
+static void RefEntry(BundleEntry *entry)
+{
+    ++entry->refCount;
+}
+
+// returns true when the last reference is dropped and the entry has to be freed by the caller
+static bool UnrefEntry(BundleEntry *entry)
+{
+    return --entry->refCount == 0;
+}
+
+BundleInfoRef::BundleInfoRef(BundleEntry *entry) : entry_(entry), info_((entry == nullptr) ? nullptr : entry->info)
+{
+}
+
+BundleInfoRef::~BundleInfoRef()
+{
+    Release();
+}
+
+BundleInfoRef::BundleInfoRef(BundleInfoRef &&other) noexcept : entry_(other.entry_), info_(other.info_)
+{
+    other.entry_ = nullptr;
+    other.info_ = nullptr;
+}
+
+BundleInfoRef &BundleInfoRef::operator=(BundleInfoRef &&other) noexcept
+{
+    if (this != &other) {
+        Release();
+        entry_ = other.entry_;
+        info_ = other.info_;
+        other.entry_ = nullptr;
+        other.info_ = nullptr;
+    }
+    return *this;
+}
+
+void BundleInfoRef::Release()
+{
+    if (entry_ == nullptr) {
+        return;
+    }
+#ifndef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    AcquireWriteLock();
+#endif
+    bool isLast = UnrefEntry(entry_);
+#ifndef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    ReleaseLock();
+#endif
+    if (isLast) {
+        FreeEntry(entry_);
+    }
+    entry_ = nullptr;
+    info_ = nullptr;
+}
+
+BundleMap::BundleMap() : nameIndex_({ nullptr, 0, 0 })
 {
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    pthread_mutex_init(&g_bundleListMutex, nullptr);
+    pthread_rwlock_init(&g_bundleListLock, nullptr);
+    generation_ = CreateGenerationEpoch();
+    for (uint32_t i = 0; i < MAX_CHANGE_RECORD_NUM; ++i) {
+        changeRecords_[i] = { 0, nullptr };
+    }
+    nextChangeRecord_ = 0;
+    numOfChangeRecord_ = 0;
+    uidIndex_ = { nullptr, 0, 0 };
+    abilityIndex_ = { nullptr, 0, 0 };
 #else
     g_bundleListMutex = osMutexNew(reinterpret_cast<osMutexAttr_t *>(NULL));
+    skillIndex_ = { nullptr, 0, 0 };
 #endif
-    bundleInfos_ = new (std::nothrow) List<BundleInfo *>();
+    bundleInfos_ = new (std::nothrow) List<BundleEntry *>();
 }
 
 BundleMap::~BundleMap()
 {
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    pthread_rwlock_destroy(&g_bundleListLock);
+    ClearChangeRecords();
+    FreeIndex(uidIndex_);
+    FreeIndex(abilityIndex_);
+#else
     MutexDelete(&g_bundleListMutex);
+    FreeIndex(skillIndex_);
+#endif
     delete bundleInfos_;
     bundleInfos_ = nullptr;
+    FreeIndex(nameIndex_);
+}
+
+uint32_t BundleMap::HashString(const char *str, uint32_t hash)
+{
+    for (const char *ch = str; *ch != '\0'; ++ch) {
+        hash ^= static_cast<uint8_t>(*ch);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint32_t BundleMap::HashBundleName(const char *bundleName)
+{
+    return HashString(bundleName, FNV_OFFSET_BASIS);
+}
+
+Node<BundleEntry *> *BundleMap::FindNode(const char *bundleName, uint32_t hash) const
+{
+    if (nameIndex_.slots == nullptr) {
+        return nullptr;
+    }
+    uint32_t mask = nameIndex_.capacity - 1;
+    for (uint32_t i = hash & mask; nameIndex_.slots[i].node != nullptr; i = (i + 1) & mask) {
+        if (nameIndex_.slots[i].hash != hash) {
+            continue;
+        }
+        BundleInfo *info = nameIndex_.slots[i].node->value_->info;
+        if (info != nullptr && info->bundleName != nullptr && strcmp(info->bundleName, bundleName) == 0) {
+            return nameIndex_.slots[i].node;
+        }
+    }
+    return nullptr;
+}
+
+bool BundleMap::GrowIndex(NodeIndex &index)
+{
+    uint32_t newCapacity = (index.capacity == 0) ? INITIAL_INDEX_CAPACITY : (index.capacity << 1);
+    IndexSlot *newIndex = reinterpret_cast<IndexSlot *>(AdapterMalloc(sizeof(IndexSlot) * newCapacity));
+    if (newIndex == nullptr || memset_s(newIndex, sizeof(IndexSlot) * newCapacity, 0,
+        sizeof(IndexSlot) * newCapacity) != EOK) {
+        AdapterFree(newIndex);
+        return false;
+    }
+    uint32_t mask = newCapacity - 1;
+    for (uint32_t i = 0; i < index.capacity; ++i) {
+        if (index.slots[i].node == nullptr) {
+            continue;
+        }
+        uint32_t pos = index.slots[i].hash & mask;
+        while (newIndex[pos].node != nullptr) {
+            pos = (pos + 1) & mask;
+        }
+        newIndex[pos] = index.slots[i];
+    }
+    AdapterFree(index.slots);
+    index.slots = newIndex;
+    index.capacity = newCapacity;
+    return true;
+}
+
+// keep the load factor at most one half so that probe sequences stay short and always end on an empty slot
+bool BundleMap::ReserveIndex(NodeIndex &index, uint32_t size)
+{
+    while ((size << 1) > index.capacity) {
+        if (!GrowIndex(index)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BundleMap::InsertIndex(NodeIndex &index, Node<BundleEntry *> *node, uint32_t hash, int32_t ordinal)
+{
+    if (!ReserveIndex(index, index.size + 1)) {
+        return false;
+    }
+    uint32_t mask = index.capacity - 1;
+    uint32_t pos = hash & mask;
+    while (index.slots[pos].node != nullptr) {
+        pos = (pos + 1) & mask;
+    }
+    index.slots[pos] = { hash, ordinal, node };
+    ++index.size;
+    return true;
+}
+
+void BundleMap::EraseIndex(NodeIndex &index, const Node<BundleEntry *> *node, uint32_t hash, int32_t ordinal)
+{
+    if (index.slots == nullptr) {
+        return;
+    }
+    uint32_t mask = index.capacity - 1;
+    uint32_t hole = hash & mask;
+    while (index.slots[hole].node != node || index.slots[hole].ordinal != ordinal) {
+        if (index.slots[hole].node == nullptr) {
+            return;
+        }
+        hole = (hole + 1) & mask;
+    }
+    // backward shift deletion, move up every following entry whose home slot is not between the hole and itself
+    for (uint32_t next = (hole + 1) & mask; index.slots[next].node != nullptr; next = (next + 1) & mask) {
+        uint32_t home = index.slots[next].hash & mask;
+        bool inRange = (hole <= next) ? ((hole < home) && (home <= next)) : ((hole < home) || (home <= next));
+        if (inRange) {
+            continue;
+        }
+        index.slots[hole] = index.slots[next];
+        hole = next;
+    }
+    index.slots[hole] = { 0, 0, nullptr };
+    --index.size;
+}
+
+void BundleMap::ClearIndex(NodeIndex &index)
+{
+    if (index.slots == nullptr) {
+        return;
+    }
+    (void) memset_s(index.slots, sizeof(IndexSlot) * index.capacity, 0, sizeof(IndexSlot) * index.capacity);
+    index.size = 0;
+}
+
+void BundleMap::FreeIndex(NodeIndex &index)
+{
+    AdapterFree(index.slots);
+    index.capacity = 0;
+    index.size = 0;
 }
 
 void BundleMap::Add(BundleInfo *bundleInfo)
@@ -56,21 +356,53 @@ void BundleMap::Add(BundleInfo *bundleInfo)
     if ((bundleInfo == nullptr) || (bundleInfo->bundleName == nullptr)) {
         return;
     }
+    uint32_t hash = HashBundleName(bundleInfo->bundleName);
+    BundleEntry *entry = CreateEntry(bundleInfo);
+    if (entry == nullptr) {
+        return;
+    }
+    AcquireWriteLock();
+    if (FindNode(bundleInfo->bundleName, hash) != nullptr) {
+        ReleaseLock();
+        delete entry;
+        return;
+    }
+    uint32_t size = bundleInfos_->Size();
+    bundleInfos_->PushFront(entry);
+    if (bundleInfos_->Size() == size) {
+        ReleaseLock();
+        delete entry;
+        return;
+    }
+    if (!InsertIndex(nameIndex_, bundleInfos_->Begin(), hash)) {
+        bundleInfos_->Remove(bundleInfos_->Begin());
+        ReleaseLock();
+        delete entry;
+        return;
+    }
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    MutexAcquire(&g_bundleListMutex, 0);
+    if (!ReserveAbilityIndex(bundleInfo) || !InsertUidIndex(bundleInfos_->Begin())) {
+        EraseIndex(nameIndex_, bundleInfos_->Begin(), hash);
+        bundleInfos_->Remove(bundleInfos_->Begin());
+        ReleaseLock();
+        delete entry;
+        return;
+    }
+    InsertMetaDataIndex(bundleInfos_->Begin());
+    InsertKeepAliveIndex(bundleInfos_->Begin());
+    InsertAbilityIndex(bundleInfos_->Begin());
+    RecordChange(bundleInfo->bundleName);
 #else
-    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
-#endif
-    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfo *info = node->value_;
-        if (info != nullptr && info->bundleName != nullptr && strcmp(info->bundleName, bundleInfo->bundleName) == 0) {
-            MutexRelease(&g_bundleListMutex);
-            return;
-        }
+    if (!ReserveSkillIndex(bundleInfo)) {
+        EraseIndex(nameIndex_, bundleInfos_->Begin(), hash);
+        bundleInfos_->Remove(bundleInfos_->Begin());
+        ReleaseLock();
+        delete entry;
+        return;
     }
-    bundleInfos_->PushFront(bundleInfo);
-    MutexRelease(&g_bundleListMutex);
-    return;
+    InsertSkillIndex(bundleInfos_->Begin());
+#endif
+    ReleaseLock();
 }
 
 bool BundleMap::Update(BundleInfo *bundleInfo)
@@ -78,56 +410,106 @@ bool BundleMap::Update(BundleInfo *bundleInfo)
     if ((bundleInfo == nullptr) || (bundleInfo->bundleName == nullptr)) {
         return false;
     }
+    uint32_t hash = HashBundleName(bundleInfo->bundleName);
+    BundleEntry *entry = CreateEntry(bundleInfo);
+    if (entry == nullptr) {
+        return false;
+    }
+    AcquireWriteLock();
+    Node<BundleEntry *> *oldNode = FindNode(bundleInfo->bundleName, hash);
+    if (oldNode != nullptr) {
+        // the old info is retired here and freed once the last BundleInfoRef pinning it is released
+        BundleEntry *oldEntry = oldNode->value_;
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    MutexAcquire(&g_bundleListMutex, 0);
+        if (!ReserveAbilityIndex(bundleInfo)) {
+            ReleaseLock();
+            delete entry;
+            return false;
+        }
+        // the freed slot keeps the reinsertion from growing the index, so it cannot fail
+        EraseUidIndex(oldNode, oldEntry->info->uid);
+        EraseMetaDataIndex(oldNode, oldEntry->info);
+        EraseKeepAliveIndex(oldNode);
+        EraseAbilityIndex(oldNode, oldEntry->info);
+        oldNode->value_ = entry;
+        (void) InsertUidIndex(oldNode);
+        InsertMetaDataIndex(oldNode);
+        InsertKeepAliveIndex(oldNode);
+        InsertAbilityIndex(oldNode);
+        RecordChange(bundleInfo->bundleName);
 #else
-    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
+        if (!ReserveSkillIndex(bundleInfo)) {
+            ReleaseLock();
+            delete entry;
+            return false;
+        }
+        EraseSkillIndex(oldNode, oldEntry->info);
+        oldNode->value_ = entry;
+        InsertSkillIndex(oldNode);
 #endif
-    auto newNode = new (std::nothrow) Node<BundleInfo *>(bundleInfo);
-    if (newNode == nullptr) {
-        MutexRelease(&g_bundleListMutex);
+        bool isLast = UnrefEntry(oldEntry);
+        ReleaseLock();
+        if (isLast) {
+            FreeEntry(oldEntry);
+        }
+        return true;
+    }
+    uint32_t size = bundleInfos_->Size();
+    bundleInfos_->PushFront(entry);
+    if (bundleInfos_->Size() == size) {
+        ReleaseLock();
+        delete entry;
         return false;
     }
-    for (auto oldNode = bundleInfos_->Begin(); oldNode != bundleInfos_->End(); oldNode = oldNode->next_) {
-        BundleInfo *info = oldNode->value_;
-        if ((info != nullptr) && (info->bundleName != nullptr) &&
-            (strcmp(info->bundleName, bundleInfo->bundleName) == 0)) {
-            oldNode->prev_->next_ = newNode;
-            oldNode->next_->prev_ = newNode;
-            newNode->prev_ = oldNode->prev_;
-            newNode->next_ = oldNode->next_;
-            BundleInfoUtils::FreeBundleInfo(info);
-            delete oldNode;
-            MutexRelease(&g_bundleListMutex);
-            return true;
-        }
+    Node<BundleEntry *> *newNode = bundleInfos_->Begin();
+    if (!InsertIndex(nameIndex_, newNode, hash)) {
+        bundleInfos_->Remove(newNode);
+        ReleaseLock();
+        delete entry;
+        return false;
     }
-    delete newNode;
-    bundleInfos_->PushFront(bundleInfo);
-    MutexRelease(&g_bundleListMutex);
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+    if (!ReserveAbilityIndex(bundleInfo) || !InsertUidIndex(newNode)) {
+        EraseIndex(nameIndex_, newNode, hash);
+        bundleInfos_->Remove(newNode);
+        ReleaseLock();
+        delete entry;
+        return false;
+    }
+    InsertMetaDataIndex(newNode);
+    InsertKeepAliveIndex(newNode);
+    InsertAbilityIndex(newNode);
+    RecordChange(bundleInfo->bundleName);
+#else
+    if (!ReserveSkillIndex(bundleInfo)) {
+        EraseIndex(nameIndex_, newNode, hash);
+        bundleInfos_->Remove(newNode);
+        ReleaseLock();
+        delete entry;
+        return false;
+    }
+    InsertSkillIndex(newNode);
+#endif
+    ReleaseLock();
     return true;
 }
 
-BundleInfo *BundleMap::Get(const char *bundleName) const
+BundleInfoRef BundleMap::Get(const char *bundleName) const
 {
     if (bundleName == nullptr) {
-        return nullptr;
+        return BundleInfoRef();
     }
-
-#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    MutexAcquire(&g_bundleListMutex, 0);
-#else
-    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
-#endif
-    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfo *info = node->value_;
-        if (info != nullptr && info->bundleName != nullptr && strcmp(info->bundleName, bundleName) == 0) {
-            MutexRelease(&g_bundleListMutex);
-            return info;
-        }
+    uint32_t hash = HashBundleName(bundleName);
+    AcquireReadLock();
+    Node<BundleEntry *> *node = FindNode(bundleName, hash);
+    if (node == nullptr) {
+        ReleaseLock();
+        return BundleInfoRef();
     }
-    MutexRelease(&g_bundleListMutex);
-    return nullptr;
+    RefEntry(node->value_);
+    BundleInfoRef ref(node->value_);
+    ReleaseLock();
+    return ref;
 }
 
 void BundleMap::GetCopyBundleInfo(uint32_t flags, const BundleInfo *bundleInfo, BundleInfo &newBundleInfo) const
@@ -176,13 +558,9 @@ uint8_t BundleMap::GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32
     if (bundleInfos == nullptr) {
         return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
     }
-#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    MutexAcquire(&g_bundleListMutex, 0);
-#else
-    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
-#endif
+    AcquireReadLock();
     if (bundleInfos_->IsEmpty()) {
-        MutexRelease(&g_bundleListMutex);
+        ReleaseLock();
         return ERR_APPEXECFWK_QUERY_NO_INFOS;
     }
 
@@ -190,17 +568,17 @@ uint8_t BundleMap::GetBundleInfos(int32_t flags, BundleInfo **bundleInfos, int32
     if (infos == nullptr || memset_s(infos, sizeof(BundleInfo) * bundleInfos_->Size(), 0,
         sizeof(BundleInfo) * bundleInfos_->Size()) != EOK) {
         AdapterFree(infos);
-        MutexRelease(&g_bundleListMutex);
+        ReleaseLock();
         return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
     }
     *bundleInfos = infos;
 
     for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfoUtils::CopyBundleInfo(flags, infos++, *(node->value_));
+        BundleInfoUtils::CopyBundleInfo(flags, infos++, *(node->value_->info));
     }
 
     *len = bundleInfos_->Size();
-    MutexRelease(&g_bundleListMutex);
+    ReleaseLock();
     return ERR_OK;
 }
 
@@ -210,7 +588,7 @@ uint8_t BundleMap::GetBundleInfosInner(List<BundleInfo *> &bundleInfos) const
         return ERR_APPEXECFWK_QUERY_NO_INFOS;
     }
     for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        bundleInfos.PushBack(node->value_);
+        bundleInfos.PushBack(node->value_->info);
     }
     return ERR_OK;
 }
@@ -220,13 +598,9 @@ uint8_t BundleMap::GetBundleInfosNoReplication(int32_t flags, BundleInfo **bundl
     if (bundleInfos == nullptr) {
         return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
     }
-#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    MutexAcquire(&g_bundleListMutex, 0);
-#else
-    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
-#endif
+    AcquireReadLock();
     if (bundleInfos_->IsEmpty()) {
-        MutexRelease(&g_bundleListMutex);
+        ReleaseLock();
         return ERR_APPEXECFWK_QUERY_NO_INFOS;
     }
 
@@ -234,32 +608,39 @@ uint8_t BundleMap::GetBundleInfosNoReplication(int32_t flags, BundleInfo **bundl
     if (infos == nullptr || memset_s(infos, sizeof(BundleInfo) * bundleInfos_->Size(), 0,
         sizeof(BundleInfo) * bundleInfos_->Size()) != EOK) {
         AdapterFree(infos);
-        MutexRelease(&g_bundleListMutex);
+        ReleaseLock();
         return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
     }
     *bundleInfos = infos;
 
     for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfoUtils::CopyBundleInfoNoReplication(flags, infos++, *(node->value_));
+        BundleInfoUtils::CopyBundleInfoNoReplication(flags, infos++, *(node->value_->info));
     }
 
     *len = bundleInfos_->Size();
-    MutexRelease(&g_bundleListMutex);
+    ReleaseLock();
     return ERR_OK;
 }
 
 uint8_t BundleMap::GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo) const
+{
+    BundleInfoRef pin;
+    return GetBundleInfo(bundleName, flags, bundleInfo, pin);
+}
+
+uint8_t BundleMap::GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo,
+    BundleInfoRef &pin) const
 {
     if (bundleName == nullptr) {
         return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
     }
 
-    BundleInfo *specialBundleInfo = Get(bundleName);
-    if (specialBundleInfo == nullptr) {
+    pin = Get(bundleName);
+    if (pin == nullptr) {
         return ERR_APPEXECFWK_QUERY_NO_INFOS;
     }
 
-    GetCopyBundleInfo(flags, specialBundleInfo, bundleInfo);
+    GetCopyBundleInfo(flags, pin.Get(), bundleInfo);
     return ERR_OK;
 }
 
@@ -268,34 +649,517 @@ void BundleMap::Erase(const char *bundleName)
     if (bundleName == nullptr) {
         return;
     }
+    uint32_t hash = HashBundleName(bundleName);
+    AcquireWriteLock();
+    Node<BundleEntry *> *node = FindNode(bundleName, hash);
+    if (node == nullptr) {
+        ReleaseLock();
+        return;
+    }
+    BundleEntry *entry = node->value_;
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    MutexAcquire(&g_bundleListMutex, 0);
+    RecordChange(bundleName);
+    EraseUidIndex(node, entry->info->uid);
+    EraseMetaDataIndex(node, entry->info);
+    EraseKeepAliveIndex(node);
+    EraseAbilityIndex(node, entry->info);
 #else
-    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
+    EraseSkillIndex(node, entry->info);
 #endif
-    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfo *info = node->value_;
-        if (info->bundleName != nullptr && strcmp(info->bundleName, bundleName) == 0) {
-            BundleInfoUtils::FreeBundleInfo(info);
-            bundleInfos_->Remove(node);
-            MutexRelease(&g_bundleListMutex);
-            return;
-        }
+    EraseIndex(nameIndex_, node, hash);
+    bundleInfos_->Remove(node);
+    bool isLast = UnrefEntry(entry);
+    ReleaseLock();
+    if (isLast) {
+        FreeEntry(entry);
     }
-    MutexRelease(&g_bundleListMutex);
 }
 
 void BundleMap::EraseAll()
 {
+    AcquireWriteLock();
+    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
+        if (UnrefEntry(node->value_)) {
+            FreeEntry(node->value_);
+        }
+    }
+    bundleInfos_->RemoveAll();
+    ClearIndex(nameIndex_);
 #ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
-    MutexAcquire(&g_bundleListMutex, 0);
+    ClearIndex(uidIndex_);
+    metaDataIndex_.clear();
+    keepAliveNodes_.clear();
+    ClearIndex(abilityIndex_);
+    // the erased names are not journaled, every older generation has to fetch the full list again
+    generation_++;
+    ClearChangeRecords();
 #else
-    MutexAcquire(&g_bundleListMutex, BUNDLELIST_MUTEX_TIMEOUT);
+    ClearIndex(skillIndex_);
 #endif
-    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfoUtils::FreeBundleInfo(node->value_);
+    ReleaseLock();
+}
+
+#ifdef OHOS_APPEXECFWK_BMS_BUNDLEMANAGER
+void BundleMap::RecordChange(const char *bundleName)
+{
+    generation_++;
+    ChangeRecord &record = changeRecords_[nextChangeRecord_];
+    AdapterFree(record.bundleName);
+    record.bundleName = Utils::Strdup(bundleName);
+    if (record.bundleName == nullptr) {
+        // a change that cannot be replayed leaves no older generation covered
+        ClearChangeRecords();
+        return;
+    }
+    record.generation = generation_;
+    nextChangeRecord_ = (nextChangeRecord_ + 1) % MAX_CHANGE_RECORD_NUM;
+    if (numOfChangeRecord_ < MAX_CHANGE_RECORD_NUM) {
+        ++numOfChangeRecord_;
+    }
+}
+
+void BundleMap::ClearChangeRecords()
+{
+    for (uint32_t i = 0; i < MAX_CHANGE_RECORD_NUM; ++i) {
+        AdapterFree(changeRecords_[i].bundleName);
+        changeRecords_[i].generation = 0;
+    }
+    nextChangeRecord_ = 0;
+    numOfChangeRecord_ = 0;
+}
+
+bool BundleMap::IsCoveredByJournal(uint64_t generation) const
+{
+    if (generation >= generation_) {
+        return generation == generation_;
+    }
+    if (numOfChangeRecord_ == 0) {
+        return false;
+    }
+    // the journal holds consecutive generations, so it covers every one from just before its oldest record
+    uint32_t oldest = (nextChangeRecord_ + MAX_CHANGE_RECORD_NUM - numOfChangeRecord_) % MAX_CHANGE_RECORD_NUM;
+    return generation + 1 >= changeRecords_[oldest].generation;
+}
+
+uint32_t BundleMap::HashUid(int32_t uid)
+{
+    // fibonacci hashing spreads the consecutive uids handed out by the installer over the whole table
+    return static_cast<uint32_t>(uid) * GOLDEN_RATIO_32;
+}
+
+Node<BundleEntry *> *BundleMap::FindNodeByUid(int32_t uid, uint32_t hash) const
+{
+    if (uidIndex_.slots == nullptr) {
+        return nullptr;
+    }
+    uint32_t mask = uidIndex_.capacity - 1;
+    for (uint32_t i = hash & mask; uidIndex_.slots[i].node != nullptr; i = (i + 1) & mask) {
+        if (uidIndex_.slots[i].hash == hash && uidIndex_.slots[i].node->value_->info->uid == uid) {
+            return uidIndex_.slots[i].node;
+        }
+    }
+    return nullptr;
+}
+
+bool BundleMap::InsertUidIndex(Node<BundleEntry *> *node)
+{
+    return InsertIndex(uidIndex_, node, HashUid(node->value_->info->uid));
+}
+
+void BundleMap::EraseUidIndex(const Node<BundleEntry *> *node, int32_t uid)
+{
+    EraseIndex(uidIndex_, node, HashUid(uid));
+}
+
+uint8_t BundleMap::GetBundleNameForUid(int32_t uid, char **bundleName) const
+{
+    if (bundleName == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    uint32_t hash = HashUid(uid);
+    AcquireReadLock();
+    Node<BundleEntry *> *node = FindNodeByUid(uid, hash);
+    if (node == nullptr) {
+        ReleaseLock();
+        return ERR_APPEXECFWK_NO_BUNDLENAME_FOR_UID;
+    }
+    *bundleName = Utils::Strdup(node->value_->info->bundleName);
+    ReleaseLock();
+    return (*bundleName == nullptr) ? ERR_APPEXECFWK_NO_BUNDLENAME_FOR_UID : ERR_OK;
+}
+
+void BundleMap::InsertMetaDataIndex(Node<BundleEntry *> *node)
+{
+    const BundleInfo *bundleInfo = node->value_->info;
+    for (int32_t i = 0; i < bundleInfo->numOfModule; i++) {
+        for (int32_t j = 0; j < METADATA_SIZE; j++) {
+            const MetaData *metaData = bundleInfo->moduleInfos[i].metaData[j];
+            if (metaData == nullptr || metaData->name == nullptr) {
+                continue;
+            }
+            // the names of one bundle are indexed in a row, so a repeated name finds the bundle at the back
+            std::vector<Node<BundleEntry *> *> &nodes = metaDataIndex_[metaData->name];
+            if (nodes.empty() || nodes.back() != node) {
+                nodes.push_back(node);
+            }
+        }
+    }
+}
+
+void BundleMap::EraseMetaDataIndex(const Node<BundleEntry *> *node, const BundleInfo *bundleInfo)
+{
+    for (int32_t i = 0; i < bundleInfo->numOfModule; i++) {
+        for (int32_t j = 0; j < METADATA_SIZE; j++) {
+            const MetaData *metaData = bundleInfo->moduleInfos[i].metaData[j];
+            if (metaData == nullptr || metaData->name == nullptr) {
+                continue;
+            }
+            auto it = metaDataIndex_.find(metaData->name);
+            if (it == metaDataIndex_.end()) {
+                continue;
+            }
+            auto pos = std::find(it->second.begin(), it->second.end(), node);
+            if (pos != it->second.end()) {
+                it->second.erase(pos);
+            }
+            if (it->second.empty()) {
+                metaDataIndex_.erase(it);
+            }
+        }
+    }
+}
+
+uint8_t BundleMap::GetBundleInfosByMetaData(const char *metaDataKey, BundleInfo **bundleInfos, int32_t *len) const
+{
+    if (metaDataKey == nullptr || bundleInfos == nullptr || len == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    AcquireReadLock();
+    auto it = metaDataIndex_.find(metaDataKey);
+    if (it == metaDataIndex_.end()) {
+        ReleaseLock();
+        return ERR_APPEXECFWK_QUERY_NO_INFOS;
+    }
+    uint8_t errorCode = CopyBundleInfos(it->second, bundleInfos, len);
+    ReleaseLock();
+    return errorCode;
+}
+
+void BundleMap::InsertKeepAliveIndex(Node<BundleEntry *> *node)
+{
+    const BundleInfo *bundleInfo = node->value_->info;
+    if (bundleInfo->isKeepAlive && bundleInfo->isSystemApp) {
+        keepAliveNodes_.push_back(node);
+    }
+}
+
+void BundleMap::EraseKeepAliveIndex(const Node<BundleEntry *> *node)
+{
+    auto pos = std::find(keepAliveNodes_.begin(), keepAliveNodes_.end(), node);
+    if (pos != keepAliveNodes_.end()) {
+        keepAliveNodes_.erase(pos);
+    }
+}
+
+uint8_t BundleMap::GetKeepAliveBundleInfos(BundleInfo **bundleInfos, int32_t *len) const
+{
+    if (bundleInfos == nullptr || len == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    AcquireReadLock();
+    if (keepAliveNodes_.empty()) {
+        ReleaseLock();
+        return ERR_APPEXECFWK_QUERY_NO_INFOS;
+    }
+    uint8_t errorCode = CopyBundleInfos(keepAliveNodes_, bundleInfos, len);
+    ReleaseLock();
+    return errorCode;
+}
+
+uint32_t BundleMap::HashAbility(const char *bundleName, const char *abilityName)
+{
+    // the terminating zero of the bundle name keeps "a" + "bc" apart from "ab" + "c"
+    uint32_t hash = HashString(bundleName, FNV_OFFSET_BASIS) * FNV_PRIME;
+    return HashString(abilityName, hash);
+}
+
+// grows the ability index ahead of a mutation so that indexing the abilities of the bundle cannot fail midway
+bool BundleMap::ReserveAbilityIndex(const BundleInfo *bundleInfo)
+{
+    if (bundleInfo->abilityInfos == nullptr || bundleInfo->numOfAbility <= 0) {
+        return true;
+    }
+    return ReserveIndex(abilityIndex_, abilityIndex_.size + static_cast<uint32_t>(bundleInfo->numOfAbility));
+}
+
+void BundleMap::InsertAbilityIndex(Node<BundleEntry *> *node)
+{
+    const BundleInfo *bundleInfo = node->value_->info;
+    if (bundleInfo->abilityInfos == nullptr) {
+        return;
+    }
+    for (int32_t i = 0; i < bundleInfo->numOfAbility; i++) {
+        if (bundleInfo->abilityInfos[i].name != nullptr) {
+            (void) InsertIndex(abilityIndex_, node, HashAbility(bundleInfo->bundleName,
+                bundleInfo->abilityInfos[i].name), i);
+        }
     }
-    bundleInfos_->RemoveAll();
-    MutexRelease(&g_bundleListMutex);
 }
+
+void BundleMap::EraseAbilityIndex(const Node<BundleEntry *> *node, const BundleInfo *bundleInfo)
+{
+    if (bundleInfo->abilityInfos == nullptr) {
+        return;
+    }
+    for (int32_t i = 0; i < bundleInfo->numOfAbility; i++) {
+        if (bundleInfo->abilityInfos[i].name != nullptr) {
+            EraseIndex(abilityIndex_, node, HashAbility(bundleInfo->bundleName, bundleInfo->abilityInfos[i].name), i);
+        }
+    }
+}
+
+uint8_t BundleMap::QueryAbilityInfo(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo) const
+{
+    if (bundleName == nullptr || abilityName == nullptr || abilityInfo == nullptr) {
+        return ERR_APPEXECFWK_QUERY_NO_INFOS;
+    }
+    uint32_t hash = HashAbility(bundleName, abilityName);
+    AcquireReadLock();
+    if (abilityIndex_.slots == nullptr) {
+        ReleaseLock();
+        return ERR_APPEXECFWK_QUERY_NO_INFOS;
+    }
+    uint32_t mask = abilityIndex_.capacity - 1;
+    for (uint32_t i = hash & mask; abilityIndex_.slots[i].node != nullptr; i = (i + 1) & mask) {
+        if (abilityIndex_.slots[i].hash != hash) {
+            continue;
+        }
+        const BundleInfo *info = abilityIndex_.slots[i].node->value_->info;
+        const AbilityInfo &ability = info->abilityInfos[abilityIndex_.slots[i].ordinal];
+        if (strcmp(info->bundleName, bundleName) == 0 && strcmp(ability.name, abilityName) == 0) {
+            AbilityInfoUtils::CopyAbilityInfo(abilityInfo, ability);
+            ReleaseLock();
+            return ERR_OK;
+        }
+    }
+    ReleaseLock();
+    return ERR_APPEXECFWK_QUERY_NO_INFOS;
+}
+
+// the caller holds the read lock, every node is copied once together with its abilities
+uint8_t BundleMap::CopyBundleInfos(const std::vector<Node<BundleEntry *> *> &nodes, BundleInfo **bundleInfos,
+    int32_t *len)
+{
+    uint32_t size = sizeof(BundleInfo) * nodes.size();
+    BundleInfo *infos = reinterpret_cast<BundleInfo *>(AdapterMalloc(size));
+    if (infos == nullptr || memset_s(infos, size, 0, size) != EOK) {
+        AdapterFree(infos);
+        return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
+    }
+    for (uint32_t i = 0; i < nodes.size(); i++) {
+        BundleInfoUtils::CopyBundleInfo(GET_BUNDLE_WITH_ABILITIES, infos + i, *(nodes[i]->value_->info));
+    }
+    *bundleInfos = infos;
+    *len = static_cast<int32_t>(nodes.size());
+    return ERR_OK;
+}
+
+uint64_t BundleMap::GetGeneration() const
+{
+    AcquireReadLock();
+    uint64_t generation = generation_;
+    ReleaseLock();
+    return generation;
+}
+
+bool BundleMap::GetBundleInfosChangedSince(uint64_t generation, int32_t flags, BundleInfo **bundleInfos,
+    int32_t *len, std::vector<std::string> &removedBundleNames, uint64_t *currentGeneration) const
+{
+    if (bundleInfos == nullptr || len == nullptr || currentGeneration == nullptr) {
+        return false;
+    }
+    *bundleInfos = nullptr;
+    *len = 0;
+    AcquireReadLock();
+    *currentGeneration = generation_;
+    if (!IsCoveredByJournal(generation)) {
+        ReleaseLock();
+        return false;
+    }
+    // newest first, so each bundle is reported once with its current state
+    const char *changedNames[MAX_CHANGE_RECORD_NUM] = { nullptr };
+    uint32_t numOfChanged = 0;
+    for (uint32_t i = 1; i <= numOfChangeRecord_; ++i) {
+        const ChangeRecord &record =
+            changeRecords_[(nextChangeRecord_ + MAX_CHANGE_RECORD_NUM - i) % MAX_CHANGE_RECORD_NUM];
+        if (record.generation <= generation) {
+            break;
+        }
+        bool isListed = false;
+        for (uint32_t j = 0; j < numOfChanged && !isListed; ++j) {
+            isListed = (strcmp(changedNames[j], record.bundleName) == 0);
+        }
+        if (!isListed) {
+            changedNames[numOfChanged++] = record.bundleName;
+        }
+    }
+    BundleInfo *infos = nullptr;
+    if (numOfChanged != 0) {
+        infos = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo) * numOfChanged));
+        if (infos == nullptr ||
+            memset_s(infos, sizeof(BundleInfo) * numOfChanged, 0, sizeof(BundleInfo) * numOfChanged) != EOK) {
+            AdapterFree(infos);
+            ReleaseLock();
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < numOfChanged; ++i) {
+        Node<BundleEntry *> *node = FindNode(changedNames[i], HashBundleName(changedNames[i]));
+        if (node == nullptr) {
+            removedBundleNames.emplace_back(changedNames[i]);
+            continue;
+        }
+        BundleInfoUtils::CopyBundleInfo(flags, infos + *len, *(node->value_->info));
+        ++(*len);
+    }
+    ReleaseLock();
+    if (*len == 0) {
+        AdapterFree(infos);
+    }
+    *bundleInfos = infos;
+    return true;
+}
+#else
+// the slots of an ability name each of its skill items, ordered by item type, skill and position in the skill
+const int32_t SKILL_ITEM_NUM = SKILL_SIZE * MAX_SKILL_ITEM;
+
+// visits the items a skill match looks at, which ends at the first empty skill and at the first empty item
+template<typename Visitor>
+static void ForEachSkillItem(const AbilityInfo *abilityInfo, Visitor visit)
+{
+    if (abilityInfo == nullptr) {
+        return;
+    }
+    for (int32_t i = 0; i < SKILL_SIZE && abilityInfo->skills[i] != nullptr; i++) {
+        const Skill *skill = abilityInfo->skills[i];
+        for (int32_t j = 0; j < MAX_SKILL_ITEM && skill->actions[j] != nullptr; j++) {
+            visit(skill->actions[j], i * MAX_SKILL_ITEM + j);
+        }
+        for (int32_t j = 0; j < MAX_SKILL_ITEM && skill->entities[j] != nullptr; j++) {
+            visit(skill->entities[j], SKILL_ITEM_NUM + i * MAX_SKILL_ITEM + j);
+        }
+    }
+}
+
+uint32_t BundleMap::HashSkillItem(const char *item, int32_t type)
+{
+    return HashString(item, FNV_OFFSET_BASIS + static_cast<uint32_t>(type));
+}
+
+const char *BundleMap::GetSkillItem(const AbilityInfo *abilityInfo, int32_t ordinal)
+{
+    int32_t position = ordinal % SKILL_ITEM_NUM;
+    const Skill *skill = abilityInfo->skills[position / MAX_SKILL_ITEM];
+    return (ordinal < SKILL_ITEM_NUM) ? skill->actions[position % MAX_SKILL_ITEM] :
+        skill->entities[position % MAX_SKILL_ITEM];
+}
+
+// grows the skill index ahead of a mutation so that indexing the skills of the bundle cannot fail midway
+bool BundleMap::ReserveSkillIndex(const BundleInfo *bundleInfo)
+{
+    uint32_t numOfItem = 0;
+    ForEachSkillItem(bundleInfo->abilityInfo, [&numOfItem](const char *, int32_t) { numOfItem++; });
+    return (numOfItem == 0) || ReserveIndex(skillIndex_, skillIndex_.size + numOfItem);
+}
+
+void BundleMap::InsertSkillIndex(Node<BundleEntry *> *node)
+{
+    ForEachSkillItem(node->value_->info->abilityInfo, [this, node](const char *item, int32_t ordinal) {
+        int32_t type = (ordinal < SKILL_ITEM_NUM) ? SKILL_ACTION : SKILL_ENTITY;
+        (void) InsertIndex(skillIndex_, node, HashSkillItem(item, type), ordinal);
+    });
+}
+
+void BundleMap::EraseSkillIndex(const Node<BundleEntry *> *node, const BundleInfo *bundleInfo)
+{
+    ForEachSkillItem(bundleInfo->abilityInfo, [this, node](const char *item, int32_t ordinal) {
+        int32_t type = (ordinal < SKILL_ITEM_NUM) ? SKILL_ACTION : SKILL_ENTITY;
+        EraseIndex(skillIndex_, node, HashSkillItem(item, type), ordinal);
+    });
+}
+
+void BundleMap::CollectSkillMatches(const char *item, int32_t type, List<BundleInfo *> &bundleInfos) const
+{
+    if (skillIndex_.slots == nullptr) {
+        return;
+    }
+    uint32_t hash = HashSkillItem(item, type);
+    uint32_t mask = skillIndex_.capacity - 1;
+    for (uint32_t i = hash & mask; skillIndex_.slots[i].node != nullptr; i = (i + 1) & mask) {
+        const IndexSlot &slot = skillIndex_.slots[i];
+        int32_t slotType = (slot.ordinal < SKILL_ITEM_NUM) ? SKILL_ACTION : SKILL_ENTITY;
+        BundleInfo *info = slot.node->value_->info;
+        if (slot.hash != hash || slotType != type ||
+            strcmp(GetSkillItem(info->abilityInfo, slot.ordinal), item) != 0) {
+            continue;
+        }
+        // a bundle listing the item in several skills, or matching both the action and the entity, is added once
+        bool isListed = false;
+        for (auto node = bundleInfos.Begin(); node != bundleInfos.End() && !isListed; node = node->next_) {
+            isListed = (node->value_ == info);
+        }
+        if (!isListed) {
+            bundleInfos.PushBack(info);
+        }
+    }
+}
+
+uint8_t BundleMap::GetAbilityInfosBySkill(const char *action, const char *entity, AbilityInfo **abilityInfos,
+    int32_t *len) const
+{
+    if (abilityInfos == nullptr || len == nullptr) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    // the abilities are copied before the lock is released, an uninstall frees the infos of the bundle right after
+    AcquireReadLock();
+    List<BundleInfo *> matches;
+    if (entity == nullptr) {
+        // a want without entity matches every skill, so every bundle whose ability declares a skill is returned
+        for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
+            const AbilityInfo *abilityInfo = node->value_->info->abilityInfo;
+            if (abilityInfo != nullptr && abilityInfo->skills[0] != nullptr) {
+                matches.PushBack(node->value_->info);
+            }
+        }
+    } else {
+        if (action != nullptr) {
+            CollectSkillMatches(action, SKILL_ACTION, matches);
+        }
+        CollectSkillMatches(entity, SKILL_ENTITY, matches);
+    }
+    int32_t matchNum = static_cast<int32_t>(matches.Size());
+    AbilityInfo *infos = reinterpret_cast<AbilityInfo *>(AdapterMalloc(sizeof(AbilityInfo) * matchNum));
+    if (infos == nullptr ||
+        memset_s(infos, sizeof(AbilityInfo) * matchNum, 0, sizeof(AbilityInfo) * matchNum) != EOK) {
+        AdapterFree(infos);
+        ReleaseLock();
+        return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
+    }
+    *abilityInfos = infos;
+    // the index yields the matches in probe order, they are handed out in the order of the bundle list as when
+    // every bundle was matched in turn; a copied match is dropped, so the matches still pending stay few
+    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End() && !matches.IsEmpty(); node = node->next_) {
+        for (auto match = matches.Begin(); match != matches.End(); match = match->next_) {
+            if (match->value_ == node->value_->info) {
+                AbilityInfoUtils::CopyAbilityInfo(infos++, *(match->value_->abilityInfo));
+                matches.Remove(match);
+                break;
+            }
+        }
+    }
+    *len = matchNum;
+    ReleaseLock();
+    return ERR_OK;
+}
+#endif
 }  // namespace OHOS
@@ -15,25 +15,29 @@
 
 #include "bundle_ms_feature.h"
 
-#include "ability_info_utils.h"
+#include <pthread.h>
+#include <unistd.h>
+
 #include "appexecfwk_errors.h"
+#include "bundle_info_cursor.h"
 #include "bundle_info_utils.h"
 #include "bundle_inner_interface.h"
 #include "bundle_manager_service.h"
 #include "bundle_message_id.h"
-#include "convert_utils.h"
 #include "ipc_skeleton.h"
 #include "bundle_log.h"
 #include "message.h"
+#include "parcel_utils.h"
 #include "ohos_init.h"
 #include "samgr_lite.h"
 #include "securec.h"
+#include "shared_memory_utils.h"
 #include "utils.h"
 #include "want_utils.h"
 
 namespace OHOS {
 #ifdef __LINUX__
-constexpr static uint32_t MAX_IPC_STRING_LENGTH = 8192UL;
+constexpr static uint32_t MAX_IPC_PARCEL_LENGTH = 8192UL;
 #endif
 static BmsImpl g_bmsImpl = {
     SERVER_IPROXY_IMPL_BEGIN,
@@ -160,6 +164,117 @@ uint8_t BundleMsFeature::GetSystemAvailableCapabilities(const uint8_t funcId, Ip
     return errorCode;
 }
 
+// writes the marshalled infos after the result code and frees the buffer
+static uint8_t WriteParcel(IpcIo *reply, uint8_t *buff, uint32_t size)
+{
+    if (buff == nullptr) {
+        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+    }
+#ifdef __LINUX__
+    if (size > MAX_IPC_PARCEL_LENGTH) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS parcel of %{public}u bytes is too large to be transformed by ipc", size);
+        AdapterFree(buff);
+        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+    }
+#endif
+    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
+    WriteUint32(reply, size);
+    WriteBuffer(reply, buff, size);
+    AdapterFree(buff);
+    return OHOS_SUCCESS;
+}
+
+#ifdef __LINUX__
+// a descriptor written into the reply is only duplicated into the client once the reply is sent after the handler
+// returns. an ipc thread sends its reply before it takes the next request, so the region of its last reply is
+// closed when the same thread writes another one, at most one region per ipc thread is open at a time
+static thread_local int32_t g_pendingRegion = -1;
+
+static void KeepRegionUntilSent(int32_t fd)
+{
+    if (g_pendingRegion >= 0) {
+        close(g_pendingRegion);
+    }
+    g_pendingRegion = fd;
+}
+
+// infos too large for the ipc buffer are marshalled straight into shared memory and only its descriptor is sent
+static int32_t CreateSharedParcel(const BundleInfo *bundleInfos, int32_t length, uint32_t size)
+{
+    uint8_t *addr = nullptr;
+    int32_t fd = SharedMemoryUtils::CreateRegion(size, &addr);
+    if (fd < 0) {
+        return -1;
+    }
+    bool isMarshalled = ParcelUtils::MarshallingBundleInfos(bundleInfos, length, addr, size);
+    if (!SharedMemoryUtils::SealRegion(fd, addr, size) || !isMarshalled) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+#endif
+
+// writes the result code, the generation when given, the number of infos and then their parcel, either inline or
+// by shared memory when it is too large for the ipc buffer
+static uint8_t WriteBundleInfos(IpcIo *reply, const BundleInfo *bundleInfos, int32_t length, const uint64_t *generation)
+{
+    uint32_t size = ParcelUtils::GetBundleInfosSize(bundleInfos, length);
+    if (size == 0) {
+        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+    }
+#ifdef __LINUX__
+    if (size > MAX_IPC_PARCEL_LENGTH) {
+        int32_t fd = CreateSharedParcel(bundleInfos, length, size);
+        if (fd < 0) {
+            return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+        }
+        WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
+        if (generation != nullptr) {
+            WriteUint64(reply, *generation);
+        }
+        WriteInt32(reply, length);
+        WriteUint8(reply, PARCEL_SHARED_MEMORY);
+        WriteUint32(reply, size);
+        if (!WriteFileDescriptor(reply, static_cast<uint32_t>(fd))) {
+            HILOG_ERROR(HILOG_MODULE_APP, "BundleMS write shared memory descriptor failed");
+            close(fd);
+            return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+        }
+        HILOG_INFO(HILOG_MODULE_APP, "BundleMS %{public}d bundleInfos of %{public}u bytes sent by shared memory",
+            length, size);
+        KeepRegionUntilSent(fd);
+        return OHOS_SUCCESS;
+    }
+#endif
+    uint8_t *buff = reinterpret_cast<uint8_t *>(AdapterMalloc(size));
+    if (buff == nullptr) {
+        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+    }
+    if (!ParcelUtils::MarshallingBundleInfos(bundleInfos, length, buff, size)) {
+        AdapterFree(buff);
+        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+    }
+    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
+    if (generation != nullptr) {
+        WriteUint64(reply, *generation);
+    }
+    WriteInt32(reply, length);
+    WriteUint8(reply, PARCEL_INLINE);
+    WriteUint32(reply, size);
+    WriteBuffer(reply, buff, size);
+    AdapterFree(buff);
+    return OHOS_SUCCESS;
+}
+
+static uint8_t WriteEmptyBundleInfos(IpcIo *reply, uint64_t generation)
+{
+    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
+    WriteUint64(reply, generation);
+    WriteInt32(reply, 0);
+    return OHOS_SUCCESS;
+}
+
 uint8_t BundleMsFeature::QueryInnerAbilityInfo(const uint8_t funcId, IpcIo *req, IpcIo *reply)
 {
     if ((req == nullptr) || (reply == nullptr)) {
@@ -186,21 +301,10 @@ uint8_t BundleMsFeature::QueryInnerAbilityInfo(const uint8_t funcId, IpcIo *req,
         ClearAbilityInfo(&abilityInfo);
         return errorCode;
     }
-    char *str = ConvertUtils::ConvertAbilityInfoToString(&abilityInfo);
-    if (str == nullptr) {
-        ClearAbilityInfo(&abilityInfo);
-        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
-    }
-#ifdef __LINUX__
-    if (strlen(str) > MAX_IPC_STRING_LENGTH) {
-        ClearAbilityInfo(&abilityInfo);
-        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
-    }
-#endif
-    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
-    WriteString(reply, str);
+    uint32_t size = 0;
+    uint8_t *buff = ParcelUtils::MarshallingAbilityInfo(&abilityInfo, &size);
     ClearAbilityInfo(&abilityInfo);
-    return OHOS_SUCCESS;
+    return WriteParcel(reply, buff, size);
 }
 
 uint8_t BundleMsFeature::GetInnerBundleInfo(const uint8_t funcId, IpcIo *req, IpcIo *reply)
@@ -219,23 +323,16 @@ uint8_t BundleMsFeature::GetInnerBundleInfo(const uint8_t funcId, IpcIo *req, Ip
     }
     int32_t flag;
     ReadInt32(req, &flag);
-    uint8_t errorCode = GetBundleInfo(bundleName, flag, &bundleInfo);
+    // the copy shares its members with the installed info, keep it pinned until the reply is serialized
+    BundleInfoRef pin;
+    uint8_t errorCode = OHOS::ManagerService::GetInstance().GetBundleInfo(bundleName, flag, bundleInfo, pin);
     if (errorCode != OHOS_SUCCESS) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleMS GET_BUNDLE_INFO errorcode: %{public}d\n", errorCode);
         return errorCode;
     }
-    char *str = ConvertUtils::ConvertBundleInfoToString(&bundleInfo);
-    if (str == nullptr) {
-        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
-    }
-#ifdef __LINUX__
-    if (strlen(str) > MAX_IPC_STRING_LENGTH) {
-        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
-    }
-#endif
-    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
-    WriteString(reply, str);
-    return OHOS_SUCCESS;
+    uint32_t parcelSize = 0;
+    uint8_t *buff = ParcelUtils::MarshallingBundleInfos(&bundleInfo, 1, &parcelSize);
+    return WriteParcel(reply, buff, parcelSize);
 }
 
 uint8_t BundleMsFeature::GetInnerBundleSize(const uint8_t funcId, IpcIo *req, IpcIo *reply)
@@ -286,21 +383,103 @@ uint8_t BundleMsFeature::HandleGetBundleInfos(const uint8_t funcId, IpcIo *req,
         BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
         return errorCode;
     }
-    char *strs = ConvertUtils::ConvertBundleInfosToString(&bundleInfos, lengthOfBundleInfo);
-    if (strs == nullptr) {
-        BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
-        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+    errorCode = WriteBundleInfos(reply, bundleInfos, lengthOfBundleInfo, nullptr);
+    BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
+    return errorCode;
+}
+
+uint8_t BundleMsFeature::HandleGetBundleInfosIfModified(const uint8_t funcId, IpcIo *req, IpcIo *reply)
+{
+    if ((req == nullptr) || (reply == nullptr)) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    int32_t flag = 0;
+    uint64_t lastGeneration = 0;
+    if (!ReadInt32(req, &flag) || !ReadUint64(req, &lastGeneration)) {
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    // read before the query, a change racing with it only makes the client fetch once more
+    uint64_t generation = OHOS::ManagerService::GetInstance().GetGeneration();
+    if (generation == lastGeneration) {
+        return WriteEmptyBundleInfos(reply, generation);
     }
 #ifdef __LINUX__
-    if (strlen(strs) > MAX_IPC_STRING_LENGTH) {
+    BundleInfo *bundleInfos = nullptr;
+    int32_t lengthOfBundleInfo = 0;
+    uint8_t errorCode = GetBundleInfos(flag, &bundleInfos, &lengthOfBundleInfo);
+    if (errorCode == ERR_APPEXECFWK_QUERY_NO_INFOS || (errorCode == OHOS_SUCCESS && lengthOfBundleInfo == 0)) {
+        // the last bundle has been uninstalled, the client clears its list
+        errorCode = WriteEmptyBundleInfos(reply, generation);
+    } else if (errorCode == OHOS_SUCCESS) {
+        errorCode = WriteBundleInfos(reply, bundleInfos, lengthOfBundleInfo, &generation);
+    }
+    BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
+    return errorCode;
+#else
+    // the list does not fit into a liteipc reply, the client pages it through GET_BUNDLE_INFO_BY_INDEX instead
+    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
+    WriteUint64(reply, generation);
+    WriteInt32(reply, -1);
+    return OHOS_SUCCESS;
+#endif
+}
+
+uint8_t BundleMsFeature::HandleGetBundleInfosChangedSince(const uint8_t funcId, IpcIo *req, IpcIo *reply)
+{
+    if ((req == nullptr) || (reply == nullptr)) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
+    int32_t flag = 0;
+    uint64_t lastGeneration = 0;
+    if (!ReadInt32(req, &flag) || !ReadUint64(req, &lastGeneration)) {
+        return ERR_APPEXECFWK_DESERIALIZATION_FAILED;
+    }
+    BundleInfo *bundleInfos = nullptr;
+    int32_t lengthOfBundleInfo = 0;
+    std::vector<std::string> removedBundleNames;
+    uint64_t generation = 0;
+    bool isFullList = !OHOS::ManagerService::GetInstance().GetBundleInfosChangedSince(lastGeneration, flag,
+        &bundleInfos, &lengthOfBundleInfo, removedBundleNames, &generation);
+#ifndef __LINUX__
+    // only a single bundle fits into a liteipc reply, a larger delta is paged as the full list by the client
+    if (!isFullList && lengthOfBundleInfo > 1) {
         BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
-        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+        bundleInfos = nullptr;
+        lengthOfBundleInfo = 0;
+        isFullList = true;
     }
 #endif
-    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
-    WriteInt32(reply, lengthOfBundleInfo);
-    WriteString(reply, strs);
+    uint8_t errorCode = OHOS_SUCCESS;
+    if (isFullList) {
+        // the generation is older than the journal, the client replaces its whole list
+        removedBundleNames.clear();
+#ifdef __LINUX__
+        errorCode = GetBundleInfos(flag, &bundleInfos, &lengthOfBundleInfo);
+        if (errorCode == ERR_APPEXECFWK_QUERY_NO_INFOS || (errorCode == OHOS_SUCCESS && lengthOfBundleInfo == 0)) {
+            // no bundle is installed, the full list is empty
+            errorCode = WriteEmptyBundleInfos(reply, generation);
+        } else if (errorCode == OHOS_SUCCESS) {
+            errorCode = WriteBundleInfos(reply, bundleInfos, lengthOfBundleInfo, &generation);
+        }
+#else
+        WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
+        WriteUint64(reply, generation);
+        WriteInt32(reply, -1);
+#endif
+    } else if (lengthOfBundleInfo == 0) {
+        errorCode = WriteEmptyBundleInfos(reply, generation);
+    } else {
+        errorCode = WriteBundleInfos(reply, bundleInfos, lengthOfBundleInfo, &generation);
+    }
     BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
+    if (errorCode != OHOS_SUCCESS) {
+        return errorCode;
+    }
+    WriteBool(reply, isFullList);
+    WriteInt32(reply, static_cast<int32_t>(removedBundleNames.size()));
+    for (const auto &bundleName : removedBundleNames) {
+        WriteString(reply, bundleName.c_str());
+    }
     return OHOS_SUCCESS;
 }
 
@@ -365,8 +544,12 @@ int32 BundleMsFeature::Invoke(IServerProxy *iProxy, int funcId, void *origin, Ip
         ret = BundleMsInvokeFuc[GET_BUNDLE_INFOS](funcId, req, reply);
     } else if (funcId >= QUERY_ABILITY_INFO && funcId <= GET_BUNDLENAME_FOR_UID) {
         ret = BundleMsInvokeFuc[funcId](funcId, req, reply);
-    } else if (funcId >= CHECK_SYS_CAP && funcId <= GET_SYS_CAP) {
+    } else if (funcId >= CHECK_SYS_CAP && funcId < BMS_INNER_BEGIN) {
         ret = BundleMsInvokeFuc[funcId](funcId, req, reply);
+    } else if (funcId == GET_BUNDLE_INFOS_IF_MODIFIED) {
+        ret = HandleGetBundleInfosIfModified(funcId, req, reply);
+    } else if (funcId == GET_BUNDLE_INFOS_CHANGED_SINCE) {
+        ret = HandleGetBundleInfosChangedSince(funcId, req, reply);
     } else {
         ret = ERR_APPEXECFWK_COMMAND_ERROR;
     }
@@ -398,23 +581,8 @@ uint8_t BundleMsFeature::QueryAbilityInfo(const Want *want, AbilityInfo *ability
         return ERR_APPEXECFWK_OBJECT_NULL;
     }
 
-    BundleInfo *bundleInfo = OHOS::ManagerService::GetInstance().QueryBundleInfo(want->element->bundleName);
-    if (bundleInfo == nullptr) {
-        return ERR_APPEXECFWK_QUERY_NO_INFOS;
-    }
-
-    if ((bundleInfo->abilityInfos == nullptr) || (bundleInfo->numOfAbility == 0)) {
-        return ERR_APPEXECFWK_QUERY_NO_INFOS;
-    }
-
-    for (int32_t i = 0; i < bundleInfo->numOfAbility; ++i) {
-        if ((want->element->abilityName != nullptr) && ((bundleInfo->abilityInfos)[i].name != nullptr) &&
-            (strcmp(want->element->abilityName, (bundleInfo->abilityInfos)[i].name) == 0)) {
-            OHOS::AbilityInfoUtils::CopyAbilityInfo(abilityInfo, bundleInfo->abilityInfos[i]);
-            return OHOS_SUCCESS;
-        }
-    }
-    return ERR_APPEXECFWK_QUERY_NO_INFOS;
+    return OHOS::ManagerService::GetInstance().QueryAbilityInfo(want->element->bundleName,
+        want->element->abilityName, abilityInfo);
 }
 
 uint8_t BundleMsFeature::GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo *bundleInfo)
@@ -434,155 +602,62 @@ uint32_t BundleMsFeature::GetBundleSize(const char *bundleName)
 
 uint8_t BundleMsFeature::QueryKeepAliveBundleInfos(BundleInfo **bundleInfos, int32_t *len)
 {
-    if ((bundleInfos == nullptr) || (len == nullptr)) {
-        return ERR_APPEXECFWK_OBJECT_NULL;
-    }
-    BundleInfo *allBundleInfos = nullptr;
-    int32_t numOfAllBundleInfos = 0;
-    uint8_t errorCode = GetBundleInfos(1, &allBundleInfos, &numOfAllBundleInfos);
-    if (errorCode != OHOS_SUCCESS) {
-        return errorCode;
-    }
-    *len = 0;
-    for (int32_t i = 0; i < numOfAllBundleInfos; i++) {
-        if (allBundleInfos[i].isKeepAlive && allBundleInfos[i].isSystemApp) {
-            (*len)++;
-        }
-    }
-
-    if (*len == 0) {
-        BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-        return ERR_APPEXECFWK_QUERY_NO_INFOS;
-    }
-    *bundleInfos = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo) * (*len)));
-    if (*bundleInfos == nullptr || memset_s(*bundleInfos, sizeof(BundleInfo) * (*len), 0,
-        sizeof(BundleInfo) * (*len)) != EOK) {
-        BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-        return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
-    }
-
-    int32_t count = 0;
-    for (int32_t i = 0; i < numOfAllBundleInfos && count < *len; i++) {
-        if (allBundleInfos[i].isKeepAlive && allBundleInfos[i].isSystemApp) {
-            OHOS::BundleInfoUtils::CopyBundleInfo(1, *bundleInfos + count, allBundleInfos[i]);
-            count++;
-        }
-    }
-    BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-    return OHOS_SUCCESS;
+    return OHOS::ManagerService::GetInstance().QueryKeepAliveBundleInfos(bundleInfos, len);
 }
 
-static bool CheckBundleInfoWithSpecialMetaData(const BundleInfo &bundleInfo, const char *metaDataKey)
+uint8_t BundleMsFeature::GetBundleInfosByMetaData(const char *metaDataKey, BundleInfo **bundleInfos, int32_t *len)
 {
-    if (metaDataKey == nullptr) {
-        return false;
-    }
-
-    for (int32_t i = 0; i < bundleInfo.numOfModule; i++) {
-        for (int32_t j = 0; j < METADATA_SIZE; j++) {
-            if ((bundleInfo.moduleInfos[i].metaData[j] != nullptr) &&
-                (bundleInfo.moduleInfos[i].metaData[j]->name != nullptr) &&
-                strcmp(metaDataKey, bundleInfo.moduleInfos[i].metaData[j]->name) == 0) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return OHOS::ManagerService::GetInstance().GetBundleInfosByMetaData(metaDataKey, bundleInfos, len);
 }
 
-uint8_t BundleMsFeature::GetBundleInfosByMetaData(const char *metaDataKey, BundleInfo **bundleInfos, int32_t *len)
+uint8_t BundleMsFeature::GetBundleNameForUid(int32_t uid, char **bundleName)
 {
-    if (metaDataKey == nullptr || bundleInfos == nullptr) {
-        return ERR_APPEXECFWK_OBJECT_NULL;
-    }
-
-    BundleInfo *allBundleInfos = nullptr;
-    int32_t numOfAllBundleInfos = 0;
-    uint8_t errorCode = GetBundleInfos(1, &allBundleInfos, &numOfAllBundleInfos);
-    if (errorCode != OHOS_SUCCESS) {
-        return errorCode;
-    }
-    *len = 0;
-    for (int32_t i = 0; i < numOfAllBundleInfos; i++) {
-        if (CheckBundleInfoWithSpecialMetaData(allBundleInfos[i], metaDataKey)) {
-            (*len)++;
-        }
-    }
-
-    if (*len == 0) {
-        BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-        return ERR_APPEXECFWK_QUERY_NO_INFOS;
-    }
-
-    *bundleInfos = reinterpret_cast<BundleInfo *>(AdapterMalloc(sizeof(BundleInfo) * (*len)));
-    if (*bundleInfos == nullptr || memset_s(*bundleInfos, sizeof(BundleInfo) * (*len), 0,
-        sizeof(BundleInfo) * (*len)) != EOK) {
-        BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-        return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
-    }
-
-    int32_t count = 0;
-    for (int32_t i = 0; i < numOfAllBundleInfos && count < *len; i++) {
-        if (CheckBundleInfoWithSpecialMetaData(allBundleInfos[i], metaDataKey)) {
-            BundleInfoUtils::CopyBundleInfo(1, *bundleInfos + count, allBundleInfos[i]);
-            count++;
-        }
-    }
-    BundleInfoUtils::FreeBundleInfos(allBundleInfos, numOfAllBundleInfos);
-    return OHOS_SUCCESS;
+    return OHOS::ManagerService::GetInstance().GetBundleNameForUid(uid, bundleName);
 }
 
-uint8_t BundleMsFeature::GetBundleNameForUid(int32_t uid, char **bundleName)
+BundleInfo *BundleMsFeature::GetInnerBundleInfos(IpcIo *req, IpcIo *reply, int32_t *length)
 {
-    if (bundleName == nullptr) {
-        return ERR_APPEXECFWK_OBJECT_NULL;
+    HILOG_INFO(HILOG_MODULE_APP, "BundleMS GetInnerBundleInfos start");
+    if ((req == nullptr) || (reply == nullptr)) {
+        return nullptr;
     }
-    BundleInfo *infos = nullptr;
-    int32_t numOfInfos = 0;
-    uint8_t errorCode = GetBundleInfos(0, &infos, &numOfInfos);
-    if (errorCode != OHOS_SUCCESS) {
-        BundleInfoUtils::FreeBundleInfos(infos, numOfInfos);
-        return errorCode;
+    int32_t codeFlag = -1;
+    int32_t flag = 0;
+    char *metaDataKey = nullptr;
+    if (!ReadInnerBundleInfosParam(req, &codeFlag, &flag, &metaDataKey)) {
+        return nullptr;
     }
+    return QueryInnerBundleInfos(codeFlag, flag, metaDataKey, length);
+}
 
-    for (int i = 0; i < numOfInfos; ++i) {
-        if (infos[i].uid == uid) {
-            *bundleName = Utils::Strdup(infos[i].bundleName);
-            break;
+bool BundleMsFeature::ReadInnerBundleInfosParam(IpcIo *req, int32_t *codeFlag, int32_t *flag, char **metaDataKey)
+{
+    ReadInt32(req, codeFlag);
+    if (*codeFlag == GET_BUNDLE_INFOS) {
+        ReadInt32(req, flag);
+    } else if (*codeFlag == GET_BUNDLE_INFOS_BY_METADATA) {
+        size_t len = 0;
+        *metaDataKey = reinterpret_cast<char *>(ReadString(req, &len));
+        if (*metaDataKey == nullptr) {
+            return false;
         }
+    } else if (*codeFlag != QUERY_KEEPALIVE_BUNDLE_INFOS) {
+        return false;
     }
-    BundleInfoUtils::FreeBundleInfos(infos, numOfInfos);
-    if (*bundleName == nullptr) {
-        return ERR_APPEXECFWK_NO_BUNDLENAME_FOR_UID;
-    }
-    return OHOS_SUCCESS;
+    return true;
 }
 
-BundleInfo *BundleMsFeature::GetInnerBundleInfos(IpcIo *req, IpcIo *reply, int32_t *length)
+BundleInfo *BundleMsFeature::QueryInnerBundleInfos(int32_t codeFlag, int32_t flag, const char *metaDataKey,
+    int32_t *length)
 {
-    HILOG_INFO(HILOG_MODULE_APP, "BundleMS GetInnerBundleInfos start");
-    if ((req == nullptr) || (reply == nullptr)) {
-        return nullptr;
-    }
     BundleInfo *bundleInfos = nullptr;
     uint8_t errorCode = 0;
-    int32_t codeFlag = -1;
-    ReadInt32(req, &codeFlag);
     if (codeFlag == GET_BUNDLE_INFOS) {
-        int32_t flag;
-        ReadInt32(req, &flag);
         errorCode = GetBundleInfos(flag, &bundleInfos, length);
     } else if (codeFlag == QUERY_KEEPALIVE_BUNDLE_INFOS) {
         errorCode = QueryKeepAliveBundleInfos(&bundleInfos, length);
-    } else if (codeFlag == GET_BUNDLE_INFOS_BY_METADATA) {
-        size_t len = 0;
-        char *metaDataKey = reinterpret_cast<char *>(ReadString(req, &len));
-        if (metaDataKey == nullptr) {
-            return nullptr;
-        }
-        errorCode = GetBundleInfosByMetaData(metaDataKey, &bundleInfos, length);
     } else {
-        return nullptr;
+        errorCode = GetBundleInfosByMetaData(metaDataKey, &bundleInfos, length);
     }
     if (errorCode != OHOS_SUCCESS) {
         HILOG_ERROR(HILOG_MODULE_APP, "BundleMS GetInnerBundleInfos failed with errorcode: %{public}d\n", errorCode);
@@ -605,9 +680,14 @@ uint8_t BundleMsFeature::HandleGetBundleInfosLength(const uint8_t funcId, IpcIo
         HILOG_ERROR(HILOG_MODULE_APP, "BundleMS bundleInfos is nullptr");
         return ERR_APPEXECFWK_OBJECT_NULL;
     }
+    // the infos are kept as a snapshot which the following GET_BUNDLE_INFO_BY_INDEX calls serialize from
+    uint32_t token = BundleInfoCursor::GetInstance().Open(bundleInfos, lengthOfBundleInfo, GetCallingUid());
+    if (token == 0) {
+        BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
+    }
     WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
     WriteInt32(reply, lengthOfBundleInfo);
-    BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
+    WriteUint32(reply, token);
     HILOG_INFO(HILOG_MODULE_APP, "BundleMS HandleGetBundleInfosLength finished");
     return OHOS_SUCCESS;
 }
@@ -618,34 +698,42 @@ uint8_t BundleMsFeature::HandleGetBundleInfosByIndex(const uint8_t funcId, IpcIo
     if ((req == nullptr) || (reply == nullptr)) {
         return ERR_APPEXECFWK_OBJECT_NULL;
     }
-    int32_t lengthOfBundleInfo = 0;
-    BundleInfo *bundleInfos = GetInnerBundleInfos(req, reply, &lengthOfBundleInfo);
+    int32_t codeFlag = -1;
+    int32_t flag = 0;
+    char *metaDataKey = nullptr;
+    if (!ReadInnerBundleInfosParam(req, &codeFlag, &flag, &metaDataKey)) {
+        return ERR_APPEXECFWK_OBJECT_NULL;
+    }
     int32_t index = 0;
     ReadInt32(req, &index);
-    HILOG_INFO(HILOG_MODULE_APP, "BundleMS index is : %{public}d\n", index);
-    char *str = ConvertUtils::ConvertBundleInfoToString(bundleInfos + index);
-    if (str == nullptr) {
+    uint32_t token = 0;
+    ReadUint32(req, &token);
+    HILOG_INFO(HILOG_MODULE_APP, "BundleMS index is : %{public}d of snapshot %{public}u", index, token);
+    uint8_t *buff = nullptr;
+    uint32_t size = 0;
+    uint8_t errorCode = BundleInfoCursor::GetInstance().Marshalling(token, GetCallingUid(), index, &buff, &size);
+    if (errorCode == ERR_APPEXECFWK_QUERY_NO_INFOS) {
+        // the snapshot has expired or was never opened, query the infos again for this index only
+        int32_t lengthOfBundleInfo = 0;
+        BundleInfo *bundleInfos = QueryInnerBundleInfos(codeFlag, flag, metaDataKey, &lengthOfBundleInfo);
+        if (bundleInfos == nullptr) {
+            return ERR_APPEXECFWK_OBJECT_NULL;
+        }
+        if (index < 0 || index >= lengthOfBundleInfo) {
+            BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
+            return ERR_APPEXECFWK_QUERY_PARAMETER_ERROR;
+        }
+        buff = ParcelUtils::MarshallingBundleInfos(bundleInfos + index, 1, &size);
         BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
-        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS HandleGetBundleInfosByIndex strs is nullptr");
-        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+        errorCode = (buff == nullptr) ? ERR_APPEXECFWK_SERIALIZATION_FAILED : ERR_OK;
     }
-    HILOG_DEBUG(HILOG_MODULE_APP, "BundleMS length of str is: %{public}d\n", static_cast<int32_t>(strlen(str)));
-#ifdef __LINUX__
-    if (strlen(str) > MAX_IPC_STRING_LENGTH) {
-        BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
-        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS HandleGetBundleInfosByIndex is too larger to be transformed by ipc");
-        cJSON_free(str);
-        return ERR_APPEXECFWK_SERIALIZATION_FAILED;
+    if (errorCode != ERR_OK) {
+        HILOG_ERROR(HILOG_MODULE_APP, "BundleMS HandleGetBundleInfosByIndex failed: %{public}d", errorCode);
+        return errorCode;
     }
-#endif
-    WriteUint8(reply, static_cast<uint8_t>(OHOS_SUCCESS));
-    WriteString(reply, str);
-    HILOG_INFO(HILOG_MODULE_APP, "BundleMS bundleInfo length is %{public}d of index %{public}d",
-        static_cast<int32_t>(strlen(str)), index);
-    BundleInfoUtils::FreeBundleInfos(bundleInfos, lengthOfBundleInfo);
-
-    cJSON_free(str);
+    HILOG_INFO(HILOG_MODULE_APP, "BundleMS bundleInfo length is %{public}u of index %{public}d", size, index);
+    errorCode = WriteParcel(reply, buff, size);
     HILOG_INFO(HILOG_MODULE_APP, "BundleMS HandleGetBundleInfosByIndex finished");
-    return OHOS_SUCCESS;
+    return errorCode;
 }
 } // namespace OHOS
@@ -16,7 +16,6 @@
 #include "bundle_parser.h"
 
 #include "appexecfwk_errors.h"
-#include "bundle_extractor.h"
 #include "bundle_info_creator.h"
 #include "bundle_util.h"
 #include "bundle_log.h"
@@ -176,6 +175,16 @@ bool BundleParser::SetReqPermission(const cJSON *object, PermissionTrans *permis
 
 int8_t BundleParser::ParseBundleParam(const char *path, char **bundleName, int32_t &versionCode)
 {
+    if (path == nullptr) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_FILE_PATH_INVALID;
+    }
+    InstallSession session(path);
+    return ParseBundleParam(session, bundleName, versionCode);
+}
+
+int8_t BundleParser::ParseBundleParam(InstallSession &session, char **bundleName, int32_t &versionCode)
+{
+    const char *path = session.GetHapPath().c_str();
     if (!BundleUtil::CheckRealPath(path)) {
         return ERR_APPEXECFWK_INSTALL_FAILED_FILE_PATH_INVALID;
     }
@@ -187,11 +196,10 @@ int8_t BundleParser::ParseBundleParam(const char *path, char **bundleName, int32
     if (!BundleUtil::IsFile(path)) {
         return ERR_APPEXECFWK_INSTALL_FAILED_FILE_NOT_EXISTS;
     }
-    std::ostringstream profileStream;
-    if (BundleExtractor::ExtractHapProfile(path, profileStream) != ERR_OK) {
+    if (session.Open() != ERR_OK) {
         return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR;
     }
-    cJSON *root = cJSON_Parse(profileStream.str().c_str());
+    cJSON *root = cJSON_Parse(session.GetProfile().c_str());
     if (root == nullptr) {
         return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR;
     }
@@ -275,14 +283,35 @@ BundleInfo *BundleParser::ParseHapProfile(const char *path)
     return bundleInfo;
 }
 
-uint8_t BundleParser::ParseHapProfile(const std::string &path, Permissions &permissions, BundleRes &bundleRes,
+uint8_t BundleParser::ParseHapPermissions(const char *path, Permissions &permissions)
+{
+    if (!BundleUtil::CheckRealPath(path)) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_FILE_PATH_INVALID;
+    }
+
+    std::string profilePath = path + std::string(PATH_SEPARATOR) + PROFILE_NAME;
+    cJSON *root = BundleUtil::GetJsonStream(profilePath.c_str());
+    if (root == nullptr) {
+        return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR;
+    }
+
+    cJSON *moduleObject = cJSON_GetObjectItem(root, PROFILE_KEY_MODULE);
+    if (moduleObject == nullptr) {
+        cJSON_Delete(root);
+        return ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR;
+    }
+    uint8_t errorCode = ParsePermissions(ParseValue(moduleObject, PROFILE_KEY_REQPERMISSIONS, nullptr), permissions);
+    cJSON_Delete(root);
+    return errorCode;
+}
+
+uint8_t BundleParser::ParseHapProfile(InstallSession &session, Permissions &permissions, BundleRes &bundleRes,
     BundleInfo **bundleInfo)
 {
-    std::ostringstream profileStream;
-    uint8_t errorCode = BundleExtractor::ExtractHapProfile(path, profileStream);
+    uint8_t errorCode = session.Open();
     CHECK_IS_TRUE((errorCode == ERR_OK), errorCode);
 
-    cJSON *root = cJSON_Parse(profileStream.str().c_str());
+    cJSON *root = cJSON_Parse(session.GetProfile().c_str());
     CHECK_IS_TRUE((root != nullptr), ERR_APPEXECFWK_INSTALL_FAILED_PARSE_PROFILE_ERROR);
 
     cJSON *appObject = cJSON_GetObjectItem(root, PROFILE_KEY_APP);
@@ -307,7 +336,8 @@ uint8_t BundleParser::ParseHapProfile(const std::string &path, Permissions &perm
     errorCode = ParsePermissions(object, permissions);
     CHECK_PARSE_RESULT(errorCode, root, bundleProfile);
 
-    errorCode = BundleInfoCreator::SaveBundleInfo(bundleProfile, bundleInfo);
+    errorCode = BundleInfoCreator::SaveBundleInfo(bundleProfile, session.GetCodeDirPath(), session.GetDataDirPath(),
+        bundleInfo);
     CHECK_PARSE_RESULT(errorCode, root, bundleProfile);
 
     FREE_BUNDLE_PROFILE(bundleProfile);
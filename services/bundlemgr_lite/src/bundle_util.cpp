@@ -696,10 +696,26 @@ bool BundleUtil::AddUidAndGidInfo(const InstallRecord &installRecord, cJSON *siz
     return true;
 }
 
-cJSON *BundleUtil::ConvertUidAndGidToJson(const InstallRecord &installRecord)
+bool BundleUtil::HasUidAndGidInfo(const char *bundleName, cJSON *uids)
 {
-    if (installRecord.bundleName == nullptr) {
-        return nullptr;
+    cJSON *item = nullptr;
+    cJSON_ArrayForEach(item, uids) {
+        cJSON *innerBundleName = cJSON_GetObjectItemCaseSensitive(item, JSON_SUB_KEY_PACKAGE);
+        if ((cJSON_IsString(innerBundleName)) && (innerBundleName->valuestring != nullptr)) {
+            if (strcmp(innerBundleName->valuestring, bundleName) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+cJSON *BundleUtil::ConvertUidAndGidToJson(const std::vector<InstallRecord> &installRecords)
+{
+    for (const auto &installRecord : installRecords) {
+        if (installRecord.bundleName == nullptr) {
+            return nullptr;
+        }
     }
 
     cJSON *object = ObtainUidAndGidJson(true);
@@ -718,19 +734,14 @@ cJSON *BundleUtil::ConvertUidAndGidToJson(const InstallRecord &installRecord)
         return nullptr;
     }
 
-    cJSON *item = nullptr;
-    cJSON_ArrayForEach(item, uids) {
-        cJSON *innerBundleName = cJSON_GetObjectItemCaseSensitive(item, JSON_SUB_KEY_PACKAGE);
-        if ((cJSON_IsString(innerBundleName)) && (innerBundleName->valuestring != nullptr)) {
-            if (strcmp(innerBundleName->valuestring, installRecord.bundleName) == 0) {
-                return object;
-            }
+    for (const auto &installRecord : installRecords) {
+        if (HasUidAndGidInfo(installRecord.bundleName, uids)) {
+            continue;
+        }
+        if (!AddUidAndGidInfo(installRecord, size, uids)) {
+            cJSON_Delete(object);
+            return nullptr;
         }
-    }
-
-    if (!AddUidAndGidInfo(installRecord, size, uids)) {
-        cJSON_Delete(object);
-        return nullptr;
     }
 
     return object;
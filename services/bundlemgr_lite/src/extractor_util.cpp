@@ -15,15 +15,42 @@
 
 #include "extractor_util.h"
 
+#include <cerrno>
 #include <dirent.h>
 #include <fcntl.h>
 #include <fstream>
+#include <new>
 #include <sys/stat.h>
+#ifdef __LINUX__
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
 #include <unistd.h>
 
 #include "bundle_log.h"
 
 namespace OHOS {
+namespace {
+constexpr size_t COPY_BUFFER_SIZE = 16 * 1024;
+constexpr mode_t EXTRACT_FILE_MODE = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+
+bool WriteAll(int32_t fd, const Byte *data, size_t length)
+{
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+}
+
 ExtractorUtil::ExtractorUtil(const std::string &filePath) : zipFile_(filePath) {}
 
 ExtractorUtil::~ExtractorUtil() {}
@@ -52,6 +79,13 @@ bool ExtractorUtil::ExtractFileByName(const std::string &fileName, std::ostream
 
 bool ExtractorUtil::ExtractFileToPath(const std::string &filePath, const std::string &fileName) const
 {
+    // stored entries are copied from the hap as they are, only the compressed ones go through zlib
+    ZipPos offset = 0;
+    size_t length = 0;
+    if (initial_ && zipFile_.GetStoredEntryLocation(fileName, offset, length)) {
+        return CopyStoredFileToPath(filePath, offset, length);
+    }
+
     std::ofstream fileStream;
     fileStream.open(filePath, std::ios_base::out | std::ios_base::binary);
     if (!fileStream.is_open()) {
@@ -64,19 +98,110 @@ bool ExtractorUtil::ExtractFileToPath(const std::string &filePath, const std::st
         remove(filePath.c_str());
         return false;
     }
-    fileStream.clear();
     fileStream.close();
+    if (fileStream.fail()) {
+        HILOG_ERROR(HILOG_MODULE_APP, "ExtractFileToPath close fail");
+        remove(filePath.c_str());
+        return false;
+    }
+    return true;
+}
 
-    int fd = open(filePath.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+bool ExtractorUtil::CopyStoredFileToPath(const std::string &filePath, ZipPos offset, size_t length) const
+{
+    int fd = open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, EXTRACT_FILE_MODE);
     if (fd < 0) {
-        HILOG_ERROR(HILOG_MODULE_APP, "ExtractFileToPath open fail");
+        HILOG_ERROR(HILOG_MODULE_APP, "CopyStoredFileToPath open fail");
+        return false;
+    }
+    int32_t srcFd = zipFile_.GetFileDescriptor();
+    size_t copied = CopyFileDataInKernel(srcFd, static_cast<off_t>(offset), fd, length);
+    if (!CopyFileDataByRead(srcFd, static_cast<off_t>(offset), fd, length, copied,
+        zipFile_.GetMappedData(offset, length))) {
+        HILOG_ERROR(HILOG_MODULE_APP, "CopyStoredFileToPath copy fail");
+        close(fd);
+        remove(filePath.c_str());
+        return false;
+    }
+    if (close(fd) != 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "CopyStoredFileToPath close fail");
+        remove(filePath.c_str());
         return false;
     }
-    fsync(fd);
-    close(fd);
+    copiedBytes_ += length;
     return true;
 }
 
+size_t ExtractorUtil::CopyFileDataInKernel(int32_t srcFd, off_t offset, int32_t dstFd, size_t length)
+{
+    size_t copied = 0;
+#ifdef __LINUX__
+    // both syscalls advance the offset they are given, so they work on a copy and the caller's offset stays put
+#ifdef __NR_copy_file_range
+    loff_t rangeOffset = offset;
+    while (copied < length) {
+        ssize_t ret = syscall(__NR_copy_file_range, srcFd, &rangeOffset, dstFd, nullptr, length - copied, 0);
+        if (ret <= 0) {
+            break;
+        }
+        copied += static_cast<size_t>(ret);
+    }
+#endif
+    off_t sendOffset = offset + static_cast<off_t>(copied);
+    while (copied < length) {
+        ssize_t ret = sendfile(dstFd, srcFd, &sendOffset, length - copied);
+        if (ret <= 0) {
+            break;
+        }
+        copied += static_cast<size_t>(ret);
+    }
+#endif
+    return copied;
+}
+
+bool ExtractorUtil::CopyFileDataByRead(int32_t srcFd, off_t offset, int32_t dstFd, size_t length, size_t copied,
+    const Byte *mappedData)
+{
+    if (copied >= length) {
+        return copied == length;
+    }
+    if (mappedData != nullptr) {
+        return WriteAll(dstFd, mappedData + copied, length - copied);
+    }
+    Byte *buffer = new (std::nothrow) Byte[COPY_BUFFER_SIZE];
+    if (buffer == nullptr) {
+        return false;
+    }
+    off_t readOffset = offset + static_cast<off_t>(copied);
+    size_t remain = length - copied;
+    bool ret = true;
+    while (remain > 0) {
+        size_t readLen = (remain > COPY_BUFFER_SIZE) ? COPY_BUFFER_SIZE : remain;
+        ssize_t readBytes = pread(srcFd, buffer, readLen, readOffset);
+        if (readBytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readBytes <= 0 || !WriteAll(dstFd, buffer, static_cast<size_t>(readBytes))) {
+            ret = false;
+            break;
+        }
+        readOffset += readBytes;
+        remain -= static_cast<size_t>(readBytes);
+    }
+    delete[] buffer;
+    return ret;
+}
+
+uint64_t ExtractorUtil::GetReadBytes() const
+{
+    return zipFile_.GetReadBytes() + copiedBytes_;
+}
+
+int32_t ExtractorUtil::GetFileDescriptor() const
+{
+    return zipFile_.GetFileDescriptor();
+}
+
 const std::vector<std::string> &ExtractorUtil::GetZipFileNames() const
 {
     return zipFile_.GetFileNames();
@@ -242,7 +242,7 @@ uint8_t GtBundleExtractor::ParseBundleInfoGetActionService(const char *bundleNam
     if (bundleName == nullptr) {
         return ERR_OK;
     }
-    BundleInfo *bundleInfo = OHOS::GtManagerService::GetInstance().QueryBundleInfo(bundleName);
+    BundleInfoRef bundleInfo = OHOS::GtManagerService::GetInstance().QueryBundleInfo(bundleName);
     if (bundleInfo == nullptr) {
         return ERR_OK;
     }
@@ -209,8 +209,12 @@ uint8_t GtBundleInstaller::Install(const char *path, InstallerCallback installer
 
     // rename bundle.json
     if (!RenameJsonFile(installRecord.bundleName, randStr)) {
-        BundleInfo *bundleInfo = GtManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName);
-        CLEAR_INSTALL_ENV(bundleInfo);
+        BundleInfoRef bundleInfo = GtManagerService::GetInstance().QueryBundleInfo(installRecord.bundleName);
+        if (bundleInfo != nullptr) {
+            BundleUtil::RemoveDir(bundleInfo->codePath);
+            BundleUtil::RemoveDir(bundleInfo->dataPath);
+            GtManagerService::GetInstance().RemoveBundleInfo(installRecord.bundleName);
+        }
         return ERR_APPEXECFWK_INSTALL_FAILED_RENAME_FILE_ERROR;
     }
     // if third system bundle, it need to record bundleName in THIRD_SYSTEM_BUNDLE_JSON
@@ -542,7 +546,7 @@ uint8_t GtBundleInstaller::UpdateBundleInfo(uint8_t bundleStyle, uint32_t labelI
             GtManagerService::GetInstance().AddBundleInfo(bundleInfo);
         }
     } else {
-        BundleInfo *oldBundleInfo = GtManagerService::GetInstance().QueryBundleInfo(bundleInfo->bundleName);
+        BundleInfoRef oldBundleInfo = GtManagerService::GetInstance().QueryBundleInfo(bundleInfo->bundleName);
         if (oldBundleInfo == nullptr) {
             return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
         }
@@ -590,7 +594,7 @@ uint8_t GtBundleInstaller::Uninstall(const char *bundleName)
         return ERR_APPEXECFWK_UNINSTALL_FAILED_PARAM_ERROR;
     }
 
-    BundleInfo *bundleInfo = GtManagerService::GetInstance().QueryBundleInfo(bundleName);
+    BundleInfoRef bundleInfo = GtManagerService::GetInstance().QueryBundleInfo(bundleName);
     if (bundleInfo == nullptr) {
         return ERR_APPEXECFWK_UNINSTALL_FAILED_BUNDLE_NOT_EXISTS;
     }
@@ -790,7 +794,7 @@ uint8_t GtBundleInstaller::CheckVersionAndSignature(const char *bundleName, cons
     if (bundleName == nullptr || appId == nullptr || bundleInfo == nullptr) {
         return ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_ERROR;
     }
-    BundleInfo *oldBundleInfo = GtManagerService::GetInstance().QueryBundleInfo(bundleName);
+    BundleInfoRef oldBundleInfo = GtManagerService::GetInstance().QueryBundleInfo(bundleName);
     if (oldBundleInfo != nullptr) {
         if (oldBundleInfo->versionCode > bundleInfo->versionCode) {
             return ERR_APPEXECFWK_INSTALL_FAILED_VERSION_DOWNGRADE;
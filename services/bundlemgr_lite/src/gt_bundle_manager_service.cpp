@@ -127,7 +127,7 @@ bool GtManagerService::Install(const char *hapPath, const InstallParam *installP
 
     updateFlag_ = false;
     oldVersionCode_ = -1;
-    BundleInfo *installedInfo = bundleMap_->Get(bundleInstallMsg_->bundleName);
+    BundleInfoRef installedInfo = bundleMap_->Get(bundleInstallMsg_->bundleName);
     if (installedInfo != nullptr) {
         updateFlag_ = true;
         oldVersionCode_ = installedInfo->versionCode;
@@ -228,7 +228,7 @@ bool GtManagerService::GetInstallState(const char *bundleName, InstallState *ins
     if (bundleName == nullptr) {
         return false;
     }
-    BundleInfo *installedInfo = bundleMap_->Get(bundleName);
+    BundleInfoRef installedInfo = bundleMap_->Get(bundleName);
     if (installedInfo != nullptr) {
         bool isUpdateSuccess = updateFlag_ && oldVersionCode_ < installedInfo->versionCode;
         if (!updateFlag_ || isUpdateSuccess) {
@@ -257,7 +257,7 @@ uint32_t GtManagerService::GetBundleSize(const char *bundleName)
     if (bundleName == nullptr) {
         return 0;
     }
-    BundleInfo *installedInfo = bundleMap_->Get(bundleName);
+    BundleInfoRef installedInfo = bundleMap_->Get(bundleName);
     if (installedInfo == nullptr) {
         HILOG_INFO(HILOG_MODULE_AAFWK, "[BMS] failed to get bundle size because the bundle does not exist!");
         return 0;
@@ -279,7 +279,7 @@ uint8_t GtManagerService::QueryAbilityInfo(const Want *want, AbilityInfo *abilit
         return 0;
     }
     const char *bundleName = want->element->bundleName;
-    BundleInfo *bundleInfo = OHOS::GtManagerService::GetInstance().QueryBundleInfo(bundleName);
+    BundleInfoRef bundleInfo = OHOS::GtManagerService::GetInstance().QueryBundleInfo(bundleName);
     if (bundleInfo == nullptr) {
         return 0;
     }
@@ -297,91 +297,8 @@ uint8_t GtManagerService::QueryAbilityInfos(const Want *want, AbilityInfo **abil
     if (want == nullptr || abilityInfo == nullptr || want->actions == nullptr || bundleMap_ == nullptr) {
         return 0;
     }
-    int32_t abilityInfoLen = 0;
-    List<BundleInfo *> *bundleInfos_ = new (std::nothrow) List<BundleInfo *>();
-    bundleMap_->GetBundleInfosInner(*bundleInfos_);
-
-    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfo *info = node->value_;
-        if (info == nullptr || info->abilityInfo == nullptr) {
-            continue;
-        }
-        // find bundleInfo->abilityInfo->skills[i]->actions whether contain target string
-        if (MatchSkills(want, info->abilityInfo->skills)) {
-            abilityInfoLen++;
-        }
-    }
-    // Request memory
-    AbilityInfo *infos = reinterpret_cast<AbilityInfo *>(AdapterMalloc(sizeof(AbilityInfo) * abilityInfoLen));
-    if (infos == nullptr ||
-        memset_s(infos, sizeof(AbilityInfo) * abilityInfoLen, 0, sizeof(AbilityInfo) * abilityInfoLen) != EOK) {
-        AdapterFree(infos);
-        return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
-    }
-    *abilityInfo = infos;
-    // copy the abilityInfo from bundleInfos
-    for (auto node = bundleInfos_->Begin(); node != bundleInfos_->End(); node = node->next_) {
-        BundleInfo *info = node->value_;
-        if (info == nullptr || info->abilityInfo == nullptr) {
-            continue;
-        }
-        // find bundleInfo->abilityInfo->skills[i]->actions whether contain HOST_APDU_SERVICE
-        if (MatchSkills(want, info->abilityInfo->skills)) {
-            OHOS::AbilityInfoUtils::CopyAbilityInfo(infos++, *(info->abilityInfo));
-        }
-    }
-    *len = abilityInfoLen;
-    return 1;
-}
-bool GtManagerService::MatchSkills(const Want *want, Skill *const skills[])
-{
-    if (skills == nullptr || want == nullptr) {
-        return false;
-    }
-    for (int32_t i = 0; i < SKILL_SIZE; i++) {
-        if (skills[i] == nullptr) {
-            return false;
-        }
-        if (isMatchActions(want->actions, skills[i]->actions) || isMatchEntities(want->entities, skills[i]->entities)) {
-            return true;
-        }
-    }
-    return false;
-}
-bool GtManagerService::isMatchActions(const char *actions, char *const skillActions[])
-{
-    if (actions == nullptr || skillActions == nullptr) {
-        return false;
-    }
-    for (int32_t i = 0; i < MAX_SKILL_ITEM; i++) {
-        if (skillActions[i] == nullptr) {
-            return false;
-        }
-        if (isMatch(actions, skillActions[i])) {
-            return true;
-        }
-    }
-    return false;
-}
-bool GtManagerService::isMatchEntities(const char *entities, char *const skillEntities[])
-{
-    if (entities == nullptr) {
-        return true;
-    }
-    for (int32_t i = 0; i < MAX_SKILL_ITEM; i++) {
-        if (skillEntities[i] == nullptr) {
-            return false;
-        }
-        if (isMatch(entities, skillEntities[i])) {
-            return true;
-        }
-    }
-    return false;
-}
-bool GtManagerService::isMatch(const char *dst, const char *src)
-{
-    // compare whether is ohos.nfc.cardemulation.action.HOST_APDU_SERVICE
-    return strcmp(dst, src) == 0;
+    uint8_t errorCode = bundleMap_->GetAbilityInfosBySkill(want->actions, want->entities, abilityInfo, len);
+    return (errorCode == ERR_OK) ? 1 : errorCode;
 }
 
 uint8_t GtManagerService::GetBundleInfo(const char *bundleName, int32_t flags, BundleInfo &bundleInfo)
@@ -887,7 +804,7 @@ void GtManagerService::UpdateBundleInfoList()
             continue;
         }
 
-        BundleInfo *bundleInfo = bundleMap_->Get(res->bundleName);
+        BundleInfoRef bundleInfo = bundleMap_->Get(res->bundleName);
         if (bundleInfo == nullptr) {
             HILOG_ERROR(HILOG_MODULE_AAFWK, "[BMS] get no bundleInfo when change bundle res!");
             continue;
@@ -906,7 +823,7 @@ void GtManagerService::UpdateBundleInfoList()
         }
 
         uint8_t errorCode = GtBundleParser::ConvertResInfoToBundleInfo(path, res->abilityRes->labelId,
-            res->abilityRes->iconId, bundleInfo);
+            res->abilityRes->iconId, bundleInfo.Get());
         UI_Free(path);
         if (errorCode != ERR_OK) {
             HILOG_ERROR(HILOG_MODULE_AAFWK, "[BMS] change bundle res failed! errorCode is %d", errorCode);
@@ -1058,10 +975,10 @@ bool GtManagerService::CheckThirdSystemBundleHasUninstalled(const char *bundleNa
     return false;
 }
 
-BundleInfo *GtManagerService::QueryBundleInfo(const char *bundleName)
+BundleInfoRef GtManagerService::QueryBundleInfo(const char *bundleName)
 {
     if (bundleName == nullptr || bundleMap_ == nullptr) {
-        return nullptr;
+        return BundleInfoRef();
     }
     return bundleMap_->Get(bundleName);
 }
@@ -20,10 +20,13 @@
 #include "bundle_log.h"
 
 namespace OHOS {
+Mutex HapSignVerify::verifyMutex_;
+
 uint8_t HapSignVerify::VerifySignature(const std::string &hapFilepath, SignatureInfo &signatureInfo)
 {
     bool mode = ManagerService::GetInstance().IsDebugMode();
     HILOG_INFO(HILOG_MODULE_APP, "current mode is %d!", mode);
+    Lock<Mutex> lock(verifyMutex_);
     VerifyResult verifyResult;
     // verify signature
     int32_t ret = APPVERI_AppVerify(hapFilepath.c_str(), &verifyResult);
@@ -42,6 +45,57 @@ uint8_t HapSignVerify::VerifySignature(const std::string &hapFilepath, Signature
     return ERR_OK;
 }
 
+int32_t HapSignVerify::SetDebugMode(bool enable)
+{
+    Lock<Mutex> lock(verifyMutex_);
+    return APPVERI_SetDebugMode(enable);
+}
+
+HapSignVerifyTask::HapSignVerifyTask(const std::string &hapFilepath)
+    : hapFilepath_(hapFilepath), errorCode_(ERR_APPEXECFWK_INSTALL_FAILED_INTERNAL_SIGNATURE_ERROR), thread_()
+{
+}
+
+HapSignVerifyTask::~HapSignVerifyTask()
+{
+    // an install failing early still waits here, the thread uses the members of this task
+    if (isRunning_) {
+        pthread_join(thread_, nullptr);
+    }
+}
+
+void HapSignVerifyTask::Start()
+{
+    if (isRunning_) {
+        return;
+    }
+    if (pthread_create(&thread_, nullptr, Run, this) == 0) {
+        isRunning_ = true;
+        return;
+    }
+    HILOG_WARN(HILOG_MODULE_APP, "create verify thread fail, verify in place");
+    Run(this);
+}
+
+uint8_t HapSignVerifyTask::GetResult(SignatureInfo &signatureInfo)
+{
+    if (isRunning_) {
+        pthread_join(thread_, nullptr);
+        isRunning_ = false;
+    }
+    if (errorCode_ == ERR_OK) {
+        signatureInfo = signatureInfo_;
+    }
+    return errorCode_;
+}
+
+void *HapSignVerifyTask::Run(void *arg)
+{
+    HapSignVerifyTask *task = reinterpret_cast<HapSignVerifyTask *>(arg);
+    task->errorCode_ = HapSignVerify::VerifySignature(task->hapFilepath_, task->signatureInfo_);
+    return nullptr;
+}
+
 uint8_t HapSignVerify::SwitchErrorCode(int32_t errorCode)
 {
     uint32_t errCode = static_cast<uint32_t>(errorCode);
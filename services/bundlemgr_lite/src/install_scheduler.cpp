@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "install_scheduler.h"
+
+#include <new>
+
+#include "bundle_log.h"
+
+namespace OHOS {
+namespace {
+// installs share the verifier lock, the one connection to bundle_daemon and the commit lock, so a second worker
+// only overlaps the verification of one hap with the extraction of another, a third one does not add to that, see
+// Benchmark_0100 of bundle_installer_test
+#ifndef BUNDLE_INSTALL_THREADS
+#define BUNDLE_INSTALL_THREADS 2
+#endif
+constexpr uint32_t MAX_INSTALL_WORKER_NUM = BUNDLE_INSTALL_THREADS;
+}
+
+InstallScheduler::InstallScheduler() : workerNum_(0), idleWorkerNum_(0)
+{
+    pthread_mutex_init(&mutex_, nullptr);
+    pthread_cond_init(&cond_, nullptr);
+}
+
+void InstallScheduler::Submit(const std::vector<std::string> &bundleNames, InstallTaskHandler handler, void *arg)
+{
+    if (handler == nullptr) {
+        return;
+    }
+    Task *task = new (std::nothrow) Task { bundleNames, handler, arg };
+    if (task == nullptr) {
+        HILOG_WARN(HILOG_MODULE_APP, "create install task fail, run it in place");
+        handler(arg);
+        return;
+    }
+    pthread_mutex_lock(&mutex_);
+    tasks_.emplace_back(task);
+    if (tasks_.size() > idleWorkerNum_ && workerNum_ < MAX_INSTALL_WORKER_NUM) {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, Run, this) == 0) {
+            pthread_detach(thread);
+            workerNum_++;
+        } else {
+            HILOG_WARN(HILOG_MODULE_APP, "create install worker fail, %{public}u workers left", workerNum_);
+        }
+    }
+    if (workerNum_ == 0) {
+        // nothing else is running either, so the task can not overtake another one of its bundles
+        tasks_.pop_back();
+        pthread_mutex_unlock(&mutex_);
+        HILOG_WARN(HILOG_MODULE_APP, "no install worker, run the task in place");
+        handler(arg);
+        delete task;
+        return;
+    }
+    pthread_cond_broadcast(&cond_);
+    pthread_mutex_unlock(&mutex_);
+}
+
+InstallScheduler::Task *InstallScheduler::TakeRunnableTask()
+{
+    // a task waits while one of its bundles is busy, or wanted by a task submitted before it that is waiting too
+    std::set<std::string> waitingBundleNames;
+    for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+        Task *task = *it;
+        bool isRunnable = true;
+        for (const auto &bundleName : task->bundleNames) {
+            if (busyBundleNames_.count(bundleName) != 0 || waitingBundleNames.count(bundleName) != 0) {
+                isRunnable = false;
+                break;
+            }
+        }
+        if (!isRunnable) {
+            waitingBundleNames.insert(task->bundleNames.begin(), task->bundleNames.end());
+            continue;
+        }
+        busyBundleNames_.insert(task->bundleNames.begin(), task->bundleNames.end());
+        tasks_.erase(it);
+        return task;
+    }
+    return nullptr;
+}
+
+void InstallScheduler::FinishTask(Task *task)
+{
+    for (const auto &bundleName : task->bundleNames) {
+        busyBundleNames_.erase(bundleName);
+    }
+    delete task;
+    // the tasks waiting for these bundles can run now
+    pthread_cond_broadcast(&cond_);
+}
+
+void *InstallScheduler::Run(void *arg)
+{
+    InstallScheduler *scheduler = reinterpret_cast<InstallScheduler *>(arg);
+    pthread_mutex_lock(&scheduler->mutex_);
+    while (true) {
+        Task *task = scheduler->TakeRunnableTask();
+        if (task == nullptr) {
+            scheduler->idleWorkerNum_++;
+            pthread_cond_wait(&scheduler->cond_, &scheduler->mutex_);
+            scheduler->idleWorkerNum_--;
+            continue;
+        }
+        pthread_mutex_unlock(&scheduler->mutex_);
+        task->handler(task->arg);
+        pthread_mutex_lock(&scheduler->mutex_);
+        scheduler->FinishTask(task);
+    }
+    return nullptr;
+}
+} // namespace OHOS
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "install_session.h"
+
+#include <sstream>
+
+#include "appexecfwk_errors.h"
+#include "bundle_extractor.h"
+#include "bundle_log.h"
+
+namespace OHOS {
+InstallSession::InstallSession(const std::string &hapPath)
+    : hapPath_(hapPath), extractorUtil_(hapPath), openResult_(ERR_OK)
+{
+}
+
+uint8_t InstallSession::Open()
+{
+    // later steps get the result of the first open, failed or not, without touching the file again
+    if (isOpened_) {
+        return openResult_;
+    }
+    isOpened_ = true;
+    std::ostringstream profileStream;
+    openResult_ = BundleExtractor::ExtractHapProfile(extractorUtil_, profileStream);
+    if (openResult_ == ERR_OK) {
+        profile_ = profileStream.str();
+        if (fstat(extractorUtil_.GetFileDescriptor(), &hapStat_) != 0) {
+            HILOG_ERROR(HILOG_MODULE_APP, "install session fstat hap fail");
+            openResult_ = ERR_APPEXECFWK_INSTALL_FAILED_BAD_FILE;
+        }
+    }
+    return openResult_;
+}
+
+const std::string &InstallSession::GetHapPath() const
+{
+    return hapPath_;
+}
+
+const std::string &InstallSession::GetProfile() const
+{
+    return profile_;
+}
+
+uint64_t InstallSession::GetReadBytes() const
+{
+    return extractorUtil_.GetReadBytes();
+}
+
+int64_t InstallSession::GetHapSize() const
+{
+    return static_cast<int64_t>(hapStat_.st_size);
+}
+
+bool InstallSession::IsHapUnchanged() const
+{
+    if (!isOpened_ || openResult_ != ERR_OK) {
+        return false;
+    }
+    struct stat hapStat = {};
+    if (stat(hapPath_.c_str(), &hapStat) != 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "install session stat hap fail");
+        return false;
+    }
+    // a write changes the mtime and a rename or link of the file its ctime, which can not be set back from outside
+    return hapStat.st_dev == hapStat_.st_dev && hapStat.st_ino == hapStat_.st_ino &&
+        hapStat.st_size == hapStat_.st_size &&
+        hapStat.st_mtim.tv_sec == hapStat_.st_mtim.tv_sec && hapStat.st_mtim.tv_nsec == hapStat_.st_mtim.tv_nsec &&
+        hapStat.st_ctim.tv_sec == hapStat_.st_ctim.tv_sec && hapStat.st_ctim.tv_nsec == hapStat_.st_ctim.tv_nsec;
+}
+
+void InstallSession::SetInstallDirPath(const std::string &codeDirPath, const std::string &dataDirPath)
+{
+    codeDirPath_ = codeDirPath;
+    dataDirPath_ = dataDirPath;
+}
+
+const std::string &InstallSession::GetCodeDirPath() const
+{
+    return codeDirPath_;
+}
+
+const std::string &InstallSession::GetDataDirPath() const
+{
+    return dataDirPath_;
+}
+} // namespace OHOS
@@ -19,6 +19,9 @@
 #include <cstring>
 #include <limits>
 #include <ostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "bundle_log.h"
 #include "securec.h"
@@ -45,6 +48,18 @@ constexpr uint32_t DATA_DESC_SIGNATURE = 0x08074b50;
 constexpr uint32_t FLAG_DATA_DESC = 0x8;
 constexpr size_t FILE_READ_COUNT = 1;
 constexpr uint8_t INFLATE_ERROR_TIMES = 5;
+
+// a read of a mapping beyond the end of a file cut short meanwhile raises SIGBUS, so only a file that no one but
+// root or the user of this process can write is mapped; a hap some other user can still truncate is read with stdio
+bool CanMapFile(int32_t fd, ZipPos fileLength)
+{
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) ||
+        static_cast<ZipPos>(fileStat.st_size) != fileLength) {
+        return false;
+    }
+    return (fileStat.st_uid == 0 || fileStat.st_uid == geteuid()) && (fileStat.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
 } // namespace
 
 ZipEntry::ZipEntry(const CentralDirEntry &centralEntry)
@@ -95,12 +110,8 @@ bool ZipFile::ParseEndDirectory()
         return false;
     }
     ZipPos eocdPos = endFilePos - endDirLen;
-    if (fseek(file_, eocdPos, SEEK_SET) != 0) {
-        HILOG_ERROR(HILOG_MODULE_APP, "locate EOCD seek failed, error: %{public}s", strerror(errno));
-        return false;
-    }
-    if (fread(&endDir_, sizeof(EndDir), FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
-        HILOG_ERROR(HILOG_MODULE_APP, "read EOCD struct failed, error: %{public}s", strerror(errno));
+    if (!ReadAt(eocdPos, &endDir_, sizeof(EndDir))) {
+        HILOG_ERROR(HILOG_MODULE_APP, "read EOCD struct failed");
         return false;
     }
     centralDirPos_ = endDir_.offset;
@@ -118,16 +129,8 @@ bool ZipFile::ParseAllEntries()
         fileName.reserve(MAX_FILE_NAME);
         fileName.resize(MAX_FILE_NAME - 1);
 
-        if (fseek(file_, currentPos, SEEK_SET) != 0) {
-            HILOG_ERROR(HILOG_MODULE_APP,
-                "parse entry(%{public}d) seek zipEntry failed, error: %{public}s", i, strerror(errno));
-            ret = false;
-            break;
-        }
-
-        if (fread(&directoryEntry, sizeof(CentralDirEntry), FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
-            HILOG_ERROR(HILOG_MODULE_APP, "parse entry(%{public}d) read ZipEntry failed, error: %{public}s",
-                i, strerror(errno));
+        if (!ReadAt(currentPos, &directoryEntry, sizeof(CentralDirEntry))) {
+            HILOG_ERROR(HILOG_MODULE_APP, "parse entry(%{public}d) read ZipEntry failed", i);
             ret = false;
             break;
         }
@@ -142,9 +145,8 @@ bool ZipFile::ParseAllEntries()
 
         size_t fileLength =
             (directoryEntry.nameSize >= MAX_FILE_NAME) ? (MAX_FILE_NAME - 1) : (directoryEntry.nameSize);
-        if (fread(&(fileName[0]), fileLength, FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
-            HILOG_ERROR(HILOG_MODULE_APP,
-                "parse entry(%{public}d) read file name failed, error: %{public}s", i, strerror(errno));
+        if (!ReadAt(currentPos + sizeof(CentralDirEntry), &(fileName[0]), fileLength)) {
+            HILOG_ERROR(HILOG_MODULE_APP, "parse entry(%{public}d) read file name failed", i);
             ret = false;
             break;
         }
@@ -208,6 +210,18 @@ bool ZipFile::Open()
     }
 
     file_ = tmpFile;
+    // parse and unzip straight from a read only mapping, the stdio reads remain the fallback when it fails
+    if (!CanMapFile(fileno(tmpFile), fileLength)) {
+        HILOG_INFO(HILOG_MODULE_APP, "file may be truncated by other users, read it without mapping");
+    } else {
+        void *mapAddr = mmap(nullptr, fileLength, PROT_READ, MAP_PRIVATE, fileno(tmpFile), 0);
+        if (mapAddr != MAP_FAILED) {
+            mapAddr_ = static_cast<Byte *>(mapAddr);
+            mapLength_ = fileLength;
+        } else {
+            HILOG_WARN(HILOG_MODULE_APP, "mmap failed, error: %{public}s", strerror(errno));
+        }
+    }
     bool result = ParseEndDirectory();
     if (result) {
         result = ParseAllEntries();
@@ -220,6 +234,7 @@ bool ZipFile::Open()
 void ZipFile::Close()
 {
     HILOG_INFO(HILOG_MODULE_APP, "close: %{private}s", pathName_.c_str());
+    ReleaseZStream();
     if (!isOpen_ || file_ == nullptr) {
         HILOG_WARN(HILOG_MODULE_APP, "file is not opened");
         return;
@@ -230,6 +245,11 @@ void ZipFile::Close()
     pathName_ = "";
     isOpen_ = false;
 
+    if (mapAddr_ != nullptr) {
+        munmap(mapAddr_, mapLength_);
+        mapAddr_ = nullptr;
+        mapLength_ = 0;
+    }
     if (fclose(file_) != 0) {
         HILOG_WARN(HILOG_MODULE_APP, "close failed, error: %{public}s", strerror(errno));
     }
@@ -281,15 +301,8 @@ bool ZipFile::CheckDataDesc(const ZipEntry &zipEntry, const LocalHeader &localHe
         ZIPPOS_ADD_AND_CHECK_OVERFLOW(zipEntry.localHeaderOffset, localHeaderSize, descPos);
         ZIPPOS_ADD_AND_CHECK_OVERFLOW(descPos, zipEntry.compressedSize, descPos);
 
-        if (fseek(file_, descPos, SEEK_SET) != 0) {
-            HILOG_ERROR(HILOG_MODULE_APP,
-                "check local header seek datadesc failed, error: %{public}s", strerror(errno));
-            return false;
-        }
-
-        if (fread(&dataDesc, sizeof(DataDesc), FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
-            HILOG_ERROR(HILOG_MODULE_APP, "check local header read datadesc failed, error: %{public}s",
-                strerror(errno));
+        if (!ReadAt(descPos, &dataDesc, sizeof(DataDesc))) {
+            HILOG_ERROR(HILOG_MODULE_APP, "check local header read datadesc failed");
             return false;
         }
 
@@ -326,13 +339,8 @@ bool ZipFile::CheckCoherencyLocalHeader(const ZipEntry &zipEntry, uint16_t &extr
             zipEntry.localHeaderOffset);
         return false;
     }
-    if (fseek(file_, zipEntry.localHeaderOffset, SEEK_SET) != 0) {
-        HILOG_ERROR(HILOG_MODULE_APP, "check local header seek failed, error: %{public}s", strerror(errno));
-        return false;
-    }
-    if (fread(&localHeader, sizeof(LocalHeader), FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
-        HILOG_ERROR(HILOG_MODULE_APP, "check local header read localheader failed, error: %{public}s",
-            strerror(errno));
+    if (!ReadAt(zipEntry.localHeaderOffset, &localHeader, sizeof(LocalHeader))) {
+        HILOG_ERROR(HILOG_MODULE_APP, "check local header read localheader failed");
         return false;
     }
     if ((localHeader.signature != LOCAL_HEADER_SIGNATURE) ||
@@ -356,8 +364,8 @@ bool ZipFile::CheckCoherencyLocalHeader(const ZipEntry &zipEntry, uint16_t &extr
         HILOG_ERROR(HILOG_MODULE_APP, "check local header file name size failed");
         return false;
     }
-    if (fread(&(fileName[0]), fileLength, FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
-        HILOG_ERROR(HILOG_MODULE_APP, "check local header read file name failed, error: %{public}s", strerror(errno));
+    if (!ReadAt(static_cast<ZipPos>(zipEntry.localHeaderOffset) + sizeof(LocalHeader), &(fileName[0]), fileLength)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "check local header read file name failed");
         return false;
     }
     fileName.resize(fileLength);
@@ -374,9 +382,9 @@ bool ZipFile::CheckCoherencyLocalHeader(const ZipEntry &zipEntry, uint16_t &extr
     return true;
 }
 
-bool ZipFile::SeekToEntryStart(const ZipEntry &zipEntry, const uint16_t extraSize) const
+bool ZipFile::GetEntryStart(const ZipEntry &zipEntry, const uint16_t extraSize, ZipPos &startOffset) const
 {
-    ZipPos startOffset = zipEntry.localHeaderOffset;
+    startOffset = zipEntry.localHeaderOffset;
     // get data offset, add signature+localheader+namesize+extrasize
     size_t localHeaderSize = GetLocalHeaderSize(zipEntry.fileName.length(), extraSize);
     if (localHeaderSize == 0) {
@@ -390,18 +398,59 @@ bool ZipFile::SeekToEntryStart(const ZipEntry &zipEntry, const uint16_t extraSiz
             "(%{public}ud) > fileLength(%{public}llu)", startOffset, zipEntry.compressedSize, fileLength_);
         return false;
     }
-    HILOG_INFO(HILOG_MODULE_APP, "seek to entry start 0x%{public}08llx", startOffset);
-    if (fseek(file_, startOffset, SEEK_SET) != 0) {
+    HILOG_INFO(HILOG_MODULE_APP, "entry start 0x%{public}08llx", startOffset);
+    return true;
+}
+
+const Byte *ZipFile::GetMappedData(ZipPos pos, size_t length) const
+{
+    if ((mapAddr_ == nullptr) || (pos > mapLength_) || (length > mapLength_ - pos)) {
+        return nullptr;
+    }
+    return mapAddr_ + pos;
+}
+
+bool ZipFile::ReadAt(ZipPos pos, void *buf, size_t length) const
+{
+    if (length == 0) {
+        return true;
+    }
+    if (mapAddr_ != nullptr) {
+        const Byte *data = GetMappedData(pos, length);
+        if ((data == nullptr) || (memcpy_s(buf, length, data, length) != EOK)) {
+            return false;
+        }
+        readBytes_ += length;
+        return true;
+    }
+    if (fseek(file_, pos, SEEK_SET) != 0) {
         HILOG_ERROR(HILOG_MODULE_APP, "seek failed, error: %{public}s", strerror(errno));
         return false;
     }
+    if (fread(buf, length, FILE_READ_COUNT, file_) != FILE_READ_COUNT) {
+        HILOG_ERROR(HILOG_MODULE_APP, "read failed, error: %{public}s", strerror(errno));
+        return false;
+    }
+    readBytes_ += length;
     return true;
 }
 
 bool ZipFile::UnzipWithStore(const ZipEntry &zipEntry, const uint16_t extraSize, std::ostream &dest) const
 {
     HILOG_INFO(HILOG_MODULE_APP, "unzip with store");
-    if (!SeekToEntryStart(zipEntry, extraSize)) {
+    ZipPos startOffset = 0;
+    if (!GetEntryStart(zipEntry, extraSize, startOffset)) {
+        return false;
+    }
+    const Byte *mappedData = GetMappedData(startOffset, zipEntry.compressedSize);
+    if (mappedData != nullptr) {
+        dest.write(reinterpret_cast<const char *>(mappedData), zipEntry.compressedSize);
+        readBytes_ += zipEntry.compressedSize;
+        HILOG_INFO(HILOG_MODULE_APP, "unzip with store success");
+        return true;
+    }
+    if (fseek(file_, startOffset, SEEK_SET) != 0) {
+        HILOG_ERROR(HILOG_MODULE_APP, "seek failed, error: %{public}s", strerror(errno));
         return false;
     }
 
@@ -418,43 +467,81 @@ bool ZipFile::UnzipWithStore(const ZipEntry &zipEntry, const uint16_t extraSize,
             return false;
         }
         remainSize -= readBytes;
+        readBytes_ += readBytes;
         dest.write(&(readBuffer[0]), readBytes);
     }
     HILOG_INFO(HILOG_MODULE_APP, "unzip with store success");
     return true;
 }
 
-bool ZipFile::InitZStream(z_stream &zstream) const
+bool ZipFile::InitZStream() const
 {
+    // the stream and its buffers are set up for the first inflated entry and reset for the next ones
+    if (zstreamReady_) {
+        if (inflateReset(&zstream_) == Z_OK) {
+            zstream_.next_out = bufOut_;
+            zstream_.avail_out = UNZIP_BUF_OUT_LEN;
+            zstream_.next_in = bufIn_;
+            zstream_.avail_in = 0;
+            return true;
+        }
+        HILOG_WARN(HILOG_MODULE_APP, "unzip inflated reset failed, init again");
+        ReleaseZStream();
+    }
+
     // init zlib stream
-    if (memset_s(&zstream, sizeof(z_stream), 0, sizeof(z_stream))) {
+    if (memset_s(&zstream_, sizeof(z_stream), 0, sizeof(z_stream))) {
         HILOG_ERROR(HILOG_MODULE_APP, "unzip stream buffer init failed");
         return false;
     }
-    int32_t zlibErr = inflateInit2(&zstream, -MAX_WBITS);
+    int32_t zlibErr = inflateInit2(&zstream_, -MAX_WBITS);
     if (zlibErr != Z_OK) {
         HILOG_ERROR(HILOG_MODULE_APP, "unzip inflated init failed");
         return false;
     }
 
-    BytePtr bufOut = new (std::nothrow) Byte[UNZIP_BUF_OUT_LEN];
-    if (bufOut == nullptr) {
+    bufOut_ = new (std::nothrow) Byte[UNZIP_BUF_OUT_LEN];
+    if (bufOut_ == nullptr) {
         HILOG_ERROR(HILOG_MODULE_APP, "unzip inflated new out buffer failed");
+        inflateEnd(&zstream_);
         return false;
     }
 
-    BytePtr bufIn = new (std::nothrow) Byte[UNZIP_BUF_IN_LEN];
-    if (bufIn == nullptr) {
-        HILOG_ERROR(HILOG_MODULE_APP, "unzip inflated new in buffer failed");
-        delete[] bufOut;
-        return false;
+    // a mapped zip is inflated in place and never needs the in buffer
+    if (mapAddr_ == nullptr) {
+        bufIn_ = new (std::nothrow) Byte[UNZIP_BUF_IN_LEN];
+        if (bufIn_ == nullptr) {
+            HILOG_ERROR(HILOG_MODULE_APP, "unzip inflated new in buffer failed");
+            delete[] bufOut_;
+            bufOut_ = nullptr;
+            inflateEnd(&zstream_);
+            return false;
+        }
     }
-    zstream.next_out = bufOut;
-    zstream.next_in = bufIn;
-    zstream.avail_out = UNZIP_BUF_OUT_LEN;
+    zstream_.next_out = bufOut_;
+    zstream_.next_in = bufIn_;
+    zstream_.avail_out = UNZIP_BUF_OUT_LEN;
+    zstreamReady_ = true;
     return true;
 }
 
+void ZipFile::ReleaseZStream() const
+{
+    if (!zstreamReady_) {
+        return;
+    }
+    // free all dynamically allocated data structures except the next_in and next_out for this stream.
+    int32_t zlibErr = inflateEnd(&zstream_);
+    if (zlibErr != Z_OK) {
+        HILOG_ERROR(HILOG_MODULE_APP, "unzip inflateEnd error, error: %{public}d", zlibErr);
+    }
+    delete[] bufOut_;
+    delete[] bufIn_;
+    bufOut_ = nullptr;
+    bufIn_ = nullptr;
+    zstreamReady_ = false;
+}
+
 bool ZipFile::ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &remainCompressedSize) const
 {
     if (zstream.avail_in == 0) {
@@ -467,6 +554,7 @@ bool ZipFile::ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &re
         }
 
         remainCompressedSize -= readBytes;
+        readBytes_ += readBytes;
         zstream.avail_in = readBytes;
         zstream.next_in = buffer;
     }
@@ -476,23 +564,38 @@ bool ZipFile::ReadZStream(const BytePtr &buffer, z_stream &zstream, uint32_t &re
 bool ZipFile::UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSize, std::ostream &dest) const
 {
     HILOG_INFO(HILOG_MODULE_APP, "unzip with inflated");
-    z_stream zstream;
-    if (!SeekToEntryStart(zipEntry, extraSize)) {
+    ZipPos startOffset = 0;
+    if (!GetEntryStart(zipEntry, extraSize, startOffset)) {
+        return false;
+    }
+    const Byte *mappedData = GetMappedData(startOffset, zipEntry.compressedSize);
+    if ((mappedData == nullptr) && (fseek(file_, startOffset, SEEK_SET) != 0)) {
+        HILOG_ERROR(HILOG_MODULE_APP, "seek failed, error: %{public}s", strerror(errno));
         return false;
     }
-    if (!InitZStream(zstream)) {
+    if (!InitZStream()) {
         return false;
     }
-    BytePtr bufIn = zstream.next_in;
-    BytePtr bufOut = zstream.next_out;
+    z_stream &zstream = zstream_;
+    BytePtr bufIn = bufIn_;
+    BytePtr bufOut = bufOut_;
 
     bool ret = true;
     int32_t zlibErr = Z_OK;
     uint32_t remainCompressedSize = zipEntry.compressedSize;
     uint8_t errorTimes = 0;
-
-    while ((remainCompressedSize > 0) || (zstream.avail_in > 0)) {
-        if (!ReadZStream(bufIn, zstream, remainCompressedSize)) {
+    if (mappedData != nullptr) {
+        // the whole entry is inflated from the mapping, so ReadZStream never has to read
+        zstream.next_in = const_cast<BytePtr>(mappedData);
+        zstream.avail_in = remainCompressedSize;
+        readBytes_ += remainCompressedSize;
+        remainCompressedSize = 0;
+    }
+
+    // inflate may use up the input while output is still pending, which it hands out once the out buffer is emptied
+    bool isOutFull = false;
+    while ((remainCompressedSize > 0) || (zstream.avail_in > 0) || isOutFull) {
+        if ((remainCompressedSize > 0) && !ReadZStream(bufIn, zstream, remainCompressedSize)) {
             ret = false;
             break;
         }
@@ -507,6 +610,7 @@ bool ZipFile::UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSi
             break;
         }
 
+        isOutFull = (zstream.avail_out == 0) && (zlibErr != Z_STREAM_END);
         size_t inflateLen = UNZIP_BUF_OUT_LEN - zstream.avail_out;
         if (inflateLen > 0) {
             dest.write(reinterpret_cast<const char*>(bufOut), inflateLen);
@@ -524,16 +628,7 @@ bool ZipFile::UnzipWithInflated(const ZipEntry &zipEntry, const uint16_t extraSi
         }
     }
 
-    // free all dynamically allocated data structures except the next_in and next_out for this stream.
-    zlibErr = inflateEnd(&zstream);
-    if (zlibErr != Z_OK) {
-        HILOG_ERROR(HILOG_MODULE_APP, "unzip inflateEnd error, error: %{public}d", zlibErr);
-        ret = false;
-    }
-    HILOG_INFO(HILOG_MODULE_APP, "unzip with inflated success");
-
-    delete[] bufOut;
-    delete[] bufIn;
+    HILOG_INFO(HILOG_MODULE_APP, "unzip with inflated %{public}s", ret ? "success" : "failed");
     return ret;
 }
 
@@ -559,4 +654,42 @@ bool ZipFile::ExtractFile(const std::string &file, std::ostream &dest) const
     }
     return ret;
 }
+
+bool ZipFile::GetStoredEntryData(const std::string &file, const Byte *&data, size_t &length) const
+{
+    if (mapAddr_ == nullptr) {
+        return false;
+    }
+    ZipPos startOffset = 0;
+    if (!GetStoredEntryLocation(file, startOffset, length)) {
+        return false;
+    }
+    data = GetMappedData(startOffset, length);
+    return data != nullptr;
+}
+
+bool ZipFile::GetStoredEntryLocation(const std::string &file, ZipPos &offset, size_t &length) const
+{
+    ZipEntry zipEntry;
+    if (!GetEntry(file, zipEntry) || (zipEntry.compressionMethod != 0)) {
+        return false;
+    }
+
+    uint16_t extraSize = 0;
+    if (!CheckCoherencyLocalHeader(zipEntry, extraSize) || !GetEntryStart(zipEntry, extraSize, offset)) {
+        return false;
+    }
+    length = zipEntry.compressedSize;
+    return true;
+}
+
+uint64_t ZipFile::GetReadBytes() const
+{
+    return readBytes_;
+}
+
+int32_t ZipFile::GetFileDescriptor() const
+{
+    return (file_ == nullptr) ? -1 : fileno(file_);
+}
 }
@@ -21,6 +21,7 @@
 #include <iostream>
 #include <pthread.h>
 #include <semaphore.h>
+#include <vector>
 
 #include "adapter.h"
 #include "appexecfwk_errors.h"
@@ -41,6 +42,8 @@ namespace OHOS {
 namespace {
 const int32_t MIN_ARGUMENT_NUMBER = 2;
 const int32_t MAX_ARGUMENT_NUMBER = 4;
+// every hap of a batch is given by its own -p option
+const int32_t MAX_INSTALL_ARGUMENT_NUMBER = MIN_ARGUMENT_NUMBER + 2 * MAX_BATCH_INSTALL_NUM;
 const int32_t MAX_LOG_LEN = 1024;
 const int32_t MAX_DUMP_LIST_NUMBER = 3;
 const int32_t UDID_STRING_LEN = 64;
@@ -59,7 +62,8 @@ const std::string CMD_GET_UDID = "getudid";
 const std::string INSTALL_HELP_MESSAGE = "Usage: install hap-path [options]\n"
                                    "Description:\n"
                                    "\t--help|-h                   help menu\n"
-                                   "\t--happath|-p           location of the hap to install\n";
+                                   "\t--happath|-p           location of the hap to install, repeat it to install\n"
+                                   "\t                       several haps in one batch\n";
 const std::string UNINSTALL_HELP_MESSAGE = "Usage: uninstall bundle-name [options]\n"
                                      "Description:\n"
                                      "\t--help|-h                   help menu\n"
@@ -81,6 +85,7 @@ const std::string HELP_MESSAGE = INSTALL_HELP_MESSAGE + UNINSTALL_HELP_MESSAGE +
 const std::string ERROR_COMMAND = "error command!\n";
 const std::string ERROR_OPTION = "error option!\n";
 const std::string ERROR_INSTALL_PATH = "invalid path!\n";
+const std::string ERROR_INSTALL_FAIL = "install request failed!\n";
 const std::string ERROR_EXTRA_PARAMETER = "extra parameter!\n";
 const std::string ERROR_SEM_ERROR = "sem init failed!\n";
 const std::string ERROR_DUMP_FAIL = "no bundle info!\n";
@@ -166,25 +171,20 @@ static void BmToolDeathNotify(void *arg)
 
 void CommandParser::RunAsInstallCommand(int32_t argc, char *argv[]) const
 {
-    if (argc > MAX_ARGUMENT_NUMBER) {
+    if (argc > MAX_INSTALL_ARGUMENT_NUMBER) {
         printf("%s\n", (ERROR_EXTRA_PARAMETER + INSTALL_HELP_MESSAGE).c_str());
         return;
     }
 
     int32_t option;
-    char realPath[PATH_MAX + 1] = { 0 };
-    uint32_t cbId = INITIAL_CBID;
-    SvcIdentity sid = SAMGR_GetRemoteIdentity(BMS_SERVICE, BMS_INNER_FEATURE);
+    std::vector<std::string> hapPaths;
     while ((option = getopt_long_only(argc, argv, SHORT_OPTIONS.c_str(), LONG_OPTIONS, nullptr)) != -1) {
         switch (option) {
             case 'h':
                 printf("%s\n", INSTALL_HELP_MESSAGE.c_str());
                 break;
-            case 'p':
-                if (sem_init(&g_sem, 0, 0)) {
-                    printf("error message: %s\n", ERROR_SEM_ERROR.c_str());
-                    return;
-                }
+            case 'p': {
+                char realPath[PATH_MAX + 1] = { 0 };
                 if (optarg == nullptr || strlen(optarg) > PATH_MAX) {
                     printf("error message: %s\n", ERROR_INSTALL_PATH.c_str());
                     return;
@@ -193,18 +193,44 @@ void CommandParser::RunAsInstallCommand(int32_t argc, char *argv[]) const
                     printf("error message: %s\n", ERROR_INSTALL_PATH.c_str());
                     return;
                 }
-                if (AddDeathRecipient(sid, BmToolDeathNotify, nullptr, &cbId) != ERR_NONE) {
-                    printf("error message: %s\n", "death callback is registered unsuccessfully");
-                    return;
-                }
-                Install(realPath, &g_installParam, ReceiveCallback);
-                sem_wait(&g_sem);
+                hapPaths.emplace_back(realPath);
                 break;
+            }
             default:
                 printf("%s\n", (ERROR_OPTION + INSTALL_HELP_MESSAGE).c_str());
                 break;
         }
     }
+    if (hapPaths.empty()) {
+        return;
+    }
+
+    uint32_t cbId = INITIAL_CBID;
+    SvcIdentity sid = SAMGR_GetRemoteIdentity(BMS_SERVICE, BMS_INNER_FEATURE);
+    if (sem_init(&g_sem, 0, 0)) {
+        printf("error message: %s\n", ERROR_SEM_ERROR.c_str());
+        return;
+    }
+    if (AddDeathRecipient(sid, BmToolDeathNotify, nullptr, &cbId) != ERR_NONE) {
+        printf("error message: %s\n", "death callback is registered unsuccessfully");
+        return;
+    }
+    bool isInvoked = false;
+    if (hapPaths.size() == 1) {
+        isInvoked = Install(hapPaths[0].c_str(), &g_installParam, ReceiveCallback);
+    } else {
+        // several haps are installed by a single request and their records are stored together
+        std::vector<const char *> paths;
+        for (const auto &hapPath : hapPaths) {
+            paths.emplace_back(hapPath.c_str());
+        }
+        isInvoked = InstallBatch(paths.data(), paths.size(), &g_installParam, ReceiveCallback);
+    }
+    if (!isInvoked) {
+        printf("error message: %s\n", ERROR_INSTALL_FAIL.c_str());
+        return;
+    }
+    sem_wait(&g_sem);
 }
 
 void CommandParser::RunAsUninstallCommand(int32_t argc, char *argv[]) const
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "bundle_daemon_handler.h"
+#include "bundle_file_utils.h"
+#include "hap_builder.h"
+#include "ohos_errno.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const std::string HAP_DIR = "/storage/app/tmp/extract_test/";
+const std::string HAP_PATH = HAP_DIR + "extract_test.hap";
+const std::string BROKEN_HAP_PATH = HAP_DIR + "extract_test_broken.hap";
+// ExtractHap only writes below the code path root of bms
+const std::string CODE_PATH = "/storage/app/run/com.example.extracttest";
+const uint32_t ENTRY_NUM = 2000;
+const uint32_t DIR_NUM = 20;
+const uint32_t BROKEN_ENTRY_INDEX = ENTRY_NUM / 2;
+const uint32_t MAX_ENTRY_SIZE = 16384;
+const int32_t EXTRACT_ROUNDS = 3;
+
+std::string GetEntryName(uint32_t index)
+{
+    return HapBuilder::GetEntryName(index, DIR_NUM);
+}
+
+// sizes spread over [1, MAX_ENTRY_SIZE]
+std::string GetEntryContent(uint32_t index)
+{
+    return HapBuilder::GetEntryContent(GetEntryName(index), (index * 997) % MAX_ENTRY_SIZE + 1);
+}
+
+// every third entry is stored, as images and other already compressed resources are in real haps
+bool WriteHap(const std::string &path, bool isBroken)
+{
+    HapBuilder builder;
+    for (uint32_t i = 0; i < DIR_NUM; i++) {
+        if (!builder.AddEntry(HapBuilder::GetDirName(i), "", false)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < ENTRY_NUM; i++) {
+        if (isBroken && i == BROKEN_ENTRY_INDEX) {
+            builder.AddBrokenEntry(GetEntryName(i));
+            continue;
+        }
+        if (!builder.AddEntry(GetEntryName(i), GetEntryContent(i), i % 3 != 0)) {
+            return false;
+        }
+    }
+    return builder.Write(path);
+}
+
+bool IsExtracted(uint32_t index)
+{
+    std::ifstream file(CODE_PATH + "/" + GetEntryName(index), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str() == GetEntryContent(index);
+}
+} // namespace
+
+class BundleDaemonExtractTest : public testing::Test {
+public:
+    static void SetUpTestCase()
+    {
+        ASSERT_TRUE(BundleFileUtils::MkRecursiveDir(HAP_DIR.c_str(), false));
+        ASSERT_TRUE(WriteHap(HAP_PATH, false));
+        ASSERT_TRUE(WriteHap(BROKEN_HAP_PATH, true));
+    }
+
+    static void TearDownTestCase()
+    {
+        BundleFileUtils::RemoveFile(HAP_DIR.c_str());
+    }
+
+    void TearDown() override
+    {
+        BundleFileUtils::RemoveFile(CODE_PATH.c_str());
+    }
+
+    BundleDaemonHandler handler_;
+};
+
+/**
+ * @tc.name: ExtractHap_0100
+ * @tc.desc: every file of a 2000 entry hap, stored or deflated, is extracted with its content
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleDaemonExtractTest, ExtractHap_0100, TestSize.Level1)
+{
+    ASSERT_EQ(handler_.ExtractHap(HAP_PATH.c_str(), CODE_PATH.c_str()), EC_SUCCESS);
+    for (uint32_t i = 0; i < ENTRY_NUM; i++) {
+        EXPECT_TRUE(IsExtracted(i)) << GetEntryName(i);
+    }
+    // a second install over the same code path starts from an empty directory
+    ASSERT_EQ(handler_.ExtractHap(HAP_PATH.c_str(), CODE_PATH.c_str()), EC_SUCCESS);
+    EXPECT_TRUE(IsExtracted(0));
+    EXPECT_TRUE(IsExtracted(ENTRY_NUM - 1));
+}
+
+/**
+ * @tc.name: ExtractHap_0200
+ * @tc.desc: an entry that fails to inflate fails the extraction, whatever the threads, after every file before it
+ *           in zip order has been extracted
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleDaemonExtractTest, ExtractHap_0200, TestSize.Level1)
+{
+    EXPECT_EQ(handler_.ExtractHap(BROKEN_HAP_PATH.c_str(), CODE_PATH.c_str()), EC_NODIR);
+    for (uint32_t i = 0; i < BROKEN_ENTRY_INDEX; i++) {
+        EXPECT_TRUE(IsExtracted(i)) << GetEntryName(i);
+    }
+    EXPECT_EQ(handler_.ExtractHap(HAP_PATH.c_str(), "/storage/app/data/com.example.extracttest"), EC_INVALID);
+    EXPECT_EQ(handler_.ExtractHap((HAP_DIR + "nonexistent.hap").c_str(), CODE_PATH.c_str()), EC_INVALID);
+}
+
+/**
+ * @tc.name: Benchmark_0100
+ * @tc.desc: time to extract a 2000 entry hap with the threads of this build
+ * @tc.type: PERF
+ */
+HWTEST_F(BundleDaemonExtractTest, Benchmark_0100, TestSize.Level3)
+{
+    int64_t totalTime = 0;
+    for (int32_t i = 0; i < EXTRACT_ROUNDS; i++) {
+        auto begin = std::chrono::steady_clock::now();
+        ASSERT_EQ(handler_.ExtractHap(HAP_PATH.c_str(), CODE_PATH.c_str()), EC_SUCCESS);
+        totalTime += std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+    }
+    GTEST_LOG_(INFO) << ENTRY_NUM << " entries on " << sysconf(_SC_NPROCESSORS_ONLN) << " cpus, up to " <<
+        BUNDLE_DAEMON_EXTRACT_THREADS << " threads: " << totalTime / EXTRACT_ROUNDS << " ms per hap";
+}
+} // namespace OHOS
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_BUNDLE_INFO_BUILDER_H
+#define OHOS_BUNDLE_INFO_BUILDER_H
+
+#include <cstdint>
+#include <string>
+
+#include "ability_info.h"
+#include "adapter.h"
+#include "bundle_info.h"
+#include "bundle_info_utils.h"
+#include "securec.h"
+#include "utils.h"
+
+namespace OHOS {
+// builders of the bundle and ability infos the bundle map, parcel and cache tests work on, allocated the way bms
+// allocates them so that BundleInfoUtils frees them
+const int32_t BASE_UID = 10000;
+
+inline std::string GetBundleName(uint32_t index)
+{
+    return "com.example.bundle" + std::to_string(index);
+}
+
+inline std::string GetAbilityName(uint32_t index, const std::string &prefix = "Ability")
+{
+    return "com.example." + prefix + std::to_string(index);
+}
+
+template<typename T>
+T *CreateZeroedArray(uint32_t num)
+{
+    T *array = reinterpret_cast<T *>(AdapterMalloc(sizeof(T) * num));
+    if (array != nullptr && memset_s(array, sizeof(T) * num, 0, sizeof(T) * num) != EOK) {
+        AdapterFree(array);
+        return nullptr;
+    }
+    return array;
+}
+
+// a bundle info of the name and uid alone, the tests fill in the fields they look at
+inline BundleInfo *CreateBundleInfo(const std::string &bundleName, int32_t uid = BASE_UID)
+{
+    BundleInfo *bundleInfo = CreateZeroedArray<BundleInfo>(1);
+    if (bundleInfo == nullptr) {
+        return nullptr;
+    }
+    bundleInfo->bundleName = Utils::Strdup(bundleName.c_str());
+    bundleInfo->uid = uid;
+    bundleInfo->gid = uid;
+    return bundleInfo;
+}
+
+// the label tells apart abilities of the same name in different bundles
+inline void FillAbilityInfo(AbilityInfo &abilityInfo, const std::string &bundleName, const std::string &abilityName)
+{
+    abilityInfo.bundleName = Utils::Strdup(bundleName.c_str());
+    abilityInfo.name = Utils::Strdup(abilityName.c_str());
+    abilityInfo.label = Utils::Strdup((bundleName + "/" + abilityName).c_str());
+}
+
+inline AbilityInfo *CreateAbilityInfo(const std::string &bundleName, const std::string &abilityName)
+{
+    AbilityInfo *abilityInfo = CreateZeroedArray<AbilityInfo>(1);
+    if (abilityInfo != nullptr) {
+        FillAbilityInfo(*abilityInfo, bundleName, abilityName);
+    }
+    return abilityInfo;
+}
+
+// gives the bundle num abilities named GetAbilityName(0, prefix) onwards
+inline bool AddAbilityInfos(BundleInfo &bundleInfo, uint32_t num, const std::string &prefix = "Ability")
+{
+    bundleInfo.abilityInfos = CreateZeroedArray<AbilityInfo>(num);
+    if (bundleInfo.abilityInfos == nullptr) {
+        return false;
+    }
+    bundleInfo.numOfAbility = static_cast<int32_t>(num);
+    for (uint32_t i = 0; i < num; i++) {
+        FillAbilityInfo(bundleInfo.abilityInfos[i], bundleInfo.bundleName, GetAbilityName(i, prefix));
+    }
+    return true;
+}
+} // namespace OHOS
+#endif // OHOS_BUNDLE_INFO_BUILDER_H
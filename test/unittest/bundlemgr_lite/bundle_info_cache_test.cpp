@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "bundle_info_builder.h"
+#include "bundle_info_cache.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const char BUNDLE_A[] = "com.example.cachea";
+const char BUNDLE_B[] = "com.example.cacheb";
+const char ABILITY_NAME[] = "MainAbility";
+const int32_t FLAGS_WITHOUT_ABILITIES = 0;
+const int32_t FLAGS_WITH_ABILITIES = 1;
+
+BundleInfo *CreateVersionedBundleInfo(const char *bundleName, int32_t versionCode)
+{
+    BundleInfo *bundleInfo = CreateBundleInfo(bundleName);
+    if (bundleInfo != nullptr) {
+        bundleInfo->versionCode = versionCode;
+    }
+    return bundleInfo;
+}
+
+std::string GetLabel(const char *bundleName)
+{
+    return std::string(bundleName) + "/" + ABILITY_NAME;
+}
+
+// the version of the cached info, -1 on a miss
+int32_t GetCachedVersion(const char *bundleName, int32_t flags, uint32_t *generation)
+{
+    BundleInfo bundleInfo = {};
+    uint32_t currentGeneration = 0;
+    if (!BundleInfoCache::GetInstance().GetBundleInfo(bundleName, flags, &bundleInfo,
+        (generation == nullptr) ? &currentGeneration : generation)) {
+        return -1;
+    }
+    int32_t versionCode = bundleInfo.versionCode;
+    ClearBundleInfo(&bundleInfo);
+    return versionCode;
+}
+
+// the label of the cached ability, empty on a miss
+std::string GetCachedLabel(const char *bundleName, uint32_t *generation)
+{
+    AbilityInfo abilityInfo = {};
+    uint32_t currentGeneration = 0;
+    if (!BundleInfoCache::GetInstance().GetAbilityInfo(bundleName, ABILITY_NAME, &abilityInfo,
+        (generation == nullptr) ? &currentGeneration : generation)) {
+        return "";
+    }
+    std::string label = (abilityInfo.label == nullptr) ? "" : abilityInfo.label;
+    ClearAbilityInfo(&abilityInfo);
+    return label;
+}
+
+// what a query does on a miss: remember the generation, fetch the info, then hand it to the cache
+void CacheBundle(const char *bundleName, int32_t versionCode)
+{
+    uint32_t generation = 0;
+    if (GetCachedVersion(bundleName, FLAGS_WITHOUT_ABILITIES, &generation) < 0) {
+        BundleInfoCache::GetInstance().PutBundleInfo(bundleName, FLAGS_WITHOUT_ABILITIES,
+            CreateVersionedBundleInfo(bundleName, versionCode), generation);
+    }
+    if (GetCachedLabel(bundleName, &generation).empty()) {
+        BundleInfoCache::GetInstance().PutAbilityInfo(bundleName, ABILITY_NAME,
+            CreateAbilityInfo(bundleName, ABILITY_NAME), generation);
+    }
+}
+} // namespace
+
+class BundleInfoCacheTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        BundleInfoCache::GetInstance().SetEnabled(true);
+    }
+
+    void TearDown() override
+    {
+        BundleInfoCache::GetInstance().SetEnabled(false);
+    }
+};
+
+/**
+ * @tc.name: Get_0100
+ * @tc.desc: a cached bundle info and ability info are served again, each flags value on its own
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInfoCacheTest, Get_0100, TestSize.Level1)
+{
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+    CacheBundle(BUNDLE_A, 1);
+    for (int32_t i = 0; i < 2; i++) {
+        EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), 1);
+        EXPECT_EQ(GetCachedLabel(BUNDLE_A, nullptr), GetLabel(BUNDLE_A));
+    }
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITH_ABILITIES, nullptr), -1);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_B, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+}
+
+/**
+ * @tc.name: Get_0200
+ * @tc.desc: nothing is cached or served while the cache is off, and turning it off drops what it held
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInfoCacheTest, Get_0200, TestSize.Level1)
+{
+    CacheBundle(BUNDLE_A, 1);
+    BundleInfoCache::GetInstance().SetEnabled(false);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+    CacheBundle(BUNDLE_B, 1);
+    BundleInfoCache::GetInstance().SetEnabled(true);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_B, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+    EXPECT_TRUE(GetCachedLabel(BUNDLE_B, nullptr).empty());
+}
+
+/**
+ * @tc.name: Invalidate_0100
+ * @tc.desc: an install or uninstall of a bundle drops its infos only, a nullptr bundle name drops every info
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInfoCacheTest, Invalidate_0100, TestSize.Level1)
+{
+    CacheBundle(BUNDLE_A, 1);
+    CacheBundle(BUNDLE_B, 1);
+    BundleInfoCache::GetInstance().Invalidate(BUNDLE_A);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+    EXPECT_TRUE(GetCachedLabel(BUNDLE_A, nullptr).empty());
+    EXPECT_EQ(GetCachedVersion(BUNDLE_B, FLAGS_WITHOUT_ABILITIES, nullptr), 1);
+    EXPECT_EQ(GetCachedLabel(BUNDLE_B, nullptr), GetLabel(BUNDLE_B));
+
+    // the next query after the update caches the new version
+    CacheBundle(BUNDLE_A, 2);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), 2);
+    BundleInfoCache::GetInstance().Invalidate(nullptr);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_B, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+}
+
+/**
+ * @tc.name: Invalidate_0200
+ * @tc.desc: an info queried before an invalidation and put after it is not cached, since it may be stale already
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInfoCacheTest, Invalidate_0200, TestSize.Level1)
+{
+    uint32_t bundleGeneration = 0;
+    uint32_t abilityGeneration = 0;
+    ASSERT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, &bundleGeneration), -1);
+    ASSERT_TRUE(GetCachedLabel(BUNDLE_A, &abilityGeneration).empty());
+    // the broadcast of an update overtakes the reply that still carries version 1
+    BundleInfoCache::GetInstance().Invalidate(BUNDLE_A);
+    BundleInfoCache::GetInstance().PutBundleInfo(BUNDLE_A, FLAGS_WITHOUT_ABILITIES,
+        CreateVersionedBundleInfo(BUNDLE_A, 1), bundleGeneration);
+    BundleInfoCache::GetInstance().PutAbilityInfo(BUNDLE_A, ABILITY_NAME, CreateAbilityInfo(BUNDLE_A, ABILITY_NAME),
+        abilityGeneration);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+    EXPECT_TRUE(GetCachedLabel(BUNDLE_A, nullptr).empty());
+
+    // the generation is shared by all bundles, so an invalidation of another bundle holds the put back as well
+    ASSERT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, &bundleGeneration), -1);
+    BundleInfoCache::GetInstance().Invalidate(BUNDLE_B);
+    BundleInfoCache::GetInstance().PutBundleInfo(BUNDLE_A, FLAGS_WITHOUT_ABILITIES,
+        CreateVersionedBundleInfo(BUNDLE_A, 2), bundleGeneration);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), -1);
+
+    CacheBundle(BUNDLE_A, 2);
+    EXPECT_EQ(GetCachedVersion(BUNDLE_A, FLAGS_WITHOUT_ABILITIES, nullptr), 2);
+    EXPECT_EQ(GetCachedLabel(BUNDLE_A, nullptr), GetLabel(BUNDLE_A));
+}
+} // namespace OHOS
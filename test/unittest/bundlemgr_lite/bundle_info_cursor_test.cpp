@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include "appexecfwk_errors.h"
+#include "bundle_info_builder.h"
+#include "bundle_info_cursor.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const int32_t BUNDLE_NUM = 3;
+const pid_t OWNER_UID = BASE_UID;
+const pid_t OTHER_UID = BASE_UID + 1;
+
+BundleInfo *CreateBundleInfos(int32_t num)
+{
+    BundleInfo *bundleInfos = CreateZeroedArray<BundleInfo>(static_cast<uint32_t>(num));
+    if (bundleInfos == nullptr) {
+        return nullptr;
+    }
+    for (int32_t i = 0; i < num; i++) {
+        bundleInfos[i].bundleName = Utils::Strdup(GetBundleName(static_cast<uint32_t>(i)).c_str());
+    }
+    return bundleInfos;
+}
+
+uint8_t Page(uint32_t token, pid_t uid, int32_t index)
+{
+    uint8_t *buff = nullptr;
+    uint32_t size = 0;
+    uint8_t errorCode = BundleInfoCursor::GetInstance().Marshalling(token, uid, index, &buff, &size);
+    AdapterFree(buff);
+    return errorCode;
+}
+} // namespace
+
+class BundleInfoCursorTest : public testing::Test {};
+
+/**
+ * @tc.name: Marshalling_0100
+ * @tc.desc: a snapshot is paged only by the uid that opened it, another uid neither reads it nor ends it
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInfoCursorTest, Marshalling_0100, TestSize.Level1)
+{
+    BundleInfo *bundleInfos = CreateBundleInfos(BUNDLE_NUM);
+    ASSERT_NE(bundleInfos, nullptr);
+    uint32_t token = BundleInfoCursor::GetInstance().Open(bundleInfos, BUNDLE_NUM, OWNER_UID);
+    ASSERT_NE(token, 0U);
+    for (int32_t i = 0; i < BUNDLE_NUM; i++) {
+        EXPECT_EQ(Page(token, OTHER_UID, i), ERR_APPEXECFWK_PERMISSION_DENIED);
+        EXPECT_EQ(Page(token, OWNER_UID, i), ERR_OK);
+    }
+    // the last page ended the enumeration
+    EXPECT_EQ(Page(token, OWNER_UID, 0), ERR_APPEXECFWK_QUERY_NO_INFOS);
+}
+
+/**
+ * @tc.name: Close_0100
+ * @tc.desc: a snapshot is closed only by the uid that opened it
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInfoCursorTest, Close_0100, TestSize.Level1)
+{
+    BundleInfo *bundleInfos = CreateBundleInfos(BUNDLE_NUM);
+    ASSERT_NE(bundleInfos, nullptr);
+    uint32_t token = BundleInfoCursor::GetInstance().Open(bundleInfos, BUNDLE_NUM, OWNER_UID);
+    ASSERT_NE(token, 0U);
+    BundleInfoCursor::GetInstance().Close(token, OTHER_UID);
+    EXPECT_EQ(Page(token, OWNER_UID, 0), ERR_OK);
+    BundleInfoCursor::GetInstance().Close(token, OWNER_UID);
+    EXPECT_EQ(Page(token, OWNER_UID, 1), ERR_APPEXECFWK_QUERY_NO_INFOS);
+}
+} // namespace OHOS
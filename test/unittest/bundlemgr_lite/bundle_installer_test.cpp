@@ -0,0 +1,607 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "appexecfwk_errors.h"
+#include "bundle_daemon_client.h"
+#include "bundle_daemon_handler.h"
+#include "bundle_file_utils.h"
+#include "bundle_installer.h"
+#include "bundle_manager_service.h"
+#include "bundle_util.h"
+#include "hap_builder.h"
+#include "install_scheduler.h"
+#include "install_session.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const std::string HAP_DIR = "/storage/app/tmp/install_test/";
+const char BUNDLE_A[] = "com.example.installtesta";
+const char BUNDLE_B[] = "com.example.installtestb";
+const char MODULE_NAME[] = "entry";
+const std::string VERSION_FILE = "assets/js/default/version.txt";
+const std::string UID_GID_MAP_PATH = std::string(JSON_PATH) + UID_GID_MAP + JSON_SUFFIX;
+const InstallParam INSTALL_PARAM = { .installLocation = INSTALL_LOCATION_INTERNAL_ONLY, .keepData = false };
+const uint32_t BENCHMARK_BUNDLE_NUM = 8;
+// a few MB of assets per hap, every third one stored as already compressed resources are
+const uint32_t BENCHMARK_ASSET_NUM = 400;
+const uint32_t BENCHMARK_ASSET_SIZE = 8192;
+const uint32_t BENCHMARK_OPEN_NUM = 20;
+const auto WAIT_TIMEOUT = std::chrono::seconds(60);
+
+// what the fakes of bundle_daemon, the ability manager and the permission service were asked for
+BundleDaemonHandler g_daemonHandler;
+// bms reaches bundle_daemon over one connection, which serves one call at a time
+std::mutex g_daemonMutex;
+// a rename to this path fails once
+std::string g_failedRenamePath;
+// the hap at this path is replaced once right before it is extracted, as a caller racing the install would do
+std::string g_replacedHapPath;
+std::function<bool(const std::string &)> g_replaceHap;
+std::map<std::string, int32_t> g_uids;
+std::map<std::string, int32_t> g_permissions;
+int32_t g_nextUid = 10000;
+
+std::string GetHapPath(const std::string &name)
+{
+    return HAP_DIR + name + ".hap";
+}
+
+std::string GetCodePath(const char *bundleName)
+{
+    return std::string(INSTALL_PATH) + "/" + bundleName;
+}
+
+std::string GetDataPath(const char *bundleName)
+{
+    return std::string(DATA_PATH) + "/" + bundleName;
+}
+
+std::string GetRecordPath(const char *bundleName)
+{
+    return std::string(JSON_PATH) + bundleName + JSON_SUFFIX;
+}
+
+std::string ReadFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+std::string GetBenchmarkBundleName(uint32_t index)
+{
+    return "com.example.installbench" + std::to_string(index);
+}
+
+// a hap of one entry module without abilities, each version requests one permission more than the one before
+bool WriteHap(const std::string &name, const char *bundleName, int32_t versionCode, const char *deviceType,
+    uint32_t assetNum = 0)
+{
+    std::string permissions;
+    for (int32_t i = 0; i < versionCode; i++) {
+        permissions += std::string(i == 0 ? "" : ",") + "{\"name\":\"ohos.permission.TEST" + std::to_string(i) +
+            "\",\"reason\":\"test\",\"usedScene\":{\"when\":\"always\"}}";
+    }
+    std::string profile = std::string("{\"app\":{\"bundleName\":\"") + bundleName + "\",\"vendor\":\"example\"," +
+        "\"version\":{\"code\":" + std::to_string(versionCode) + ",\"name\":\"" + std::to_string(versionCode) +
+        ".0\"},\"apiVersion\":{\"compatible\":3,\"target\":4}},\"deviceConfig\":{},\"module\":{\"deviceType\":[\"" +
+        deviceType + "\"],\"distro\":{\"deliveryWithInstall\":true,\"moduleName\":\"" + MODULE_NAME +
+        "\",\"moduleType\":\"entry\"},\"abilities\":[],\"reqPermissions\":[" + permissions + "]}}";
+    HapBuilder builder;
+    if (!builder.AddEntry(PROFILE_NAME, profile, true) ||
+        !builder.AddEntry(VERSION_FILE, std::to_string(versionCode), false)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < assetNum; i++) {
+        std::string assetName = "assets/js/default/asset" + std::to_string(i) + ".bin";
+        std::string content;
+        while (content.size() < BENCHMARK_ASSET_SIZE) {
+            content += assetName + " " + std::to_string(content.size()) + "\n";
+        }
+        if (!builder.AddEntry(assetName, content, i % 3 != 0)) {
+            return false;
+        }
+    }
+    return builder.Write(GetHapPath(name));
+}
+
+int32_t GetInstalledVersion(const char *bundleName)
+{
+    BundleInfoRef bundleInfo = ManagerService::GetInstance().QueryBundleInfo(bundleName);
+    return (bundleInfo == nullptr) ? -1 : bundleInfo->versionCode;
+}
+
+std::string GetExtractedVersion(const char *bundleName)
+{
+    return ReadFile(GetCodePath(bundleName) + "/" + MODULE_NAME + "/" + VERSION_FILE);
+}
+
+// the extract and backup dirs of an install are left in the code root only when it goes wrong
+bool HasTemporaryDir()
+{
+    DIR *dir = opendir(INSTALL_PATH);
+    if (dir == nullptr) {
+        return false;
+    }
+    bool isFound = false;
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.find(BUNDLE_A) != std::string::npos && name != BUNDLE_A) {
+            isFound = true;
+        }
+        if (name.find(BUNDLE_B) != std::string::npos && name != BUNDLE_B) {
+            isFound = true;
+        }
+    }
+    closedir(dir);
+    return isFound;
+}
+
+bool IsInUidMap(const char *bundleName)
+{
+    return ReadFile(UID_GID_MAP_PATH).find(std::string("\"") + bundleName + "\"") != std::string::npos;
+}
+
+int TerminateApp(const char *bundleName)
+{
+    return 0;
+}
+
+// the installs of a benchmark run, each submitted to the install scheduler on its own
+struct BenchmarkInstalls {
+    BundleInstaller *installer;
+    std::vector<std::string> paths;
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint32_t nextIndex = 0;
+    uint32_t finishedNum = 0;
+    uint32_t failedNum = 0;
+};
+
+void RunBenchmarkInstall(void *arg)
+{
+    BenchmarkInstalls *installs = reinterpret_cast<BenchmarkInstalls *>(arg);
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(installs->mutex);
+        path = installs->paths[installs->nextIndex++];
+    }
+    uint8_t errorCode = installs->installer->Install(path.c_str(), INSTALL_PARAM);
+    std::lock_guard<std::mutex> lock(installs->mutex);
+    installs->failedNum += (errorCode == ERR_OK) ? 0 : 1;
+    installs->finishedNum++;
+    installs->cond.notify_all();
+}
+} // namespace
+
+// the service, bundle_daemon and the security services are replaced by in-process fakes
+ManagerService::ManagerService()
+{
+    installer_ = nullptr;
+    bundleMap_ = BundleMap::GetInstance();
+}
+
+ManagerService::~ManagerService() {}
+
+BundleInfoRef ManagerService::QueryBundleInfo(const char *bundleName)
+{
+    return bundleMap_->Get(bundleName);
+}
+
+void ManagerService::RemoveBundleInfo(const char *bundleName)
+{
+    bundleMap_->Erase(bundleName);
+}
+
+bool ManagerService::UpdateBundleInfo(BundleInfo *info)
+{
+    return bundleMap_->Update(info);
+}
+
+int32_t ManagerService::GenerateUid(const char *bundleName, int8_t bundleStyle)
+{
+    g_uids[bundleName] = g_nextUid;
+    return g_nextUid++;
+}
+
+void ManagerService::RecycleUid(const char *bundleName)
+{
+    g_uids.erase(bundleName);
+}
+
+bool ManagerService::GetAmsInterface(AmsInnerInterface **amsInterface)
+{
+    static AmsInnerInterface interface = {};
+    interface.TerminateApp = TerminateApp;
+    *amsInterface = &interface;
+    return true;
+}
+
+bool ManagerService::IsExternalInstallMode() const
+{
+    return false;
+}
+
+bool ManagerService::IsDebugMode() const
+{
+    return false;
+}
+
+#ifdef OHOS_DEBUG
+bool ManagerService::IsSignMode() const
+{
+    return true;
+}
+#endif
+
+BundleDaemonClient::~BundleDaemonClient() {}
+
+int32_t BundleDaemonClient::ExtractHap(const char *hapFile, const char *codePath)
+{
+    if (!g_replacedHapPath.empty() && g_replacedHapPath == hapFile) {
+        g_replacedHapPath.clear();
+        if (!g_replaceHap(hapFile)) {
+            return EC_FAILURE;
+        }
+    }
+    std::lock_guard<std::mutex> lock(g_daemonMutex);
+    return g_daemonHandler.ExtractHap(hapFile, codePath);
+}
+
+int32_t BundleDaemonClient::RenameFile(const char *oldFile, const char *newFile)
+{
+    // only the first rename to the path fails, the rollback may rename the old file back to it
+    if (g_failedRenamePath == newFile) {
+        g_failedRenamePath.clear();
+        return EC_FAILURE;
+    }
+    std::lock_guard<std::mutex> lock(g_daemonMutex);
+    return g_daemonHandler.RenameFile(oldFile, newFile);
+}
+
+int32_t BundleDaemonClient::CreatePermissionDir()
+{
+    std::lock_guard<std::mutex> lock(g_daemonMutex);
+    return g_daemonHandler.CreatePermissionDir();
+}
+
+int32_t BundleDaemonClient::CreateDataDirectory(const char *dataPath, int32_t uid, int32_t gid, bool isChown)
+{
+    std::lock_guard<std::mutex> lock(g_daemonMutex);
+    return g_daemonHandler.CreateDataDirectory(dataPath, uid, gid, isChown);
+}
+
+int32_t BundleDaemonClient::StoreContentToFile(const char *file, const void *buffer, uint32_t size)
+{
+    std::lock_guard<std::mutex> lock(g_daemonMutex);
+    return g_daemonHandler.StoreContentToFile(file, buffer, size);
+}
+
+int32_t BundleDaemonClient::RemoveFile(const char *file)
+{
+    std::lock_guard<std::mutex> lock(g_daemonMutex);
+    return g_daemonHandler.RemoveFile(file);
+}
+
+int32_t BundleDaemonClient::RemoveInstallDirectory(const char *codePath, const char *dataPath, bool keepData)
+{
+    std::lock_guard<std::mutex> lock(g_daemonMutex);
+    return g_daemonHandler.RemoveInstallDirectory(codePath, dataPath, keepData);
+}
+} // namespace OHOS
+
+extern "C" {
+int32_t APPVERI_AppVerify(const char *filePath, VerifyResult *verifyRst)
+{
+    // the verifier digests the whole hap
+    std::string content = OHOS::ReadFile(filePath);
+    if (content.empty()) {
+        return V_ERR_FILE_OPEN;
+    }
+    (void) crc32(0L, reinterpret_cast<const Bytef *>(content.data()), content.size());
+    static char appId[] = "signer_test";
+    static char provisionBundleName[] = ".*";
+    *verifyRst = {};
+    verifyRst->profile.appid = appId;
+    verifyRst->profile.bundleInfo.bundleName = provisionBundleName;
+    return V_OK;
+}
+
+void APPVERI_FreeVerifyRst(VerifyResult *verifyRst) {}
+
+int32_t APPVERI_SetDebugMode(bool mode)
+{
+    return V_OK;
+}
+
+int IsPermissionValid(const char *permissionName)
+{
+    return 0;
+}
+
+int IsPermissionRestricted(const char *permissionName)
+{
+    return 1;
+}
+
+int SaveOrUpdatePermissions(const char *identifier, PermissionTrans permissions[], int permNum, IsUpdate isUpdate)
+{
+    OHOS::g_permissions[identifier] = permNum;
+    return 0;
+}
+
+int DeletePermissions(const char *identifier)
+{
+    OHOS::g_permissions.erase(identifier);
+    return 0;
+}
+}
+
+namespace OHOS {
+class BundleInstallerTest : public testing::Test {
+public:
+    static void SetUpTestCase()
+    {
+        ASSERT_TRUE(BundleFileUtils::MkRecursiveDir(HAP_DIR.c_str(), false));
+        ASSERT_TRUE(BundleFileUtils::MkRecursiveDir(JSON_PATH, false));
+        ASSERT_TRUE(WriteHap("a1", BUNDLE_A, 1, DEFAULT_DEVICE_TYPE));
+        ASSERT_TRUE(WriteHap("a1_copy", BUNDLE_A, 1, DEFAULT_DEVICE_TYPE));
+        ASSERT_TRUE(WriteHap("a2", BUNDLE_A, 2, DEFAULT_DEVICE_TYPE));
+        ASSERT_TRUE(WriteHap("b1", BUNDLE_B, 1, DEFAULT_DEVICE_TYPE));
+        ASSERT_TRUE(WriteHap("b1_invalid", BUNDLE_B, 1, "tv"));
+        for (uint32_t i = 0; i < BENCHMARK_BUNDLE_NUM; i++) {
+            std::string bundleName = GetBenchmarkBundleName(i);
+            ASSERT_TRUE(WriteHap(bundleName, bundleName.c_str(), 1, DEFAULT_DEVICE_TYPE, BENCHMARK_ASSET_NUM));
+        }
+        hasUidMap_ = BundleFileUtils::IsExistFile(UID_GID_MAP_PATH.c_str());
+        uidMap_ = ReadFile(UID_GID_MAP_PATH);
+    }
+
+    static void TearDownTestCase()
+    {
+        BundleFileUtils::RemoveFile(HAP_DIR.c_str());
+    }
+
+    void TearDown() override
+    {
+        g_failedRenamePath.clear();
+        g_replacedHapPath.clear();
+        std::vector<std::string> bundleNames = { BUNDLE_A, BUNDLE_B };
+        for (uint32_t i = 0; i < BENCHMARK_BUNDLE_NUM; i++) {
+            bundleNames.emplace_back(GetBenchmarkBundleName(i));
+        }
+        for (const auto &bundleName : bundleNames) {
+            ManagerService::GetInstance().RemoveBundleInfo(bundleName.c_str());
+            BundleFileUtils::RemoveFile(GetCodePath(bundleName.c_str()).c_str());
+            BundleFileUtils::RemoveFile(GetDataPath(bundleName.c_str()).c_str());
+            BundleFileUtils::RemoveFile(GetRecordPath(bundleName.c_str()).c_str());
+        }
+        g_uids.clear();
+        g_permissions.clear();
+        BundleFileUtils::RemoveFile(UID_GID_MAP_PATH.c_str());
+        if (hasUidMap_) {
+            BundleFileUtils::WriteFile(UID_GID_MAP_PATH.c_str(), uidMap_.data(), uidMap_.size());
+        }
+    }
+
+    // bundle a at version 1, installed on its own before the batch updates it
+    void InstallA1()
+    {
+        ASSERT_EQ(installer_.Install(GetHapPath("a1").c_str(), INSTALL_PARAM), ERR_OK);
+        ASSERT_EQ(GetInstalledVersion(BUNDLE_A), 1);
+    }
+
+    void ExpectNotInstalled(const char *bundleName)
+    {
+        EXPECT_EQ(GetInstalledVersion(bundleName), -1) << bundleName;
+        EXPECT_FALSE(BundleFileUtils::IsExistDir(GetCodePath(bundleName).c_str())) << bundleName;
+        EXPECT_FALSE(BundleFileUtils::IsExistDir(GetDataPath(bundleName).c_str())) << bundleName;
+        EXPECT_FALSE(BundleFileUtils::IsExistFile(GetRecordPath(bundleName).c_str())) << bundleName;
+        EXPECT_FALSE(IsInUidMap(bundleName)) << bundleName;
+        EXPECT_EQ(g_uids.count(bundleName), 0U) << bundleName;
+        EXPECT_EQ(g_permissions.count(bundleName), 0U) << bundleName;
+    }
+
+    void ExpectInstalled(const char *bundleName, int32_t versionCode)
+    {
+        EXPECT_EQ(GetInstalledVersion(bundleName), versionCode) << bundleName;
+        EXPECT_EQ(GetExtractedVersion(bundleName), std::to_string(versionCode)) << bundleName;
+        EXPECT_TRUE(BundleFileUtils::IsExistDir(GetDataPath(bundleName).c_str())) << bundleName;
+        EXPECT_EQ(BundleUtil::GetValueFromBundleJson(bundleName, JSON_SUB_KEY_VERSIONCODE, -1), versionCode) <<
+            bundleName;
+        EXPECT_TRUE(IsInUidMap(bundleName)) << bundleName;
+        EXPECT_EQ(g_uids.count(bundleName), 1U) << bundleName;
+        EXPECT_EQ(g_permissions[bundleName], versionCode) << bundleName;
+    }
+
+    BundleInstaller installer_ { INSTALL_PATH, DATA_PATH };
+    static bool hasUidMap_;
+    static std::string uidMap_;
+};
+
+bool BundleInstallerTest::hasUidMap_ = false;
+std::string BundleInstallerTest::uidMap_;
+
+/**
+ * @tc.name: InstallBatch_0100
+ * @tc.desc: every hap of a batch is installed, an update next to a new bundle
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInstallerTest, InstallBatch_0100, TestSize.Level1)
+{
+    InstallA1();
+    std::vector<std::string> installedBundles;
+    ASSERT_EQ(installer_.InstallBatch({ GetHapPath("a2"), GetHapPath("b1") }, INSTALL_PARAM, installedBundles),
+        ERR_OK);
+    EXPECT_EQ(installedBundles, std::vector<std::string>({ BUNDLE_A, BUNDLE_B }));
+    ExpectInstalled(BUNDLE_A, 2);
+    ExpectInstalled(BUNDLE_B, 1);
+    EXPECT_FALSE(HasTemporaryDir());
+}
+
+/**
+ * @tc.name: InstallBatch_0200
+ * @tc.desc: a batch with one invalid hap installs none of its haps and leaves the installed version alone
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInstallerTest, InstallBatch_0200, TestSize.Level1)
+{
+    InstallA1();
+    std::vector<std::string> installedBundles;
+    EXPECT_EQ(installer_.InstallBatch({ GetHapPath("a2"), GetHapPath("b1_invalid") }, INSTALL_PARAM,
+        installedBundles), ERR_APPEXECFWK_INSTALL_FAILED_PARSE_DEVICETYPE_ERROR);
+    EXPECT_TRUE(installedBundles.empty());
+    ExpectInstalled(BUNDLE_A, 1);
+    ExpectNotInstalled(BUNDLE_B);
+    EXPECT_FALSE(HasTemporaryDir());
+}
+
+/**
+ * @tc.name: InstallBatch_0300
+ * @tc.desc: a batch that carries one bundle twice is rejected before anything is committed
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInstallerTest, InstallBatch_0300, TestSize.Level1)
+{
+    std::vector<std::string> installedBundles;
+    EXPECT_EQ(installer_.InstallBatch({ GetHapPath("b1"), GetHapPath("a1"), GetHapPath("a1_copy") },
+        INSTALL_PARAM, installedBundles), ERR_APPEXECFWK_INSTALL_FAILED_PARAM_ERROR);
+    EXPECT_TRUE(installedBundles.empty());
+    ExpectNotInstalled(BUNDLE_A);
+    ExpectNotInstalled(BUNDLE_B);
+    EXPECT_FALSE(HasTemporaryDir());
+}
+
+/**
+ * @tc.name: InstallBatch_0400
+ * @tc.desc: a commit that fails on the last bundle or on the uid map brings back the updated version and removes the
+ *           new bundle
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInstallerTest, InstallBatch_0400, TestSize.Level1)
+{
+    for (const std::string &failedRenamePath : { GetCodePath(BUNDLE_B) + "/" + MODULE_NAME, UID_GID_MAP_PATH }) {
+        InstallA1();
+        g_failedRenamePath = failedRenamePath;
+        std::vector<std::string> installedBundles;
+        EXPECT_NE(installer_.InstallBatch({ GetHapPath("a2"), GetHapPath("b1") }, INSTALL_PARAM, installedBundles),
+            ERR_OK) << failedRenamePath;
+        EXPECT_TRUE(installedBundles.empty());
+        ExpectInstalled(BUNDLE_A, 1);
+        ExpectNotInstalled(BUNDLE_B);
+        EXPECT_FALSE(HasTemporaryDir());
+        TearDown();
+    }
+}
+
+/**
+ * @tc.name: Install_0100
+ * @tc.desc: a hap swapped for another or rewritten in place while it is installed is rejected, whatever the verifier
+ *           and bundle_daemon read by its path
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleInstallerTest, Install_0100, TestSize.Level1)
+{
+    std::vector<std::function<bool(const std::string &)>> replaceHaps = {
+        [](const std::string &path) {
+            return WriteHap("a2_swap", BUNDLE_A, 2, DEFAULT_DEVICE_TYPE) &&
+                rename(GetHapPath("a2_swap").c_str(), path.c_str()) == 0;
+        },
+        [](const std::string &path) {
+            return WriteHap("a1_swap", BUNDLE_A, 2, DEFAULT_DEVICE_TYPE);
+        },
+    };
+    for (const auto &replaceHap : replaceHaps) {
+        ASSERT_TRUE(WriteHap("a1_swap", BUNDLE_A, 1, DEFAULT_DEVICE_TYPE));
+        g_replacedHapPath = GetHapPath("a1_swap");
+        g_replaceHap = replaceHap;
+        // the verifier may as well catch a hap rewritten under it
+        EXPECT_NE(installer_.Install(GetHapPath("a1_swap").c_str(), INSTALL_PARAM), ERR_OK);
+        EXPECT_TRUE(g_replacedHapPath.empty());
+        ExpectNotInstalled(BUNDLE_A);
+        EXPECT_FALSE(HasTemporaryDir());
+        TearDown();
+    }
+}
+
+/**
+ * @tc.name: Benchmark_0100
+ * @tc.desc: time to install bundles of a few MB submitted at once to the install scheduler, with the verifier lock
+ *           and the one connection to bundle_daemon the installs share on a device
+ * @tc.type: PERF
+ */
+HWTEST_F(BundleInstallerTest, Benchmark_0100, TestSize.Level3)
+{
+    BenchmarkInstalls installs;
+    installs.installer = &installer_;
+    for (uint32_t i = 0; i < BENCHMARK_BUNDLE_NUM; i++) {
+        installs.paths.emplace_back(GetHapPath(GetBenchmarkBundleName(i)));
+    }
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCHMARK_BUNDLE_NUM; i++) {
+        InstallScheduler::GetInstance().Submit({ GetBenchmarkBundleName(i) }, RunBenchmarkInstall, &installs);
+    }
+    std::unique_lock<std::mutex> lock(installs.mutex);
+    ASSERT_TRUE(installs.cond.wait_for(lock, WAIT_TIMEOUT, [&installs] {
+        return installs.finishedNum == BENCHMARK_BUNDLE_NUM;
+    }));
+    int64_t time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    EXPECT_EQ(installs.failedNum, 0U);
+    GTEST_LOG_(INFO) << BENCHMARK_BUNDLE_NUM << " installs on up to " << BUNDLE_INSTALL_THREADS << " workers: " <<
+        time << " ms";
+}
+
+/**
+ * @tc.name: Benchmark_0200
+ * @tc.desc: time of the hap open and config.json inflate that the install session spares the second step reading the
+ *           profile, next to the time of a whole install of the same hap
+ * @tc.type: PERF
+ */
+HWTEST_F(BundleInstallerTest, Benchmark_0200, TestSize.Level3)
+{
+    std::string path = GetHapPath(GetBenchmarkBundleName(0));
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCHMARK_OPEN_NUM; i++) {
+        InstallSession session(path);
+        ASSERT_EQ(session.Open(), ERR_OK);
+    }
+    int64_t openTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count() / BENCHMARK_OPEN_NUM;
+    begin = std::chrono::steady_clock::now();
+    ASSERT_EQ(installer_.Install(path.c_str(), INSTALL_PARAM), ERR_OK);
+    int64_t installTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    GTEST_LOG_(INFO) << "open of a hap of " << BENCHMARK_ASSET_NUM << " entries: " << openTime << " us, install: " <<
+        installTime << " us";
+}
+} // namespace OHOS
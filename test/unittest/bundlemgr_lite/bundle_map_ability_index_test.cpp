@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "ability_info_utils.h"
+#include "appexecfwk_errors.h"
+#include "bundle_info_builder.h"
+#include "bundle_map.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const uint32_t BUNDLE_NUM = 100;
+// 1000 abilities over the bundles
+const uint32_t ABILITY_NUM = 10;
+const int32_t LOOKUP_ROUNDS = 100;
+
+BundleInfo *CreateBundleWithAbilities(const std::string &bundleName, int32_t uid, const std::string &prefix = "Ability")
+{
+    BundleInfo *bundleInfo = CreateBundleInfo(bundleName, uid);
+    if (bundleInfo != nullptr && !AddAbilityInfos(*bundleInfo, ABILITY_NUM, prefix)) {
+        BundleInfoUtils::FreeBundleInfo(bundleInfo);
+        return nullptr;
+    }
+    return bundleInfo;
+}
+
+void AddBundles()
+{
+    for (uint32_t i = 0; i < BUNDLE_NUM; i++) {
+        BundleMap::GetInstance()->Add(CreateBundleWithAbilities(GetBundleName(i), BASE_UID + static_cast<int32_t>(i)));
+    }
+}
+
+uint8_t QueryAbilityLabel(const std::string &bundleName, const std::string &abilityName, std::string &label)
+{
+    AbilityInfo abilityInfo;
+    if (memset_s(&abilityInfo, sizeof(AbilityInfo), 0, sizeof(AbilityInfo)) != EOK) {
+        return ERR_APPEXECFWK_QUERY_INFOS_INIT_ERROR;
+    }
+    uint8_t errorCode = BundleMap::GetInstance()->QueryAbilityInfo(bundleName.c_str(), abilityName.c_str(),
+        &abilityInfo);
+    if (errorCode == ERR_OK && abilityInfo.label != nullptr) {
+        label = abilityInfo.label;
+    }
+    ClearAbilityInfo(&abilityInfo);
+    return errorCode;
+}
+
+// the lookup QueryAbilityInfo did before abilities were indexed, the bundle and then a strcmp on each ability
+uint8_t QueryAbilityInList(const char *bundleName, const char *abilityName, AbilityInfo *abilityInfo)
+{
+    BundleInfoRef bundleInfo = BundleMap::GetInstance()->Get(bundleName);
+    if (bundleInfo == nullptr) {
+        return ERR_APPEXECFWK_QUERY_NO_INFOS;
+    }
+    for (int32_t i = 0; i < bundleInfo->numOfAbility; i++) {
+        if (strcmp(bundleInfo->abilityInfos[i].name, abilityName) == 0) {
+            AbilityInfoUtils::CopyAbilityInfo(abilityInfo, bundleInfo->abilityInfos[i]);
+            return ERR_OK;
+        }
+    }
+    return ERR_APPEXECFWK_QUERY_NO_INFOS;
+}
+
+template<typename Query>
+int64_t MeasureQueries(Query query)
+{
+    AbilityInfo abilityInfo;
+    auto begin = std::chrono::steady_clock::now();
+    for (int32_t round = 0; round < LOOKUP_ROUNDS; round++) {
+        for (uint32_t i = 0; i < BUNDLE_NUM; i++) {
+            std::string bundleName = GetBundleName(i);
+            // the last ability is the one the list walk reaches last
+            std::string abilityName = GetAbilityName(ABILITY_NUM - 1 - round % ABILITY_NUM);
+            if (memset_s(&abilityInfo, sizeof(AbilityInfo), 0, sizeof(AbilityInfo)) != EOK) {
+                return -1;
+            }
+            if (query(bundleName.c_str(), abilityName.c_str(), &abilityInfo) != ERR_OK) {
+                return -1;
+            }
+            ClearAbilityInfo(&abilityInfo);
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count() /
+        (LOOKUP_ROUNDS * BUNDLE_NUM);
+}
+} // namespace
+
+class BundleMapAbilityIndexTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        AddBundles();
+    }
+
+    void TearDown() override
+    {
+        BundleMap::GetInstance()->EraseAll();
+    }
+};
+
+/**
+ * @tc.name: QueryAbilityInfo_0100
+ * @tc.desc: every one of 1000 abilities resolves to the ability of its own bundle
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleMapAbilityIndexTest, QueryAbilityInfo_0100, TestSize.Level1)
+{
+    for (uint32_t i = 0; i < BUNDLE_NUM; i++) {
+        std::string bundleName = GetBundleName(i);
+        for (uint32_t j = 0; j < ABILITY_NUM; j++) {
+            std::string label;
+            ASSERT_EQ(QueryAbilityLabel(bundleName, GetAbilityName(j), label), ERR_OK);
+            EXPECT_EQ(label, bundleName + "/" + GetAbilityName(j));
+        }
+    }
+    std::string label;
+    EXPECT_EQ(QueryAbilityLabel(GetBundleName(0), GetAbilityName(ABILITY_NUM), label),
+        ERR_APPEXECFWK_QUERY_NO_INFOS);
+    EXPECT_EQ(QueryAbilityLabel(GetBundleName(BUNDLE_NUM), GetAbilityName(0), label),
+        ERR_APPEXECFWK_QUERY_NO_INFOS);
+    EXPECT_EQ(BundleMap::GetInstance()->QueryAbilityInfo(nullptr, GetAbilityName(0).c_str(), nullptr),
+        ERR_APPEXECFWK_QUERY_NO_INFOS);
+}
+
+/**
+ * @tc.name: QueryAbilityInfo_0200
+ * @tc.desc: the index follows the abilities of updated and erased bundles
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleMapAbilityIndexTest, QueryAbilityInfo_0200, TestSize.Level1)
+{
+    std::string label;
+    for (uint32_t i = 0; i < BUNDLE_NUM; i += 2) {
+        BundleInfo *bundleInfo = CreateBundleWithAbilities(GetBundleName(i), BASE_UID + static_cast<int32_t>(i),
+            "Renamed");
+        ASSERT_NE(bundleInfo, nullptr);
+        ASSERT_TRUE(BundleMap::GetInstance()->Update(bundleInfo));
+    }
+    for (uint32_t i = 1; i < BUNDLE_NUM; i += 2) {
+        BundleMap::GetInstance()->Erase(GetBundleName(i).c_str());
+    }
+    for (uint32_t i = 0; i < BUNDLE_NUM; i++) {
+        std::string bundleName = GetBundleName(i);
+        for (uint32_t j = 0; j < ABILITY_NUM; j++) {
+            EXPECT_EQ(QueryAbilityLabel(bundleName, GetAbilityName(j), label), ERR_APPEXECFWK_QUERY_NO_INFOS);
+            uint8_t expected = (i % 2 == 0) ? ERR_OK : ERR_APPEXECFWK_QUERY_NO_INFOS;
+            EXPECT_EQ(QueryAbilityLabel(bundleName, GetAbilityName(j, "Renamed"), label), expected);
+        }
+    }
+    // adding the erased bundles back makes their abilities resolve again
+    for (uint32_t i = 1; i < BUNDLE_NUM; i += 2) {
+        BundleMap::GetInstance()->Add(CreateBundleWithAbilities(GetBundleName(i), BASE_UID + static_cast<int32_t>(i)));
+    }
+    for (uint32_t i = 1; i < BUNDLE_NUM; i += 2) {
+        for (uint32_t j = 0; j < ABILITY_NUM; j++) {
+            EXPECT_EQ(QueryAbilityLabel(GetBundleName(i), GetAbilityName(j), label), ERR_OK);
+        }
+    }
+}
+
+/**
+ * @tc.name: Benchmark_0100
+ * @tc.desc: time of one ability query through the index and through the bundle's ability list, 1000 abilities
+ * @tc.type: PERF
+ */
+HWTEST_F(BundleMapAbilityIndexTest, Benchmark_0100, TestSize.Level3)
+{
+    int64_t indexTime = MeasureQueries([](const char *bundleName, const char *abilityName, AbilityInfo *info) {
+        return BundleMap::GetInstance()->QueryAbilityInfo(bundleName, abilityName, info);
+    });
+    int64_t listTime = MeasureQueries(QueryAbilityInList);
+    ASSERT_GE(indexTime, 0);
+    ASSERT_GE(listTime, 0);
+    GTEST_LOG_(INFO) << BUNDLE_NUM * ABILITY_NUM << " abilities: index " << indexTime << " ns, list walk " <<
+        listTime << " ns per query";
+}
+} // namespace OHOS
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "appexecfwk_errors.h"
+#include "bundle_info_builder.h"
+#include "bundle_map.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const uint32_t BUNDLE_NUM = 64;
+const uint32_t READER_NUM = 4;
+const uint32_t WRITE_ROUNDS = 20000;
+// every this many updates a bundle is erased and added again instead
+const uint32_t ERASE_INTERVAL = 16;
+const auto BENCHMARK_DURATION = std::chrono::milliseconds(500);
+
+// the version name repeats the bundle name and the version code, so a reader can tell a torn or freed info apart
+std::string GetVersionName(const std::string &bundleName, int32_t versionCode)
+{
+    return bundleName + "/" + std::to_string(versionCode);
+}
+
+BundleInfo *CreateVersionedBundleInfo(const std::string &bundleName, int32_t versionCode, int32_t uid)
+{
+    BundleInfo *bundleInfo = CreateBundleInfo(bundleName, uid);
+    if (bundleInfo != nullptr) {
+        bundleInfo->versionName = Utils::Strdup(GetVersionName(bundleName, versionCode).c_str());
+        bundleInfo->versionCode = versionCode;
+    }
+    return bundleInfo;
+}
+
+bool IsConsistent(const BundleInfo *bundleInfo, const std::string &bundleName)
+{
+    if (bundleInfo->bundleName == nullptr || bundleInfo->versionName == nullptr) {
+        return false;
+    }
+    return (bundleName == bundleInfo->bundleName) &&
+        (GetVersionName(bundleName, bundleInfo->versionCode) == bundleInfo->versionName);
+}
+
+// updates every bundle in turn, erasing and adding one back now and then, with increasing version codes
+void RunWriter(uint32_t rounds, std::atomic<bool> &isStopped)
+{
+    std::vector<int32_t> versionCodes(BUNDLE_NUM, 1);
+    for (uint32_t i = 0; i < BUNDLE_NUM; i++) {
+        BundleInfoRef bundleInfo = BundleMap::GetInstance()->Get(GetBundleName(i).c_str());
+        if (bundleInfo != nullptr) {
+            versionCodes[i] = bundleInfo->versionCode;
+        }
+    }
+    for (uint32_t round = 0; round < rounds && !isStopped; round++) {
+        uint32_t index = round % BUNDLE_NUM;
+        std::string bundleName = GetBundleName(index);
+        int32_t uid = BASE_UID + static_cast<int32_t>(index);
+        BundleInfo *bundleInfo = CreateVersionedBundleInfo(bundleName, ++versionCodes[index], uid);
+        if (round % ERASE_INTERVAL == 0) {
+            BundleMap::GetInstance()->Erase(bundleName.c_str());
+            BundleMap::GetInstance()->Add(bundleInfo);
+        } else if (!BundleMap::GetInstance()->Update(bundleInfo)) {
+            BundleInfoUtils::FreeBundleInfo(bundleInfo);
+        }
+    }
+    isStopped = true;
+}
+
+// pins bundles and reads them again, when holding after giving the writer time to replace them, the pinned info
+// must not change
+void RunReader(uint32_t seed, bool isHolding, const std::atomic<bool> &isStopped, std::atomic<uint32_t> &failures,
+    std::atomic<uint64_t> &queries)
+{
+    std::vector<int32_t> lastVersionCodes(BUNDLE_NUM, 0);
+    uint64_t count = 0;
+    for (uint32_t i = seed; !isStopped; i++) {
+        uint32_t index = i % BUNDLE_NUM;
+        std::string bundleName = GetBundleName(index);
+        BundleInfoRef bundleInfo = BundleMap::GetInstance()->Get(bundleName.c_str());
+        count++;
+        if (bundleInfo == nullptr) {
+            // erased for the moment by the writer
+            continue;
+        }
+        int32_t versionCode = bundleInfo->versionCode;
+        if (!IsConsistent(bundleInfo.Get(), bundleName) || versionCode < lastVersionCodes[index]) {
+            failures++;
+        }
+        lastVersionCodes[index] = versionCode;
+        if (isHolding) {
+            std::this_thread::yield();
+        }
+        if (!IsConsistent(bundleInfo.Get(), bundleName) || bundleInfo->versionCode != versionCode) {
+            failures++;
+        }
+    }
+    queries += count;
+}
+
+void AddBundles()
+{
+    for (uint32_t i = 0; i < BUNDLE_NUM; i++) {
+        BundleMap::GetInstance()->Add(CreateVersionedBundleInfo(GetBundleName(i), 1,
+            BASE_UID + static_cast<int32_t>(i)));
+    }
+}
+} // namespace
+
+class BundleMapConcurrencyTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        AddBundles();
+    }
+
+    void TearDown() override
+    {
+        BundleMap::GetInstance()->EraseAll();
+    }
+};
+
+/**
+ * @tc.name: PinnedInfo_0100
+ * @tc.desc: infos pinned by readers stay intact while a writer updates and erases them
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleMapConcurrencyTest, PinnedInfo_0100, TestSize.Level1)
+{
+    std::atomic<bool> isStopped(false);
+    std::atomic<uint32_t> failures(0);
+    std::atomic<uint64_t> queries(0);
+    std::vector<std::thread> readers;
+    for (uint32_t i = 0; i < READER_NUM; i++) {
+        readers.emplace_back(RunReader, i * BUNDLE_NUM / READER_NUM, true, std::cref(isStopped),
+            std::ref(failures), std::ref(queries));
+    }
+    RunWriter(WRITE_ROUNDS, isStopped);
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(failures, 0U);
+    for (uint32_t i = 0; i < BUNDLE_NUM; i++) {
+        std::string bundleName = GetBundleName(i);
+        BundleInfoRef bundleInfo = BundleMap::GetInstance()->Get(bundleName.c_str());
+        ASSERT_TRUE(bundleInfo != nullptr);
+        EXPECT_TRUE(IsConsistent(bundleInfo.Get(), bundleName));
+    }
+}
+
+/**
+ * @tc.name: GetBundleInfos_0100
+ * @tc.desc: copies of the whole list taken while a writer runs hold every bundle once and intact
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleMapConcurrencyTest, GetBundleInfos_0100, TestSize.Level1)
+{
+    std::atomic<bool> isStopped(false);
+    std::atomic<uint32_t> failures(0);
+    std::thread writer(RunWriter, WRITE_ROUNDS, std::ref(isStopped));
+    while (!isStopped) {
+        BundleInfo *bundleInfos = nullptr;
+        int32_t len = 0;
+        if (BundleMap::GetInstance()->GetBundleInfos(0, &bundleInfos, &len) != ERR_OK) {
+            continue;
+        }
+        // at most the bundle erased for the moment is missing
+        if (len < static_cast<int32_t>(BUNDLE_NUM) - 1 || len > static_cast<int32_t>(BUNDLE_NUM)) {
+            failures++;
+        }
+        for (int32_t i = 0; i < len; i++) {
+            if (bundleInfos[i].bundleName == nullptr || !IsConsistent(&bundleInfos[i], bundleInfos[i].bundleName)) {
+                failures++;
+            }
+        }
+        BundleInfoUtils::FreeBundleInfos(bundleInfos, len);
+    }
+    writer.join();
+    EXPECT_EQ(failures, 0U);
+}
+
+/**
+ * @tc.name: Benchmark_0100
+ * @tc.desc: query throughput of concurrent readers, alone and while bundles are being installed
+ * @tc.type: PERF
+ */
+HWTEST_F(BundleMapConcurrencyTest, Benchmark_0100, TestSize.Level3)
+{
+    for (uint32_t readerNum = 1; readerNum <= READER_NUM; readerNum <<= 1) {
+        for (bool withWriter : { false, true }) {
+            std::atomic<bool> isStopped(false);
+            std::atomic<uint32_t> failures(0);
+            std::atomic<uint64_t> queries(0);
+            std::vector<std::thread> readers;
+            for (uint32_t i = 0; i < readerNum; i++) {
+                readers.emplace_back(RunReader, i, false, std::cref(isStopped), std::ref(failures),
+                    std::ref(queries));
+            }
+            std::thread writer;
+            if (withWriter) {
+                writer = std::thread(RunWriter, UINT32_MAX, std::ref(isStopped));
+            }
+            std::this_thread::sleep_for(BENCHMARK_DURATION);
+            isStopped = true;
+            if (writer.joinable()) {
+                writer.join();
+            }
+            for (auto &reader : readers) {
+                reader.join();
+            }
+            EXPECT_EQ(failures, 0U);
+            GTEST_LOG_(INFO) << readerNum << " readers " << (withWriter ? "with" : "without") << " installs: "
+                << queries * std::chrono::milliseconds(std::chrono::seconds(1)).count() /
+                BENCHMARK_DURATION.count() << " queries per second";
+        }
+    }
+}
+} // namespace OHOS
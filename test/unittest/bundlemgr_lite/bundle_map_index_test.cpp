@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "appexecfwk_errors.h"
+#include "bundle_info_builder.h"
+#include "bundle_map.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const int32_t LOOKUP_ROUNDS = 100;
+const uint32_t BENCHMARK_BUNDLE_NUMS[] = { 10, 100, 1000 };
+
+void AddBundles(uint32_t num)
+{
+    for (uint32_t i = 0; i < num; i++) {
+        BundleMap::GetInstance()->Add(CreateBundleInfo(GetBundleName(i), BASE_UID + static_cast<int32_t>(i)));
+    }
+}
+
+// the lookup BundleMap did before it was indexed, a strcmp on every node of the bundle list
+BundleInfo *FindInList(List<BundleInfo *> &bundleInfos, const char *bundleName)
+{
+    for (auto node = bundleInfos.Begin(); node != bundleInfos.End(); node = node->next_) {
+        if (strcmp(node->value_->bundleName, bundleName) == 0) {
+            return node->value_;
+        }
+    }
+    return nullptr;
+}
+} // namespace
+
+class BundleMapIndexTest : public testing::Test {
+public:
+    void TearDown() override
+    {
+        BundleMap::GetInstance()->EraseAll();
+    }
+};
+
+/**
+ * @tc.name: Get_0100
+ * @tc.desc: every added bundle is found by its name and only by its name
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleMapIndexTest, Get_0100, TestSize.Level1)
+{
+    const uint32_t num = 1000;
+    AddBundles(num);
+    for (uint32_t i = 0; i < num; i++) {
+        std::string bundleName = GetBundleName(i);
+        BundleInfoRef bundleInfo = BundleMap::GetInstance()->Get(bundleName.c_str());
+        ASSERT_TRUE(bundleInfo != nullptr);
+        EXPECT_STREQ(bundleInfo->bundleName, bundleName.c_str());
+    }
+    EXPECT_TRUE(BundleMap::GetInstance()->Get(GetBundleName(num).c_str()) == nullptr);
+    EXPECT_TRUE(BundleMap::GetInstance()->Get("com.example") == nullptr);
+    EXPECT_TRUE(BundleMap::GetInstance()->Get(nullptr) == nullptr);
+}
+
+/**
+ * @tc.name: Erase_0100
+ * @tc.desc: erased slots do not hide the bundles probed past them and can be reused
+ * @tc.type: FUNC
+ */
+HWTEST_F(BundleMapIndexTest, Erase_0100, TestSize.Level1)
+{
+    const uint32_t num = 500;
+    AddBundles(num);
+    for (uint32_t i = 0; i < num; i += 2) {
+        BundleMap::GetInstance()->Erase(GetBundleName(i).c_str());
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        bool isErased = (i % 2 == 0);
+        EXPECT_EQ(BundleMap::GetInstance()->Get(GetBundleName(i).c_str()) == nullptr, isErased);
+    }
+    for (uint32_t i = 0; i < num; i += 2) {
+        BundleMap::GetInstance()->Add(CreateBundleInfo(GetBundleName(i), BASE_UID + static_cast<int32_t>(i)));
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        EXPECT_TRUE(BundleMap::GetInstance()->Get(GetBundleName(i).c_str()) != nullptr);
+    }
+}
+
+/**
+ * @tc.name: Benchmark_0100
+ * @tc.desc: compares the indexed lookup with a walk over the bundle list at 10, 100 and 1000 bundles
+ * @tc.type: PERF
+ */
+HWTEST_F(BundleMapIndexTest, Benchmark_0100, TestSize.Level3)
+{
+    for (uint32_t num : BENCHMARK_BUNDLE_NUMS) {
+        AddBundles(num);
+        std::vector<std::string> bundleNames;
+        for (uint32_t i = 0; i < num; i++) {
+            bundleNames.emplace_back(GetBundleName(i));
+        }
+
+        uint32_t found = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int32_t round = 0; round < LOOKUP_ROUNDS; round++) {
+            for (const auto &bundleName : bundleNames) {
+                found += (BundleMap::GetInstance()->Get(bundleName.c_str()) != nullptr) ? 1 : 0;
+            }
+        }
+        auto indexTime = std::chrono::steady_clock::now() - begin;
+        EXPECT_EQ(found, num * LOOKUP_ROUNDS);
+
+        List<BundleInfo *> bundleInfos;
+        ASSERT_EQ(BundleMap::GetInstance()->GetBundleInfosInner(bundleInfos), ERR_OK);
+        found = 0;
+        begin = std::chrono::steady_clock::now();
+        for (int32_t round = 0; round < LOOKUP_ROUNDS; round++) {
+            for (const auto &bundleName : bundleNames) {
+                found += (FindInList(bundleInfos, bundleName.c_str()) != nullptr) ? 1 : 0;
+            }
+        }
+        auto listTime = std::chrono::steady_clock::now() - begin;
+        EXPECT_EQ(found, num * LOOKUP_ROUNDS);
+
+        uint64_t lookups = static_cast<uint64_t>(num) * LOOKUP_ROUNDS;
+        GTEST_LOG_(INFO) << num << " bundles: index "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(indexTime).count() / lookups
+            << " ns per lookup, list "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(listTime).count() / lookups
+            << " ns per lookup";
+        BundleMap::GetInstance()->EraseAll();
+    }
+}
+} // namespace OHOS
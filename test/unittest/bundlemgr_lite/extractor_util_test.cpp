@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "extractor_util.h"
+#include "hap_builder.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const std::string SRC_PATH = "/data/extractor_util_test.src";
+const std::string DST_PATH = "/data/extractor_util_test.dst";
+const std::string HAP_PATH = "/data/extractor_util_test.hap";
+const std::string STORED_ENTRY_NAME = "assets/js/default/stored.bin";
+// the range starts off a page boundary and spans several read buffers
+const size_t RANGE_OFFSET = 3001;
+const size_t RANGE_LENGTH = 100000;
+
+std::string GetContent(size_t size, uint32_t seed)
+{
+    std::string content(size, '\0');
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        content[i] = static_cast<char>(seed >> 16);
+    }
+    return content;
+}
+
+bool WriteFile(const std::string &path, const std::string &content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), content.size());
+    return file.good();
+}
+
+std::string ReadFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+// copies the range with the kernel stopping after kernelLength bytes, as it does when a syscall gives up midway
+bool CopyRange(size_t kernelLength, bool isMapped, const std::string &range)
+{
+    int32_t srcFd = open(SRC_PATH.c_str(), O_RDONLY);
+    int32_t dstFd = open(DST_PATH.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (srcFd < 0 || dstFd < 0) {
+        close(srcFd);
+        close(dstFd);
+        return false;
+    }
+    size_t copied = ExtractorUtil::CopyFileDataInKernel(srcFd, RANGE_OFFSET, dstFd, kernelLength);
+    const Byte *mappedData = isMapped ? reinterpret_cast<const Byte *>(range.data()) : nullptr;
+    bool ret = ExtractorUtil::CopyFileDataByRead(srcFd, RANGE_OFFSET, dstFd, RANGE_LENGTH, copied, mappedData);
+    close(srcFd);
+    close(dstFd);
+    return ret;
+}
+} // namespace
+
+class ExtractorUtilTest : public testing::Test {
+public:
+    static void SetUpTestCase()
+    {
+        content_ = GetContent(RANGE_OFFSET + RANGE_LENGTH + RANGE_OFFSET, 1);
+        ASSERT_TRUE(WriteFile(SRC_PATH, content_));
+    }
+
+    static void TearDownTestCase()
+    {
+        remove(SRC_PATH.c_str());
+        remove(DST_PATH.c_str());
+        remove(HAP_PATH.c_str());
+    }
+
+    static std::string content_;
+};
+
+std::string ExtractorUtilTest::content_;
+
+/**
+ * @tc.name: CopyFileData_0100
+ * @tc.desc: the read fallback goes on right where a partial kernel copy stopped, mapped or not
+ * @tc.type: FUNC
+ */
+HWTEST_F(ExtractorUtilTest, CopyFileData_0100, TestSize.Level1)
+{
+    std::string range = content_.substr(RANGE_OFFSET, RANGE_LENGTH);
+    for (size_t kernelLength : { static_cast<size_t>(0), static_cast<size_t>(1), RANGE_LENGTH / 3,
+        RANGE_LENGTH - 1, RANGE_LENGTH }) {
+        for (bool isMapped : { false, true }) {
+            ASSERT_TRUE(CopyRange(kernelLength, isMapped, range)) << kernelLength;
+            EXPECT_EQ(ReadFile(DST_PATH), range) << kernelLength << " bytes copied by the kernel, mapped " <<
+                isMapped;
+        }
+    }
+}
+
+/**
+ * @tc.name: CopyFileData_0200
+ * @tc.desc: a range that runs past the end of the file is not reported as copied
+ * @tc.type: FUNC
+ */
+HWTEST_F(ExtractorUtilTest, CopyFileData_0200, TestSize.Level1)
+{
+    int32_t srcFd = open(SRC_PATH.c_str(), O_RDONLY);
+    int32_t dstFd = open(DST_PATH.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_GE(srcFd, 0);
+    ASSERT_GE(dstFd, 0);
+    off_t offset = static_cast<off_t>(content_.size() - RANGE_OFFSET);
+    size_t copied = ExtractorUtil::CopyFileDataInKernel(srcFd, offset, dstFd, RANGE_LENGTH);
+    EXPECT_FALSE(ExtractorUtil::CopyFileDataByRead(srcFd, offset, dstFd, RANGE_LENGTH, copied, nullptr));
+    close(srcFd);
+    close(dstFd);
+}
+
+/**
+ * @tc.name: ExtractFileToPath_0100
+ * @tc.desc: a stored entry is copied out of the hap with its content
+ * @tc.type: FUNC
+ */
+HWTEST_F(ExtractorUtilTest, ExtractFileToPath_0100, TestSize.Level1)
+{
+    std::string content = content_.substr(0, RANGE_LENGTH);
+    HapBuilder builder;
+    ASSERT_TRUE(builder.AddEntry("assets/js/default/deflated.bin", content, true));
+    ASSERT_TRUE(builder.AddEntry(STORED_ENTRY_NAME, content, false));
+    ASSERT_TRUE(builder.Write(HAP_PATH));
+
+    ExtractorUtil extractorUtil(HAP_PATH);
+    ASSERT_TRUE(extractorUtil.Init());
+    ASSERT_TRUE(extractorUtil.ExtractFileToPath(DST_PATH, STORED_ENTRY_NAME));
+    EXPECT_EQ(ReadFile(DST_PATH), content);
+}
+} // namespace OHOS
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_HAP_BUILDER_H
+#define OHOS_HAP_BUILDER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "zlib.h"
+
+namespace OHOS {
+// writes a synthetic hap, a plain zip archive of stored and raw deflated entries, for the extraction tests
+class HapBuilder {
+public:
+    bool AddEntry(const std::string &name, const std::string &content, bool isDeflated)
+    {
+        Entry entry;
+        entry.name = name;
+        entry.crc = crc32(0L, reinterpret_cast<const Bytef *>(content.data()), content.size());
+        entry.size = static_cast<uint32_t>(content.size());
+        entry.method = isDeflated ? Z_DEFLATED : 0;
+        if (!isDeflated) {
+            entry.data = content;
+        } else if (!Deflate(content, entry.data)) {
+            return false;
+        }
+        entries_.emplace_back(entry);
+        return true;
+    }
+
+    // a deflated entry whose data starts with a reserved block type, so inflating it fails
+    void AddBrokenEntry(const std::string &name)
+    {
+        Entry entry;
+        entry.name = name;
+        entry.data = std::string(BROKEN_DATA_SIZE, '\xFF');
+        entry.crc = 0;
+        entry.size = BROKEN_DATA_SIZE;
+        entry.method = Z_DEFLATED;
+        entries_.emplace_back(entry);
+    }
+
+    bool Write(const std::string &path) const
+    {
+        std::string central;
+        std::string archive;
+        for (const auto &entry : entries_) {
+            uint32_t offset = static_cast<uint32_t>(archive.size());
+            AppendUint32(archive, LOCAL_HEADER_SIGNATURE);
+            AppendEntryHeader(archive, entry);
+            archive += entry.name;
+            archive += entry.data;
+
+            AppendUint32(central, CENTRAL_HEADER_SIGNATURE);
+            AppendUint16(central, ZIP_VERSION);
+            AppendEntryHeader(central, entry);
+            // comment length, disk number, internal and external attributes
+            AppendUint16(central, 0);
+            AppendUint16(central, 0);
+            AppendUint16(central, 0);
+            AppendUint32(central, 0);
+            AppendUint32(central, offset);
+            central += entry.name;
+        }
+        uint32_t centralOffset = static_cast<uint32_t>(archive.size());
+        archive += central;
+        AppendUint32(archive, END_OF_CENTRAL_SIGNATURE);
+        // this disk and the disk of the central directory
+        AppendUint16(archive, 0);
+        AppendUint16(archive, 0);
+        AppendUint16(archive, static_cast<uint16_t>(entries_.size()));
+        AppendUint16(archive, static_cast<uint16_t>(entries_.size()));
+        AppendUint32(archive, static_cast<uint32_t>(central.size()));
+        AppendUint32(archive, centralOffset);
+        AppendUint16(archive, 0);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(archive.data(), archive.size());
+        return file.good();
+    }
+
+    // the files of a test hap are spread over dirNum directories in turn
+    static std::string GetDirName(uint32_t index)
+    {
+        return "assets/js/default/dir" + std::to_string(index) + "/";
+    }
+
+    static std::string GetEntryName(uint32_t index, uint32_t dirNum)
+    {
+        return GetDirName(index % dirNum) + "file" + std::to_string(index) + ".bin";
+    }
+
+    // compressible text of the given size, which differs from entry to entry by its name
+    static std::string GetEntryContent(const std::string &name, uint32_t size)
+    {
+        std::string line = name + " line\n";
+        std::string content;
+        content.reserve(size);
+        while (content.size() < size) {
+            content += line;
+        }
+        content.resize(size);
+        return content;
+    }
+
+    // raw deflate data, as zip entries carry it
+    static bool Deflate(const std::string &content, std::string &out)
+    {
+        z_stream stream = {};
+        // negative window bits leave out the zlib header
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, MAX_MEM_LEVEL - 1,
+            Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+        out.resize(deflateBound(&stream, content.size()));
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(content.data()));
+        stream.avail_in = content.size();
+        stream.next_out = reinterpret_cast<Bytef *>(&out[0]);
+        stream.avail_out = out.size();
+        int ret = deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        return ret == Z_STREAM_END;
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string data;
+        uint32_t crc;
+        uint32_t size;
+        uint16_t method;
+    };
+
+    static const uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+    static const uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+    static const uint32_t END_OF_CENTRAL_SIGNATURE = 0x06054b50;
+    static const uint16_t ZIP_VERSION = 20;
+    static const uint32_t BROKEN_DATA_SIZE = 64;
+
+    static void AppendUint16(std::string &out, uint16_t value)
+    {
+        out += static_cast<char>(value & 0xFF);
+        out += static_cast<char>((value >> 8) & 0xFF);
+    }
+
+    static void AppendUint32(std::string &out, uint32_t value)
+    {
+        AppendUint16(out, static_cast<uint16_t>(value & 0xFFFF));
+        AppendUint16(out, static_cast<uint16_t>(value >> 16));
+    }
+
+    // the fields the local and the central headers share, from the version needed to the extra field length
+    static void AppendEntryHeader(std::string &out, const Entry &entry)
+    {
+        AppendUint16(out, ZIP_VERSION);
+        AppendUint16(out, 0);
+        AppendUint16(out, entry.method);
+        // modification time and date
+        AppendUint16(out, 0);
+        AppendUint16(out, 0);
+        AppendUint32(out, entry.crc);
+        AppendUint32(out, static_cast<uint32_t>(entry.data.size()));
+        AppendUint32(out, entry.size);
+        AppendUint16(out, static_cast<uint16_t>(entry.name.size()));
+        AppendUint16(out, 0);
+    }
+
+    std::vector<Entry> entries_;
+};
+} // namespace OHOS
+#endif // OHOS_HAP_BUILDER_H
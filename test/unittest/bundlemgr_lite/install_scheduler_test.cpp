@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "install_scheduler.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const uint32_t BUNDLE_NUM = 8;
+const uint32_t TASK_NUM = 400;
+// every this many tasks a batch takes several bundles at once
+const uint32_t BATCH_INTERVAL = 10;
+const uint32_t BATCH_BUNDLE_NUM = 3;
+const uint32_t MAX_TASK_DURATION_US = 200;
+const auto WAIT_TIMEOUT = std::chrono::seconds(30);
+
+std::string GetBundleName(uint32_t index)
+{
+    return "com.example.bundle" + std::to_string(index);
+}
+
+// what the install and uninstall tasks saw while they ran
+struct TaskRecorder {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::map<std::string, uint32_t> runningTasks;
+    // submission order of the tasks of each bundle, and how many of them have started
+    std::map<std::string, std::vector<uint32_t>> submittedTasks;
+    std::map<std::string, uint32_t> startedTaskNum;
+    uint32_t runningTaskNum = 0;
+    uint32_t maxRunningTaskNum = 0;
+    uint32_t finishedTaskNum = 0;
+    uint32_t overlaps = 0;
+    uint32_t reorders = 0;
+
+    bool WaitFinished(uint32_t taskNum)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cond.wait_for(lock, WAIT_TIMEOUT, [this, taskNum] { return finishedTaskNum >= taskNum; });
+    }
+};
+
+struct TestTask {
+    uint32_t id;
+    std::vector<std::string> bundleNames;
+    std::chrono::microseconds duration;
+    TaskRecorder *recorder;
+    // when set the task holds its bundles until the flag is raised
+    bool *isReleased;
+};
+
+void RunTestTask(void *arg)
+{
+    TestTask *task = reinterpret_cast<TestTask *>(arg);
+    TaskRecorder &recorder = *(task->recorder);
+    {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        for (const auto &bundleName : task->bundleNames) {
+            if (recorder.runningTasks[bundleName]++ != 0) {
+                recorder.overlaps++;
+            }
+            uint32_t &startedNum = recorder.startedTaskNum[bundleName];
+            if (recorder.submittedTasks[bundleName][startedNum++] != task->id) {
+                recorder.reorders++;
+            }
+        }
+        recorder.runningTaskNum++;
+        if (recorder.runningTaskNum > recorder.maxRunningTaskNum) {
+            recorder.maxRunningTaskNum = recorder.runningTaskNum;
+        }
+        recorder.cond.notify_all();
+    }
+    if (task->isReleased != nullptr) {
+        std::unique_lock<std::mutex> lock(recorder.mutex);
+        recorder.cond.wait_for(lock, WAIT_TIMEOUT, [task] { return *(task->isReleased); });
+    }
+    std::this_thread::sleep_for(task->duration);
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    for (const auto &bundleName : task->bundleNames) {
+        recorder.runningTasks[bundleName]--;
+    }
+    recorder.runningTaskNum--;
+    recorder.finishedTaskNum++;
+    recorder.cond.notify_all();
+}
+
+void Submit(TestTask &task)
+{
+    {
+        std::lock_guard<std::mutex> lock(task.recorder->mutex);
+        for (const auto &bundleName : task.bundleNames) {
+            task.recorder->submittedTasks[bundleName].emplace_back(task.id);
+        }
+    }
+    InstallScheduler::GetInstance().Submit(task.bundleNames, RunTestTask, &task);
+}
+
+// installs and uninstalls of random bundles and durations, now and then a batch of several bundles
+std::vector<TestTask> CreateMixedTasks(TaskRecorder &recorder)
+{
+    std::vector<TestTask> tasks(TASK_NUM);
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < TASK_NUM; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t bundleIndex = (seed >> 16) % BUNDLE_NUM;
+        tasks[i].id = i;
+        tasks[i].bundleNames.emplace_back(GetBundleName(bundleIndex));
+        if (i % BATCH_INTERVAL == 0) {
+            for (uint32_t j = 1; j < BATCH_BUNDLE_NUM; j++) {
+                tasks[i].bundleNames.emplace_back(GetBundleName((bundleIndex + j) % BUNDLE_NUM));
+            }
+        }
+        tasks[i].duration = std::chrono::microseconds((seed >> 8) % MAX_TASK_DURATION_US);
+        tasks[i].recorder = &recorder;
+        tasks[i].isReleased = nullptr;
+    }
+    return tasks;
+}
+} // namespace
+
+class InstallSchedulerTest : public testing::Test {};
+
+/**
+ * @tc.name: Submit_0100
+ * @tc.desc: under mixed traffic the tasks of one bundle never overlap and start in the order they were submitted
+ * @tc.type: FUNC
+ */
+HWTEST_F(InstallSchedulerTest, Submit_0100, TestSize.Level1)
+{
+    TaskRecorder recorder;
+    std::vector<TestTask> tasks = CreateMixedTasks(recorder);
+    for (auto &task : tasks) {
+        Submit(task);
+    }
+    ASSERT_TRUE(recorder.WaitFinished(TASK_NUM));
+    EXPECT_EQ(recorder.overlaps, 0U);
+    EXPECT_EQ(recorder.reorders, 0U);
+    EXPECT_LE(recorder.maxRunningTaskNum, static_cast<uint32_t>(BUNDLE_INSTALL_THREADS));
+}
+
+/**
+ * @tc.name: Submit_0200
+ * @tc.desc: a task of another bundle runs while the tasks of a busy bundle wait for it
+ * @tc.type: FUNC
+ */
+HWTEST_F(InstallSchedulerTest, Submit_0200, TestSize.Level1)
+{
+    if (BUNDLE_INSTALL_THREADS < 2) {
+        return;
+    }
+    TaskRecorder recorder;
+    bool isReleased = false;
+    TestTask blocking { 0, { GetBundleName(0) }, std::chrono::microseconds(0), &recorder, &isReleased };
+    TestTask waiting { 1, { GetBundleName(0) }, std::chrono::microseconds(0), &recorder, nullptr };
+    TestTask other { 2, { GetBundleName(1) }, std::chrono::microseconds(0), &recorder, nullptr };
+    Submit(blocking);
+    Submit(waiting);
+    Submit(other);
+    {
+        std::unique_lock<std::mutex> lock(recorder.mutex);
+        // only the task of the other bundle can finish while the first one holds its bundle
+        EXPECT_TRUE(recorder.cond.wait_for(lock, WAIT_TIMEOUT, [&recorder] {
+            return recorder.finishedTaskNum >= 1;
+        }));
+        EXPECT_EQ(recorder.startedTaskNum[GetBundleName(0)], 1U);
+        EXPECT_EQ(recorder.startedTaskNum[GetBundleName(1)], 1U);
+        isReleased = true;
+        recorder.cond.notify_all();
+    }
+    ASSERT_TRUE(recorder.WaitFinished(3));
+    EXPECT_EQ(recorder.overlaps, 0U);
+    EXPECT_EQ(recorder.reorders, 0U);
+}
+} // namespace OHOS
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "bundle_info_builder.h"
+#include "convert_utils.h"
+#include "parcel_utils.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const uint32_t BUNDLE_NUM = 3;
+const int32_t MODULE_NUM = 2;
+const int32_t ABILITY_NUM = 4;
+const int32_t CODEC_ROUNDS = 20;
+const uint32_t BENCHMARK_BUNDLE_NUMS[] = { 10, 100 };
+
+void FillFullAbilityInfo(AbilityInfo &abilityInfo, const std::string &bundleName, int32_t index)
+{
+    FillAbilityInfo(abilityInfo, bundleName, GetAbilityName(static_cast<uint32_t>(index), "MainAbility"));
+    abilityInfo.isVisible = (index % 2 == 0);
+    abilityInfo.abilityType = PAGE;
+    abilityInfo.launchMode = SINGLETON;
+    abilityInfo.moduleName = Utils::Strdup("entry");
+    abilityInfo.description = Utils::Strdup("the main ability");
+    abilityInfo.iconPath = Utils::Strdup("/assets/entry/resources/base/media/icon.png");
+    // deviceId stays nullptr, which the parcel must give back as nullptr
+}
+
+void FillModuleInfo(ModuleInfo &moduleInfo, int32_t index)
+{
+    moduleInfo.moduleName = Utils::Strdup(("module" + std::to_string(index)).c_str());
+    moduleInfo.name = Utils::Strdup(".MyApplication");
+    moduleInfo.description = Utils::Strdup("");
+    moduleInfo.moduleType = Utils::Strdup("entry");
+    moduleInfo.isDeliveryInstall = true;
+    moduleInfo.deviceType[0] = Utils::Strdup("liteWearable");
+    moduleInfo.deviceType[1] = Utils::Strdup("smartVision");
+    moduleInfo.metaData[0] = reinterpret_cast<MetaData *>(AdapterMalloc(sizeof(MetaData)));
+    if (moduleInfo.metaData[0] == nullptr) {
+        return;
+    }
+    moduleInfo.metaData[0]->name = Utils::Strdup("key");
+    moduleInfo.metaData[0]->value = Utils::Strdup("value");
+    moduleInfo.metaData[0]->extra = nullptr;
+}
+
+// infos shaped like the ones of an installed hap, with a few modules and abilities each
+BundleInfo *CreateBundleInfos(uint32_t num)
+{
+    BundleInfo *bundleInfos = CreateZeroedArray<BundleInfo>(num);
+    if (bundleInfos == nullptr) {
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        BundleInfo &bundleInfo = bundleInfos[i];
+        std::string bundleName = GetBundleName(i);
+        bundleInfo.isSystemApp = (i % 2 == 0);
+        bundleInfo.isNativeApp = false;
+        bundleInfo.isKeepAlive = (i % 3 == 0);
+        bundleInfo.uid = BASE_UID + static_cast<int32_t>(i);
+        bundleInfo.gid = bundleInfo.uid;
+        bundleInfo.compatibleApi = 6;
+        bundleInfo.targetApi = 7;
+        bundleInfo.versionCode = static_cast<int32_t>(i) + 1;
+        bundleInfo.versionName = Utils::Strdup("1.0.0");
+        bundleInfo.bundleName = Utils::Strdup(bundleName.c_str());
+        bundleInfo.label = Utils::Strdup("label \"with\" \\ escapes");
+        bundleInfo.bigIconPath = Utils::Strdup("/storage/app/run/icon.png");
+        bundleInfo.codePath = Utils::Strdup(("/storage/app/run/" + bundleName).c_str());
+        bundleInfo.dataPath = Utils::Strdup(("/storage/app/data/" + bundleName).c_str());
+        bundleInfo.vendor = nullptr;
+        bundleInfo.appId = Utils::Strdup((bundleName + "_BLdl/uQEgsbpW0uWBE40iMaRUT0BzCvh7ZZA3FHBYo=").c_str());
+        bundleInfo.moduleInfos = CreateZeroedArray<ModuleInfo>(MODULE_NUM);
+        if (bundleInfo.moduleInfos != nullptr) {
+            bundleInfo.numOfModule = MODULE_NUM;
+            for (int32_t j = 0; j < MODULE_NUM; j++) {
+                FillModuleInfo(bundleInfo.moduleInfos[j], j);
+            }
+        }
+        bundleInfo.abilityInfos = CreateZeroedArray<AbilityInfo>(ABILITY_NUM);
+        if (bundleInfo.abilityInfos != nullptr) {
+            bundleInfo.numOfAbility = ABILITY_NUM;
+            for (int32_t j = 0; j < ABILITY_NUM; j++) {
+                FillFullAbilityInfo(bundleInfo.abilityInfos[j], bundleName, j);
+            }
+        }
+    }
+    return bundleInfos;
+}
+
+void ExpectStringEq(const char *expected, const char *actual)
+{
+    if (expected == nullptr) {
+        EXPECT_EQ(actual, nullptr);
+        return;
+    }
+    ASSERT_NE(actual, nullptr);
+    EXPECT_STREQ(expected, actual);
+}
+
+void ExpectAbilityInfoEq(const AbilityInfo &expected, const AbilityInfo &actual)
+{
+    EXPECT_EQ(expected.isVisible, actual.isVisible);
+    EXPECT_EQ(expected.abilityType, actual.abilityType);
+    EXPECT_EQ(expected.launchMode, actual.launchMode);
+    ExpectStringEq(expected.bundleName, actual.bundleName);
+    ExpectStringEq(expected.moduleName, actual.moduleName);
+    ExpectStringEq(expected.name, actual.name);
+    ExpectStringEq(expected.description, actual.description);
+    ExpectStringEq(expected.iconPath, actual.iconPath);
+    ExpectStringEq(expected.label, actual.label);
+    ExpectStringEq(expected.deviceId, actual.deviceId);
+}
+
+void ExpectModuleInfoEq(const ModuleInfo &expected, const ModuleInfo &actual)
+{
+    ExpectStringEq(expected.moduleName, actual.moduleName);
+    ExpectStringEq(expected.name, actual.name);
+    ExpectStringEq(expected.description, actual.description);
+    ExpectStringEq(expected.moduleType, actual.moduleType);
+    EXPECT_EQ(expected.isDeliveryInstall, actual.isDeliveryInstall);
+    for (int32_t i = 0; i < DEVICE_TYPE_SIZE; i++) {
+        ExpectStringEq(expected.deviceType[i], actual.deviceType[i]);
+    }
+    for (int32_t i = 0; i < METADATA_SIZE; i++) {
+        if (expected.metaData[i] == nullptr) {
+            EXPECT_EQ(actual.metaData[i], nullptr);
+            continue;
+        }
+        ASSERT_NE(actual.metaData[i], nullptr);
+        ExpectStringEq(expected.metaData[i]->name, actual.metaData[i]->name);
+        ExpectStringEq(expected.metaData[i]->value, actual.metaData[i]->value);
+        ExpectStringEq(expected.metaData[i]->extra, actual.metaData[i]->extra);
+    }
+}
+
+void ExpectBundleInfoEq(const BundleInfo &expected, const BundleInfo &actual)
+{
+    EXPECT_EQ(expected.isSystemApp, actual.isSystemApp);
+    EXPECT_EQ(expected.isNativeApp, actual.isNativeApp);
+    EXPECT_EQ(expected.isKeepAlive, actual.isKeepAlive);
+    EXPECT_EQ(expected.uid, actual.uid);
+    EXPECT_EQ(expected.gid, actual.gid);
+    EXPECT_EQ(expected.compatibleApi, actual.compatibleApi);
+    EXPECT_EQ(expected.targetApi, actual.targetApi);
+    EXPECT_EQ(expected.versionCode, actual.versionCode);
+    ExpectStringEq(expected.versionName, actual.versionName);
+    ExpectStringEq(expected.bundleName, actual.bundleName);
+    ExpectStringEq(expected.label, actual.label);
+    ExpectStringEq(expected.bigIconPath, actual.bigIconPath);
+    ExpectStringEq(expected.codePath, actual.codePath);
+    ExpectStringEq(expected.dataPath, actual.dataPath);
+    ExpectStringEq(expected.vendor, actual.vendor);
+    ExpectStringEq(expected.appId, actual.appId);
+    ASSERT_EQ(expected.numOfModule, actual.numOfModule);
+    for (int32_t i = 0; i < expected.numOfModule; i++) {
+        ExpectModuleInfoEq(expected.moduleInfos[i], actual.moduleInfos[i]);
+    }
+    ASSERT_EQ(expected.numOfAbility, actual.numOfAbility);
+    for (int32_t i = 0; i < expected.numOfAbility; i++) {
+        ExpectAbilityInfoEq(expected.abilityInfos[i], actual.abilityInfos[i]);
+    }
+}
+
+int64_t GetElapsedMicroseconds(std::chrono::steady_clock::time_point begin)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+}
+} // namespace
+
+class ParcelUtilsTest : public testing::Test {};
+
+/**
+ * @tc.name: RoundTrip_0100
+ * @tc.desc: bundle infos with modules, abilities and nullptr strings come back from the parcel unchanged
+ * @tc.type: FUNC
+ */
+HWTEST_F(ParcelUtilsTest, RoundTrip_0100, TestSize.Level1)
+{
+    BundleInfo *bundleInfos = CreateBundleInfos(BUNDLE_NUM);
+    ASSERT_NE(bundleInfos, nullptr);
+    uint32_t size = 0;
+    uint8_t *buff = ParcelUtils::MarshallingBundleInfos(bundleInfos, BUNDLE_NUM, &size);
+    ASSERT_NE(buff, nullptr);
+    EXPECT_EQ(size, ParcelUtils::GetBundleInfosSize(bundleInfos, BUNDLE_NUM));
+
+    BundleInfo *result = nullptr;
+    ASSERT_TRUE(ParcelUtils::UnmarshallingBundleInfos(buff, size, &result, BUNDLE_NUM));
+    ASSERT_NE(result, nullptr);
+    for (uint32_t i = 0; i < BUNDLE_NUM; i++) {
+        ExpectBundleInfoEq(bundleInfos[i], result[i]);
+    }
+    BundleInfoUtils::FreeBundleInfos(result, BUNDLE_NUM);
+
+    // a count other than the one written is refused
+    result = nullptr;
+    EXPECT_FALSE(ParcelUtils::UnmarshallingBundleInfos(buff, size, &result, BUNDLE_NUM + 1));
+    EXPECT_EQ(result, nullptr);
+    AdapterFree(buff);
+    BundleInfoUtils::FreeBundleInfos(bundleInfos, BUNDLE_NUM);
+}
+
+/**
+ * @tc.name: RoundTrip_0200
+ * @tc.desc: an ability info comes back from the parcel unchanged
+ * @tc.type: FUNC
+ */
+HWTEST_F(ParcelUtilsTest, RoundTrip_0200, TestSize.Level1)
+{
+    AbilityInfo abilityInfo;
+    ASSERT_EQ(memset_s(&abilityInfo, sizeof(AbilityInfo), 0, sizeof(AbilityInfo)), EOK);
+    FillFullAbilityInfo(abilityInfo, GetBundleName(0), 0);
+    uint32_t size = 0;
+    uint8_t *buff = ParcelUtils::MarshallingAbilityInfo(&abilityInfo, &size);
+    ASSERT_NE(buff, nullptr);
+    AbilityInfo *result = ParcelUtils::UnmarshallingAbilityInfo(buff, size);
+    ASSERT_NE(result, nullptr);
+    ExpectAbilityInfoEq(abilityInfo, *result);
+    ClearAbilityInfo(result);
+    AdapterFree(result);
+    AdapterFree(buff);
+    ClearAbilityInfo(&abilityInfo);
+}
+
+/**
+ * @tc.name: Truncated_0100
+ * @tc.desc: a parcel cut short at any length, or with trailing bytes, is refused without leaking
+ * @tc.type: FUNC
+ */
+HWTEST_F(ParcelUtilsTest, Truncated_0100, TestSize.Level1)
+{
+    BundleInfo *bundleInfos = CreateBundleInfos(1);
+    ASSERT_NE(bundleInfos, nullptr);
+    uint32_t size = ParcelUtils::GetBundleInfosSize(bundleInfos, 1);
+    ASSERT_NE(size, 0U);
+    // one spare byte to check that trailing data is refused as well
+    uint8_t *buff = reinterpret_cast<uint8_t *>(AdapterMalloc(size + 1));
+    ASSERT_NE(buff, nullptr);
+    ASSERT_TRUE(ParcelUtils::MarshallingBundleInfos(bundleInfos, 1, buff, size));
+    EXPECT_FALSE(ParcelUtils::MarshallingBundleInfos(bundleInfos, 1, buff, size - 1));
+    ASSERT_TRUE(ParcelUtils::MarshallingBundleInfos(bundleInfos, 1, buff, size));
+    for (uint32_t len = 0; len < size; len++) {
+        EXPECT_EQ(ParcelUtils::UnmarshallingBundleInfo(buff, len), nullptr);
+    }
+    buff[size] = 0;
+    EXPECT_EQ(ParcelUtils::UnmarshallingBundleInfo(buff, size + 1), nullptr);
+    BundleInfo *result = ParcelUtils::UnmarshallingBundleInfo(buff, size);
+    ASSERT_NE(result, nullptr);
+    BundleInfoUtils::FreeBundleInfo(result);
+    AdapterFree(buff);
+    BundleInfoUtils::FreeBundleInfos(bundleInfos, 1);
+}
+
+/**
+ * @tc.name: Benchmark_0100
+ * @tc.desc: size and encode plus decode time of the bundle info list in the parcel and in json
+ * @tc.type: PERF
+ */
+HWTEST_F(ParcelUtilsTest, Benchmark_0100, TestSize.Level3)
+{
+    for (uint32_t bundleNum : BENCHMARK_BUNDLE_NUMS) {
+        BundleInfo *bundleInfos = CreateBundleInfos(bundleNum);
+        ASSERT_NE(bundleInfos, nullptr);
+
+        uint32_t parcelSize = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < CODEC_ROUNDS; i++) {
+            uint8_t *buff = ParcelUtils::MarshallingBundleInfos(bundleInfos, bundleNum, &parcelSize);
+            ASSERT_NE(buff, nullptr);
+            BundleInfo *result = nullptr;
+            ASSERT_TRUE(ParcelUtils::UnmarshallingBundleInfos(buff, parcelSize, &result, bundleNum));
+            BundleInfoUtils::FreeBundleInfos(result, bundleNum);
+            AdapterFree(buff);
+        }
+        int64_t parcelTime = GetElapsedMicroseconds(begin) / CODEC_ROUNDS;
+
+        size_t jsonSize = 0;
+        begin = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < CODEC_ROUNDS; i++) {
+            char *strs = ConvertUtils::ConvertBundleInfosToString(&bundleInfos, bundleNum);
+            ASSERT_NE(strs, nullptr);
+            jsonSize = strlen(strs) + 1;
+            BundleInfo *result = nullptr;
+            ASSERT_TRUE(ConvertUtils::ConvertStringToBundleInfos(strs, &result, bundleNum, jsonSize));
+            BundleInfoUtils::FreeBundleInfos(result, bundleNum);
+            cJSON_free(strs);
+        }
+        int64_t jsonTime = GetElapsedMicroseconds(begin) / CODEC_ROUNDS;
+
+        GTEST_LOG_(INFO) << bundleNum << " bundles: parcel " << parcelSize << " bytes in " << parcelTime <<
+            " us, json " << jsonSize << " bytes in " << jsonTime << " us";
+        BundleInfoUtils::FreeBundleInfos(bundleInfos, bundleNum);
+    }
+}
+} // namespace OHOS
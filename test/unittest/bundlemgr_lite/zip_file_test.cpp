@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "hap_builder.h"
+#include "zip_file.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace {
+const std::string HAP_PATH = "/data/zip_file_test.hap";
+const std::string SHARED_HAP_PATH = "/data/zip_file_test_shared.hap";
+const std::string BROKEN_ENTRY_NAME = "assets/js/default/broken.bin";
+const uint32_t ENTRY_NUM = 5000;
+// the first entries span the sizes around the 4 KB out buffer of the inflate stream
+const uint32_t EDGE_ENTRY_NUM = 64;
+const uint32_t OUT_BUFFER_SIZE = 4096;
+const uint32_t SMALL_ENTRY_SIZE = 512;
+const int32_t INFLATE_ROUNDS = 5;
+
+std::string GetEntryName(uint32_t index)
+{
+    return HapBuilder::GetEntryName(index, 1);
+}
+
+std::string GetEntryContent(uint32_t index)
+{
+    uint32_t size = SMALL_ENTRY_SIZE + index % SMALL_ENTRY_SIZE;
+    if (index < EDGE_ENTRY_NUM) {
+        // one buffer and two buffers, give or take a few bytes
+        size = (index % 2 + 1) * OUT_BUFFER_SIZE + index / 2 - EDGE_ENTRY_NUM / 4;
+    }
+    return HapBuilder::GetEntryContent(GetEntryName(index), size);
+}
+
+bool ExtractToString(const ZipFile &zipFile, const std::string &name, std::string &content)
+{
+    std::ostringstream dest;
+    if (!zipFile.ExtractFile(name, dest)) {
+        return false;
+    }
+    content = dest.str();
+    return true;
+}
+
+// a fresh stream and buffers for every entry, what inflating an entry cost on top before ZipFile kept its stream;
+// a one byte entry is inflated so that zlib allocates its window as well
+int64_t MeasureStreamSetup()
+{
+    std::string data;
+    if (!HapBuilder::Deflate("x", data)) {
+        return -1;
+    }
+    Byte out = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ENTRY_NUM; i++) {
+        z_stream zstream = {};
+        if (inflateInit2(&zstream, -MAX_WBITS) != Z_OK) {
+            return -1;
+        }
+        Byte *bufOut = new (std::nothrow) Byte[OUT_BUFFER_SIZE];
+        Byte *bufIn = new (std::nothrow) Byte[OUT_BUFFER_SIZE / 2];
+        zstream.next_in = reinterpret_cast<Bytef *>(&data[0]);
+        zstream.avail_in = data.size();
+        zstream.next_out = &out;
+        zstream.avail_out = sizeof(out);
+        int ret = inflate(&zstream, Z_SYNC_FLUSH);
+        delete[] bufIn;
+        delete[] bufOut;
+        inflateEnd(&zstream);
+        if (ret != Z_STREAM_END) {
+            return -1;
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count() /
+        ENTRY_NUM;
+}
+} // namespace
+
+class ZipFileTest : public testing::Test {
+public:
+    static void SetUpTestCase()
+    {
+        HapBuilder builder;
+        for (uint32_t i = 0; i < ENTRY_NUM; i++) {
+            ASSERT_TRUE(builder.AddEntry(GetEntryName(i), GetEntryContent(i), true));
+        }
+        builder.AddBrokenEntry(BROKEN_ENTRY_NAME);
+        ASSERT_TRUE(builder.Write(HAP_PATH));
+    }
+
+    static void TearDownTestCase()
+    {
+        remove(HAP_PATH.c_str());
+        remove(SHARED_HAP_PATH.c_str());
+    }
+};
+
+/**
+ * @tc.name: ExtractFile_0100
+ * @tc.desc: deflated entries of every size come out whole through the one inflate stream of the zip file
+ * @tc.type: FUNC
+ */
+HWTEST_F(ZipFileTest, ExtractFile_0100, TestSize.Level1)
+{
+    ZipFile zipFile(HAP_PATH);
+    ASSERT_TRUE(zipFile.Open());
+    EXPECT_EQ(zipFile.GetAllEntries().size(), ENTRY_NUM + 1);
+    for (uint32_t i = 0; i < ENTRY_NUM; i++) {
+        std::string content;
+        ASSERT_TRUE(ExtractToString(zipFile, GetEntryName(i), content)) << GetEntryName(i);
+        EXPECT_EQ(content, GetEntryContent(i)) << GetEntryName(i);
+    }
+    zipFile.Close();
+}
+
+/**
+ * @tc.name: ExtractFile_0200
+ * @tc.desc: an entry that fails to inflate leaves the stream usable for the next entries, also after reopening
+ * @tc.type: FUNC
+ */
+HWTEST_F(ZipFileTest, ExtractFile_0200, TestSize.Level1)
+{
+    ZipFile zipFile(HAP_PATH);
+    ASSERT_TRUE(zipFile.Open());
+    std::string content;
+    ASSERT_TRUE(ExtractToString(zipFile, GetEntryName(0), content));
+    EXPECT_FALSE(ExtractToString(zipFile, BROKEN_ENTRY_NAME, content));
+    ASSERT_TRUE(ExtractToString(zipFile, GetEntryName(1), content));
+    EXPECT_EQ(content, GetEntryContent(1));
+    EXPECT_FALSE(ExtractToString(zipFile, "assets/js/default/nonexistent.bin", content));
+    zipFile.Close();
+
+    ZipFile reopened(HAP_PATH);
+    ASSERT_TRUE(reopened.Open());
+    ASSERT_TRUE(ExtractToString(reopened, GetEntryName(ENTRY_NUM - 1), content));
+    EXPECT_EQ(content, GetEntryContent(ENTRY_NUM - 1));
+}
+
+/**
+ * @tc.name: ExtractFile_0300
+ * @tc.desc: a hap other users can write is not mapped, so cutting it short while it is open fails the extraction
+ *           instead of raising SIGBUS
+ * @tc.type: FUNC
+ */
+HWTEST_F(ZipFileTest, ExtractFile_0300, TestSize.Level1)
+{
+    HapBuilder builder;
+    for (uint32_t i = 0; i < EDGE_ENTRY_NUM; i++) {
+        ASSERT_TRUE(builder.AddEntry(GetEntryName(i), GetEntryContent(i), i % 2 == 0));
+    }
+    ASSERT_TRUE(builder.Write(SHARED_HAP_PATH));
+    ASSERT_EQ(chmod(SHARED_HAP_PATH.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH), 0);
+    ZipFile zipFile(SHARED_HAP_PATH);
+    ASSERT_TRUE(zipFile.Open());
+    ASSERT_EQ(truncate(SHARED_HAP_PATH.c_str(), 0), 0);
+    std::string content;
+    for (uint32_t i = 0; i < EDGE_ENTRY_NUM; i++) {
+        EXPECT_FALSE(ExtractToString(zipFile, GetEntryName(i), content)) << GetEntryName(i);
+    }
+    zipFile.Close();
+}
+
+/**
+ * @tc.name: Benchmark_0100
+ * @tc.desc: time to inflate one small entry, next to what setting up a fresh stream for it would add
+ * @tc.type: PERF
+ */
+HWTEST_F(ZipFileTest, Benchmark_0100, TestSize.Level3)
+{
+    ZipFile zipFile(HAP_PATH);
+    ASSERT_TRUE(zipFile.Open());
+    std::ostringstream dest;
+    auto begin = std::chrono::steady_clock::now();
+    for (int32_t round = 0; round < INFLATE_ROUNDS; round++) {
+        for (uint32_t i = EDGE_ENTRY_NUM; i < ENTRY_NUM; i++) {
+            dest.str("");
+            ASSERT_TRUE(zipFile.ExtractFile(GetEntryName(i), dest));
+        }
+    }
+    int64_t entryTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count() / (INFLATE_ROUNDS * (ENTRY_NUM - EDGE_ENTRY_NUM));
+    int64_t setupTime = MeasureStreamSetup();
+    ASSERT_GE(setupTime, 0);
+    GTEST_LOG_(INFO) << "inflating an entry of " << SMALL_ENTRY_SIZE << " to " << 2 * SMALL_ENTRY_SIZE <<
+        " bytes: " << entryTime << " ns, a fresh stream per entry would add " << setupTime << " ns";
+}
+} // namespace OHOS
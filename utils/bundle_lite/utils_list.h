@@ -142,6 +142,9 @@ public:
             node = node->next_;
             delete temp;
         }
+        head_->next_ = head_;
+        head_->prev_ = head_;
+        count_ = 0;
     }
 
     Node<T> *Begin() const